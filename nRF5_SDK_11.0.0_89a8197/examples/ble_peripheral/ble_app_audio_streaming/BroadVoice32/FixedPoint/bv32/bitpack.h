@@ -28,7 +28,9 @@
 #ifndef BITPACK_H
 #define BITPACK_H
 
-void BV32_BitPack(UWord8 * PackedStream, struct BV32_Bit_Stream * BitStruct);
-void BV32_BitUnPack(UWord8 * PackedStream, struct BV32_Bit_Stream * BitStruct);
+#define BV32_PACKED_BYTES  20   /* packed frame size, 160 bits */
+
+void bv32fx_BitPack(UWord8 * PackedStream, struct BV32_Bit_Stream * BitStruct);
+void bv32fx_BitUnPack(UWord8 * PackedStream, struct BV32_Bit_Stream * BitStruct);
 
 #endif
@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "typedef.h"
 #include "bvcommon.h"
 #include "bv32cnst.h"
@@ -36,17 +37,26 @@
 #include "utility.h"
 #if G192BITSTREAM
 #include "g192.h"
-#else
-#include "bitpack.h"
 #endif
+#include "bitpack.h"
 #include "memutil.h" 
+#include "dspop.h"
+#include "simdop.h"
+#include "wmops.h"
+
+#define NBATCH 32    /* frames decoded per BV32_DecodeFrames() call */
 
-int      frame;
-Word16   bfi=0;
+/* time-stamp counter, for the cycles spent in the codec calls */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TSC() __builtin_ia32_rdtsc()
+#else
+#define TSC() 0ULL
+#endif
 
 void  usage(char *name)
 {
-   fprintf(stderr,"usage: %s enc|dec input output\n", name);
+   fprintf(stderr,"usage: %s [-m full|balanced|fast] enc|dec input output\n", name);
+   fprintf(stderr,"\n-m: encoder complexity mode (default full)\n");
    fprintf(stderr,"\nFormat for speech_file:\n    Binary file of 16 kHz sampled 16-bit PCM data.\n");
 #if G192BITSTREAM
    fprintf(stderr,"\nFormat for bitstream_file per frame: ITU-T G.192 format\n\
@@ -63,14 +73,19 @@ int   main(int argc, char **argv)
 {
    FILE     *fi, *fo, *fbdi=NULL;
    int      enc=1, sizebitstream, sizestate;
-   int      nread, frsz, i;
+   int      nread, frsz, i, frame;
+   Word16   bfi=0;
    Word16   *x;
    void     *state, *bs;
-#if !G192BITSTREAM
-   UWord8 PackedStream[20];
-#endif
+   UWord8   PackedStream[NBATCH*BV32_PACKED_BYTES];
+   UWord8   bfis[NBATCH];
+   int      nb=0;
    
    int next_bad_frame=-1;
+   Word16  mode=BV32_MODE_FULL;
+   clock_t t0;
+   double  cpu;
+   unsigned long long tsc, cycles=0;
    
    fprintf(stderr,"/***************************************************************************/\n");
    fprintf(stderr,"/* BroadVoice(R)32, Copyright (c) 2000-12, Broadcom Corporation.           */\n");
@@ -87,6 +102,15 @@ int   main(int argc, char **argv)
    fprintf(stderr,"/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               */\n");
    fprintf(stderr,"/***************************************************************************/\n");
    
+   if ((argc>2)&&!strcmp(argv[1],"-m")) 
+   {
+      if (!strcmp(argv[2],"full")) mode=BV32_MODE_FULL;
+      else if (!strcmp(argv[2],"balanced")) mode=BV32_MODE_BALANCED;
+      else if (!strcmp(argv[2],"fast")) mode=BV32_MODE_FAST;
+      else usage(argv[0]);
+      argv += 2;
+      argc -= 2;
+   }
    if ((argc!=4)&&(argc!=5)) usage(argv[0]);
    if (!strcmp(argv[1],"enc")) enc=1;
    else if (!strcmp(argv[1],"dec")) enc=0;
@@ -118,6 +142,7 @@ int   main(int argc, char **argv)
       sizestate = sizeof(struct BV32_Encoder_State);
       state = allocWord16(0,sizeof(struct BV32_Encoder_State)/2-1);
       Reset_BV32_Encoder((struct BV32_Encoder_State*)state);
+      BV32_SetEncoderMode((struct BV32_Encoder_State*)state, mode);
    } 
    else 
    {
@@ -127,7 +152,7 @@ int   main(int argc, char **argv)
    }
    
    bs = allocWord16(0,sizebitstream/2-1);
-   x = allocWord16(0, frsz-1);
+   x = allocWord16(0, NBATCH*frsz-1);
    
    if (enc){
 #if G192BITSTREAM
@@ -150,6 +175,7 @@ int   main(int argc, char **argv)
    
    /* START THE MAIN FRAME LOOP */
    frame=0; 
+   t0 = clock();
    /* read for the 1st bad frame */
    if (fbdi!=NULL)
       fscanf(fbdi,"%d", &next_bad_frame);
@@ -170,10 +196,11 @@ int   main(int argc, char **argv)
       else 
       {
 #if G192BITSTREAM
-         nread = bv32_fread_g192bitstrm((struct BV32_Bit_Stream*)bs, fi);
+         nread = bv32_fread_g192bitstrm((struct BV32_Bit_Stream*)bs, fi, &bfi);
+         bv32fx_BitPack ( PackedStream+nb*BV32_PACKED_BYTES, (struct BV32_Bit_Stream*)bs );
 #else
-         nread = fread(PackedStream, sizeof(UWord8), 20, fi);
-         BV32_BitUnPack ( PackedStream, (struct BV32_Bit_Stream*)bs ); 
+         nread = fread(PackedStream+nb*BV32_PACKED_BYTES, sizeof(UWord8), BV32_PACKED_BYTES, fi);
+         bfi = 0;
 #endif
          if (nread<=0) goto End;
          if (frame==next_bad_frame) 
@@ -187,24 +214,28 @@ int   main(int argc, char **argv)
       
       if (enc==1) 
       {
+         tsc = TSC();
          BV32_Encode((struct BV32_Bit_Stream*)bs,(struct BV32_Encoder_State*) state, x);
+         cycles += TSC()-tsc;
 #if G192BITSTREAM
          bv32_fwrite_g192bitstrm((struct BV32_Bit_Stream*)bs,fo);
 #else
-         BV32_BitPack( PackedStream, (struct BV32_Bit_Stream*)bs );
-         fwrite(PackedStream, sizeof(UWord8), 20, fo);         
+         bv32fx_BitPack( PackedStream, (struct BV32_Bit_Stream*)bs );
+         fwrite(PackedStream, sizeof(UWord8), BV32_PACKED_BYTES, fo);         
 #endif
       } 
       else 
       {
-         if (!bfi) 
-            BV32_Decode((struct BV32_Bit_Stream*)bs,(struct BV32_Decoder_State*)state, x);   
-         else 
+         /* decode a batch of frames at a time, erased ones are concealed */
+         bfis[nb++] = (UWord8)bfi;
+         if (nb == NBATCH) 
          {
-            BV32_PLC((struct BV32_Decoder_State*)state,x); 
+            tsc = TSC();
+            BV32_DecodeFrames(PackedStream, bfis, nb, (struct BV32_Decoder_State*)state, x);
+            cycles += TSC()-tsc;
+            fwrite(x, sizeof(short), nb*frsz, fo);
+            nb = 0;
          }
-         
-         fwrite(x, sizeof(short), frsz, fo);
       }
       
       if (((frame/100)*100)==frame) fprintf(stderr, "\r %d %d-sample frames processed.", frame, frsz);
@@ -212,16 +243,44 @@ int   main(int argc, char **argv)
    
 End: ;
      
+     if (nb > 0)
+     {
+        tsc = TSC();
+        BV32_DecodeFrames(PackedStream, bfis, nb, (struct BV32_Decoder_State*)state, x);
+        cycles += TSC()-tsc;
+        fwrite(x, sizeof(short), nb*frsz, fo);
+     }
+     
      frame--;
+     cpu = (double)(clock()-t0)/CLOCKS_PER_SEC;
      fprintf(stderr, "\r %d 40-sample frames processed.\n", frame);
      
+     /* real-time factor of one core: seconds of speech per CPU second */
+     if (cpu > 0.)
+        fprintf(stderr, " %.3f s CPU, %.0fx real time on one core\n", cpu, frame*FRSZ/(SF*1000.)/cpu);
+     if ((cycles > 0) && (frame > 0))
+        fprintf(stderr, " %.0f cycles per frame (time-stamp counter)\n", (double)cycles/frame);
+#if SIMDOP
+     fprintf(stderr, " SIMD kernels: %s\n", (simd_isa()==2) ? "AVX2" : (simd_isa()==1) ? "SSE4.1" : "none");
+#endif
+#if WMOPS
+     wmops_report(stderr, SF*1000./FRSZ);
+#endif
+     
+#if DSPOP_COUNT
+     fprintf(stderr, " DSP primitives: %ld SMLAD, %ld SMLALD, %ld SMLAWB, %ld QADD/QSUB, %ld SSAT\n",
+        dspop_count.smlad, dspop_count.smlald, dspop_count.smlawb, dspop_count.qadd, dspop_count.ssat);
+     fprintf(stderr, " Packed kernel calls: %ld, basic-operator fallbacks: %ld\n",
+        dspop_count.guard, dspop_count.fallback);
+#endif
+     
      fclose(fi);
      fclose(fo);
      
      if (fbdi!=NULL)
         fclose(fbdi);
      
-     deallocWord16(x, 0, frsz-1);
+     deallocWord16(x, 0, NBATCH*frsz-1);
      deallocWord16(state, 0, sizestate/2-1);
      deallocWord16(bs, 0, sizebitstream/2-1);
      
@@ -28,6 +28,11 @@
 extern void Reset_BV32_Encoder(
 struct BV32_Encoder_State *cs);
 
+/* BV32_MODE_FULL (set by Reset_BV32_Encoder), _BALANCED or _FAST */
+extern void BV32_SetEncoderMode(
+struct BV32_Encoder_State *cs,
+Word16 mode);
+
 extern void BV32_Encode(
 struct BV32_Bit_Stream *bs,
 struct BV32_Encoder_State *cs,
@@ -41,7 +46,28 @@ struct BV32_Bit_Stream     *bs,
 struct BV32_Decoder_State  *ds,
 Word16 *out);
 
+/* BV32_Decode in two stages: the parameters of a frame can be decoded */
+/* while the frame before it is synthesized, but not across BV32_PLC    */
+extern void BV32_DecodeParams(
+struct BV32_Bit_Stream     *bs,
+struct BV32_Decoder_State  *ds,
+struct BV32_Frame_Params   *fp);
+
+extern void BV32_Synthesize(
+struct BV32_Frame_Params   *fp,
+struct BV32_Decoder_State  *ds,
+Word16 *out);
+
 extern void BV32_PLC(
 struct BV32_Decoder_State   *ds,
 Word16 *out);
 
+/* nframes packed frames in, nframes*FRSZ samples out; bfi (or NULL) */
+/* marks the erased frames, which are concealed with BV32_PLC        */
+extern void BV32_DecodeFrames(
+UWord8 *PackedStream,
+UWord8 *bfi,
+int    nframes,
+struct BV32_Decoder_State  *ds,
+Word16 *out);
+
@@ -52,6 +52,13 @@
 #define  SVD2           5              /* split VQ dimension 2 */
 #define  LSPECBSZ22     32             /* codebook size of 2nd stage LSP split VQ */
 
+/* Encoder complexity modes: FULL is the reference encoder; BALANCED and */
+/* FAST narrow the pitch refinement, the first-stage LSP VQ search and   */
+/* the excitation VQ search. The bit-stream is the same in all of them   */
+#define  BV32_MODE_FULL       0
+#define  BV32_MODE_BALANCED   1
+#define  BV32_MODE_FAST       2
+
 #define  NVPSF          (FRSZ/VDIM)
 #define  NVPSSF         (SFSZ/VDIM)
 
@@ -25,45 +25,53 @@
   $Log$
 ******************************************************************************/
 
+struct BV32_Encoder_State;
+
 /* POINTERS */
-extern Word16 winl[];
+extern Word16 bv32fx_winl[];
 extern Word16 sstwinl_h[];
 extern Word16 sstwinl_l[];
-extern Word16 idxord[];
-extern Word16 hpfa[];
-extern Word16 hpfb[];
+extern Word16 bv32fx_idxord[];
+extern Word16 bv32fx_hpfa[];
+extern Word16 bv32fx_hpfb[];
 extern Word16 adf_h[];
 extern Word16 adf_l[];
-extern Word16 bdf[];
-extern Word16 x[];
-extern Word16 x2[];
-extern Word16 MPTH[];
+extern Word16 bv32fx_bdf[];
+extern Word16 bv32fx_x[];
+extern Word16 bv32fx_x2[];
+extern Word16 bv32fx_MPTH[];
 
 /* LSP Quantization */
-extern Word16 lspecb1[];
-extern Word16 lspecb21[];
-extern Word16 lspecb22[];
-extern Word16 lspmean[];
-extern Word16 lspp[];
+extern Word16 bv32fx_lspecb1[];
+extern Word16 lspecb1_ord[];
+extern Word16 lspecb1_dim[];
+extern Word16 lspncb1[];
+extern Word16 bv32fx_lspecb21[];
+extern Word16 bv32fx_lspecb22[];
+extern Word16 bv32fx_lspmean[];
+extern Word16 bv32fx_lspp[];
 
 /* Log-Gain Quantization */
-extern Word16 lgpecb[];
-extern Word16 lgp[];
-extern Word16 lgmean;
+extern Word16 bv32fx_lgpecb[];
+extern Word16 bv32fx_lgp[];
+extern Word16 bv32fx_lgmean;
 
 /* Log-Gain Limitation */
-extern Word16 lgclimit[];
+extern Word16 bv32fx_lgclimit[];
 
 /* Excitation Codebook */
-extern Word16 cccb[];
+extern Word16 bv32fx_cccb[];
+
+/* Pitch Refinement */
+extern Word16 ptdev[];
 
-extern Word16 lgpecb_nh[];
-extern Word16 a_pre[];
-extern Word16 b_pre[];
+extern Word16 bv32fx_lgpecb_nh[];
+extern Word16 bv32fx_a_pre[];
+extern Word16 bv32fx_b_pre[];
 
 /* Function Prototypes */
 
-extern Word32 estlevel(
+extern Word32 bv32fx_estlevel(
 Word32  lg,
 Word32  *level,
 Word32  *lmax,
@@ -76,7 +84,7 @@ extern void excdec_w_LT_synth(
 		       Word16 	*ltsym, /* (i/o) Q1 long-term synthesis filter memory */
 		       Word16  *idx,   /* quantizer codebook index for uq[] vector */
 		       Word16	*b,     /* (i) Q15 coefficient of 3-tap pitch predictor */
-		       Word16 	*cb,    /* (i) Q1 scalar quantizer codebook */
+		       Word16 	gainq,  /* (i) Q2 gain w.r.t. exp */
 		       Word16 	pp,     /* pitch period (# of 8 kHz samples) */
 		       Word16	exp,
              Word32  *EE);	/* gain_exp of current frame */
@@ -109,6 +117,7 @@ struct BV32_Encoder_State *c); /* (i/o) coder state */
 extern Word16 refinepitch(
 Word16 	*x,
 Word16  cpp,
+Word16  dev,
 Word16	*ppt);
 
 extern Word16 pitchtapquan(
@@ -127,7 +136,8 @@ extern void excquan(
     Word16  *stnfm, /* filter memory before filtering of current vector */
     Word16  *cbs,   /* (i) Q1 scalar quantizer codebook */
     Word16  pp,     /* pitch period (# of 8 kHz samples) */
-	Word16	gexp);	/* gain_exp */
+	Word16	gexp,	/* gain_exp */
+    Word16  mode);  /* complexity mode, BV32_MODE_* */
 
 extern Word16 gainquan(
 Word32  *gainq,      /* Q18 */	
@@ -140,7 +150,8 @@ extern void lspquan(
 Word16  *lspq,  
 Word16  *lspidx,  
 Word16  *lsp,     
-Word16  *lsppm);
+Word16  *lsppm,
+Word16  ncb1);
 
 extern Word32 residual_energy(
 Word16  *x,
@@ -33,7 +33,7 @@
 
 /***************************************************************************/
 /**
-*  BV32_BitPack - BroadVoice32 Encoded Bit Pack Function
+*  bv32fx_BitPack - BroadVoice32 Encoded Bit Pack Function
 *
 *  This function take the encoded bit structure (27 words) and packed it 
 *  into a bit stream (10 words) for sending it across the network.
@@ -62,7 +62,7 @@
 
 /***************************************************************************/
 /**
-*  BV32_BitPack - BroadVoice32 Encoded Bit Pack Function
+*  bv32fx_BitPack - BroadVoice32 Encoded Bit Pack Function
 *
 *  This function take the encoded bit structure (27 words) and packed it 
 *  into a bit stream (10 words) for sending it across the network.
@@ -89,7 +89,7 @@
 *  
 */
 
-void BV32_BitPack(UWord8 *PackedStream, struct BV32_Bit_Stream *BitStruct)
+void bv32fx_BitPack(UWord8 *PackedStream, struct BV32_Bit_Stream *BitStruct)
 {
    UWord32 temppack;
    int i;
@@ -182,7 +182,7 @@ void BV32_BitPack(UWord8 *PackedStream, struct BV32_Bit_Stream *BitStruct)
    }
 
    return;
-} /* BV32_BitPack */
+} /* bv32fx_BitPack */
 
 /***************************************************************************/
 /**
@@ -211,7 +211,7 @@ void BV32_BitPack(UWord8 *PackedStream, struct BV32_Bit_Stream *BitStruct)
 *      };
 */
 
-void BV32_BitUnPack (UWord8 *PackedStream, struct BV32_Bit_Stream * BitStruct ) 
+void bv32fx_BitUnPack (UWord8 *PackedStream, struct BV32_Bit_Stream * BitStruct ) 
 {
    UWord32 bitword32;
    int i;
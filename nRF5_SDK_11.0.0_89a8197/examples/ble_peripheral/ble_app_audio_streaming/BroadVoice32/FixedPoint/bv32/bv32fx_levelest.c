@@ -29,7 +29,7 @@
 #include "bv32cnst.h"
 #include "basop32.h"
 
-Word32	estlevel(
+Word32	bv32fx_estlevel(
                   Word32	lg,
                   Word32	*level,
                   Word32	*lmax,
@@ -41,6 +41,8 @@ Word32	estlevel(
    Word32	a0;
    Word16	s, t;
    
+   WMOPS_ENTER("bv32fx_estlevel");
+   
    /* UPDATE THE NEW MAXIMUM, MINIMUM, & MEAN OF LOG-GAIN */
    if (lg > *lmax) *lmax=lg;	/* use new log-gain as max if it is > max */
    else { 					/* o.w. attenuate toward lmean */
@@ -94,6 +96,7 @@ Word32	estlevel(
       *level = L_add(a0, Mpy_32_16(s, t, estl_a1));
    }
    
+   WMOPS_LEAVE();
    return	lth;
    
 }
@@ -29,7 +29,7 @@
 
 /* for log-gain restriction */
 
-Word16 lgclimit[] = {
+Word16 bv32fx_lgclimit[] = {
        0,      69,    1160,    1507,    2416,       0,
        0,       0,       0,       0,       0,       0,
      330,    2509,    1732,    2346,    2915,       0,
@@ -65,7 +65,7 @@ Word16 lgclimit[] = {
     1623,    -431,    1952,    -260,       0,       0
 };
 
-Word16 lspecb1[] = {	/* Q16 */
+Word16 bv32fx_lspecb1[] = {	/* Q16 */
   -252,  -557, -1043,  -236,    -9,   400,  1075,  -109,
   -335,  -861, -1113,   -68,  -797,  -280,  -178,   555,
   -241,  -109,    30,  -203,  1189,   -35,   168,  -546,
@@ -196,7 +196,26 @@ Word16 lspecb1[] = {	/* Q16 */
   1781,  4897,  5689,  2343,    12, -2309, -3518, -3232
 };
 
-Word16 lspecb21[] = {	/* Q19 */
+/* search order of bv32fx_lspecb1[]: codevectors by ascending component 4, */
+/* and components by decreasing variance over the codebook          */
+Word16 lspecb1_ord[] = {
+	109, 125, 113, 117, 119,  45,  79, 115,  85,  77, 103, 101,  53,  49,  61,  81,
+	 68,  21,  37,  69,  71,  97,  39,  93, 111,  13,   7,  12,  33,  87,  15,  65,
+	 70, 121,  91, 108,  17,   1,  76,  83,   4,  89, 100,  44,  84,  27,   5,  23,
+	 55,  67,  11,  29,  51,  75,  48,  47,  36, 116,  19,   0,  25,   3, 127,  18,
+	 20,  95, 105,  31,  52, 123, 102,   6,  35,  99,  38,  73,  16,  59,  14,   8,
+	 32,  10,  78,  86,  57,  64,  72,   9,  22,  26,  92,  63,  96,   2,  74,  28,
+	 41,  46,  60, 112,  34,  24,  80,  54,  43,  40,  90,  66,  82, 107, 124,  30,
+	 94,  56, 110,  50,  42,  58, 118, 122, 104,  62, 106,  88,  98, 126, 114, 120
+};
+
+Word16 lspecb1_dim[] = { 4, 6, 5, 2, 3, 1, 7, 0 };
+
+/* per encoder mode: bv32fx_lspecb1[] codevectors searched, pitch refinement range */
+Word16 lspncb1[] = { 128, 48, 16 };
+Word16 ptdev[] = { 6, 3, 1 };
+
+Word16 bv32fx_lspecb21[] = {	/* Q19 */
   1476,  1535,  2274,
   -113,  -198, -1322,
   3718, -2930,  -211,
@@ -231,7 +250,7 @@ Word16 lspecb21[] = {	/* Q19 */
  -6623,-20987,  3345
 };
 
-Word16 lspecb22[] = {	/* Q19 */
+Word16 bv32fx_lspecb22[] = {	/* Q19 */
   1170, -4195, -4714,    34,   306,
   2612,  2018, -3741, -5041, -1611,
     -5,  1207,  4336,  1926,   980,
@@ -266,11 +285,11 @@ Word16 lspecb22[] = {	/* Q19 */
  14966, -5048, -3130,  -449,  -781
 };
 
-Word16 lspmean[] = {	/* Q15 mean value of LSP components */
+Word16 bv32fx_lspmean[] = {	/* Q15 mean value of LSP components */
   1807,  3870,  7372, 10866, 14994, 18746, 23571, 27126
 };
 
-Word16 lspp[] = {	/* Q14 LSP Predictor Coefficients */
+Word16 bv32fx_lspp[] = {	/* Q14 LSP Predictor Coefficients */
  12126, 11370,  9882,  8739,  7037,  5299,  3567,  1905,
  13008, 12605, 10997,  9698,  7783,  5827,  3882,  1935,
  12344, 11990, 10365,  9156,  7422,  5562,  3781,  1968,
@@ -281,21 +300,21 @@ Word16 lspp[] = {	/* Q14 LSP Predictor Coefficients */
   8412,  7153,  5770,  5110,  4119,  3197,  2365,  1378
 };
 
-Word16 lgpecb[] = {	/* Q11 Log-Gain Prediction Error CodeBook */
+Word16 bv32fx_lgpecb[] = {	/* Q11 Log-Gain Prediction Error CodeBook */
 -10074, -7681, -6330, -5324, -4560, -2995, -1803,  -711,
  -3961, -2573, -1436,  -341,   417,  1691,  3274,  5646,
  -3450, -2177, -1077,    32,   818,  2164,  3924,  6847,
   1243,  2687,  4705,  8426, 10670, 13730, 17906, 22368
 };
 
-Word16 lgp[] =	{	/* Q15 Log-Gain Predictor */
+Word16 bv32fx_lgp[] =	{	/* Q15 Log-Gain Predictor */
  19376, 17207, 18759, 19588, 15731, 16185, 15498, 13628,
  12471, 11125,  9110,  8045,  6279,  4817,  3731,  2178
 };
 
-Word16 lgmean = 24208; /* Q11 11.820152 */
+Word16 bv32fx_lgmean = 24208; /* Q11 11.820152 */
 
-Word16 cccb[] = {	/* Q13 */
+Word16 bv32fx_cccb[] = {	/* Q13 */
  -4403,  7987, -5170, -5062,  9381, 10015,-10260,  5048,
   9619, 11464,  2711,  6743, 24141,  6538, -2250,  -224,
 -13960,   809, -4309, -3240, -7283, -2764,  6427,  2445,
@@ -314,7 +333,7 @@ Word16 cccb[] = {	/* Q13 */
   -334, -9355,  2984, -2324,  3672, -6186, 14480, -5664
 };
 
-Word16 pp9cb[] = {	/* Q14 */
+Word16 bv32fx_pp9cb[] = {	/* Q14 */
  -4752,  9807,  4627,  1422, -1385,   671,  -345, -1468,  -327,
  -4223, 22577, 13421,  2909, -9247,  1729,  -272, -7778, -2748,
  -1130,  6587,  3816,   227,  -767,   132,   -19,  -662,  -222,
@@ -350,22 +369,22 @@ Word16 pp9cb[] = {	/* Q14 */
 };
 
 /* Pre-Emphasis or De-Emphasis Filter */
-Word16 a_pre[] = { 4096, 3072 };
-Word16 b_pre[] = { 4096, 2048 };
+Word16 bv32fx_a_pre[] = { 4096, 3072 };
+Word16 bv32fx_b_pre[] = { 4096, 2048 };
 
 /* Combined High-Pass & Pre-Emphasis Filter */
-Word16 hpfa[] = { 32767,  7936, 24384 };		/* Q15 */
-Word16 hpfb[] = { 16320, -8160, -8160  };	/* *0.5 Q15 */
+Word16 bv32fx_hpfa[] = { 32767,  7936, 24384 };		/* Q15 */
+Word16 bv32fx_hpfb[] = { 16320, -8160, -8160  };	/* *0.5 Q15 */
 
 /* coarse pitch search */
 Word16 adf_h[] = { 4096, -14583, 19889, -12284,  2895 };	/* DPF Q28 */
 Word16 adf_l[] = {    0,	 9679, 18108,  25991, 18873 };
-Word16 bdf[] 	= {  4233, -13485, 18964, -13485,  4233 };	/* Q17 */
-Word16 x[4]    = { 4096, 8192, 12288, 16384 };
-Word16 x2[4]   = { 512, 2048, 4608, 8192 };
-Word16 MPTH[4] = {22938, 18022, 15728, 12124};
+Word16 bv32fx_bdf[] 	= {  4233, -13485, 18964, -13485,  4233 };	/* Q17 */
+Word16 bv32fx_x[4]    = { 4096, 8192, 12288, 16384 };
+Word16 bv32fx_x2[4]   = { 512, 2048, 4608, 8192 };
+Word16 bv32fx_MPTH[4] = {22938, 18022, 15728, 12124};
 
-Word16 winl[] = {	/* Q15 */
+Word16 bv32fx_winl[] = {	/* Q15 */
      6,    22,    50,    88,   138,   198,   270,   352,
    445,   549,   664,   789,   924,  1071,  1227,  1393,
   1570,  1757,  1953,  2160,  2376,  2601,  2836,  3079,
@@ -395,12 +414,12 @@ Word16 sstwinl_h[] = {
 Word16 sstwinl_l[] = {
    26146, 11409, 24833,  8680,  6585, 32423,  4714,  8677 };	/* 45 dB */
 
-Word16 idxord[] = {
+Word16 bv32fx_idxord[] = {
 	0,  1,  2,  3,  4,  8, 16,  5,  9, 17,  6, 10, 18,  7, 11, 19,
 	12, 20, 24, 13, 21, 25, 14, 22, 26, 15, 23, 27, 28, 29, 30, 31
 };
 
-Word16 lgpecb_nh[]={ -7681,  -6330,  -5324,  -4560,  -3961,  -2573,  -1436,   -341, 
+Word16 bv32fx_lgpecb_nh[]={ -7681,  -6330,  -5324,  -4560,  -3961,  -2573,  -1436,   -341, 
 			  -3450,  -2177,  -1077,     32,    818,   2164,   3924,   6847,
 			  -2995,  -1803,   -711,    417,   1243,   2687,   4705,   8426,
 			   1691,   3274,   5646,  10670,  13730,  17906,  22368};
@@ -79,6 +79,7 @@ struct BV32_Encoder_State {
    Word16   hpfzm[HPO];
    Word16   hpfpm[2*HPO];
    Word16   cpplast;          /* pitch period pf the previous frame */
+   Word16   mode;             /* complexity mode, BV32_MODE_* */
 };
 
 struct BV32_Bit_Stream {
@@ -89,5 +90,15 @@ struct BV32_Bit_Stream {
    short    qvidx[NVPSF];
 };
 
+/* one frame as decoded by BV32_DecodeParams(), for BV32_Synthesize() */
+struct BV32_Frame_Params {
+   Word16   a[LPCO+1];       /* LPC predictor */
+   Word16   bq[3];           /* Q15 pitch taps */
+   Word16   pp;              /* pitch period */
+   Word16   gainq[NSF];      /* Q2 excitation gains w.r.t. gain_exp */
+   Word16   gain_exp[NSF];
+   short    qvidx[NVPSF];
+};
+
 #endif
 
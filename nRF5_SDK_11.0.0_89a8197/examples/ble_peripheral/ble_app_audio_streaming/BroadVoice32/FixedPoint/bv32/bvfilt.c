@@ -0,0 +1,148 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bvfilt.c : BroadVoice32 filter kernel benchmark
+
+  Times the generic all-pole and all-zero filters against the unrolled
+  kernels the codec calls, at the orders and frame sizes it uses, on a
+  synthetic signal filtered frame by frame with its memory carried over,
+  and checks that both give the same output.
+
+  $Log$
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "typedef.h"
+#include "bvcommon.h"
+#include "bv32cnst.h"
+#include "bv32strct.h"
+#include "bv32externs.h"
+#include "utility.h"
+
+#define NFRAMES   200         /* frames in the test signal */
+#define MINTIME   0.2         /* seconds of CPU time per measurement */
+
+enum { AP_LPCO, APQ1_LPCO, APQ1_LPCO_SF, AP_1, AZ_1, AZQ0_LPCO, NKERNELS };
+
+static char *kname[NKERNELS] = {
+   "apfilter_lpco       (decoder, encoder)",
+   "apfilterQ1_Q0_lpco  (decoder)",
+   "apfilterQ1_Q0_lpco  (PLC, SFSZ)",
+   "apfilter_1          (de-emphasis)",
+   "azfilter_1          (de-emphasis)",
+   "azfilterQ0_Q1_lpco  (encoder)",
+};
+
+static Word16 a[LPCO+1];      /* Q12 LPC predictor of the mean LSP */
+static Word16 sig[LPCO+NFRAMES*FRSZ];
+
+/* filter the whole signal frame by frame; returns the frames done */
+static int run(int k, int spec, Word16 *y)
+{
+   Word16 mem[LPCO];
+   Word16 *x = sig + LPCO;
+   Word16 lg, n;
+
+   lg = (k == APQ1_LPCO_SF) ? SFSZ : FRSZ;
+   W16zero(mem, LPCO);
+   for (n = 0; n < NFRAMES*FRSZ; n += lg)
+      switch (k) {
+      case AP_LPCO:
+         if (spec)
+            apfilter_lpco(a, x+n, y+n, lg, mem, 1);
+         else
+            bv32fx_apfilter(a, LPCO, x+n, y+n, lg, mem, 1);
+         break;
+      case APQ1_LPCO:
+      case APQ1_LPCO_SF:
+         if (spec)
+            apfilterQ1_Q0_lpco(a, x+n, y+n, lg, mem, 1);
+         else
+            apfilterQ1_Q0(a, LPCO, x+n, y+n, lg, mem, 1);
+         break;
+      case AP_1:
+         if (spec)
+            apfilter_1(bv32fx_b_pre, x+n, y+n, lg, mem, 1);
+         else
+            bv32fx_apfilter(bv32fx_b_pre, 1, x+n, y+n, lg, mem, 1);
+         break;
+      case AZ_1:
+         if (spec)
+            azfilter_1(bv32fx_a_pre, x+n, y+n, lg);
+         else
+            bv32fx_azfilter(bv32fx_a_pre, 1, x+n, y+n, lg);
+         break;
+      case AZQ0_LPCO:
+         if (spec)
+            azfilterQ0_Q1_lpco(a, x+n, y+n, lg);
+         else
+            azfilterQ0_Q1(a, LPCO, x+n, y+n, lg);
+         break;
+      }
+   return NFRAMES*FRSZ/lg;
+}
+
+/* CPU time per call */
+static double bench(int k, int spec, Word16 *y)
+{
+   clock_t  t0;
+   double   t;
+   long     calls = 0;
+
+   t0 = clock();
+   do {
+      calls += run(k, spec, y);
+      t = (double)(clock()-t0)/CLOCKS_PER_SEC;
+   } while (t < MINTIME);
+   return t / calls;
+}
+
+int   main(void)
+{
+   Word16 y0[NFRAMES*FRSZ], y1[NFRAMES*FRSZ];
+   UWord32 seed = 1;
+   double   t0, t1;
+   int      i, k, bad = 0;
+
+   fprintf(stderr," BroadVoice32 Fixed-Point filter kernels, %d frames per run\n", NFRAMES);
+
+   bv32fx_lsp2a(bv32fx_lspmean, a);
+   /* noise, 20 ms at a time louder and softer, as in speech */
+   for (i = 0; i < LPCO+NFRAMES*FRSZ; i++) {
+      seed = 1664525L*seed + 1013904223L;
+      sig[i] = (Word16)((Word32)(seed >> 16) - 32768) >> ((i / (2*FRSZ)) % 6);
+   }
+
+   fprintf(stderr,"\n %-40s %10s %10s %8s\n", "kernel", "generic", "unrolled", "speed-up");
+   for (k = 0; k < NKERNELS; k++) {
+      t0 = bench(k, 0, y0);
+      t1 = bench(k, 1, y1);
+      i = memcmp(y0, y1, sizeof(y0)) != 0;
+      bad += i;
+      fprintf(stderr," %-40s %8.0f ns %8.0f ns %8.2f %s\n", kname[k],
+         t0*1e9, t1*1e9, t1 > 0. ? t0/t1 : 0., i ? "  OUTPUT DIFFERS" : "");
+   }
+   return bad != 0;
+}
@@ -0,0 +1,306 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  bvmsd.c : BroadVoice32 multi-stream decoder program
+
+  Decodes every input file of packed frames as one or more streams at
+  once, the way a server decodes what each device in the field plays.
+  Frames are handed to the decoder a round at a time for every stream,
+  as they would arrive over the network, and the time to decode them all
+  is reported, optionally for 1, 2, 4, ... threads to show the scaling.
+  With -p each stream is instead decoded on its own by the two-stage
+  pipelined decoder, against one thread decoding it all by itself.
+
+  $Log$
+******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "typedef.h"
+#include "bvcommon.h"
+#include "bv32cnst.h"
+#include "bv32strct.h"
+#include "bitpack.h"
+#include "msdec.h"
+#include "pipedec.h"
+
+struct Input {
+   char     *name;
+   UWord8   *buf;
+   int      nframes;
+};
+
+struct Job {
+   struct Input *in;
+   int      ninputs;
+   int      nstreams;        /* stream k decodes input k % ninputs */
+   int      maxframes;
+   Word16   **out;           /* decoded speech per stream, or NULL */
+   int      *done;           /* frames decoded per stream */
+};
+
+struct PipeCtx {
+   struct Job *job;
+   int      stream;
+};
+
+void  usage(char *name)
+{
+   fprintf(stderr,"usage: %s [options] input ...\n", name);
+   fprintf(stderr,"\nFormat for input files: packed bit-stream, 20 bytes per frame.\n");
+   fprintf(stderr,"\nOptions:\n");
+   fprintf(stderr,"  -t n    worker threads (default: number of CPUs)\n");
+   fprintf(stderr,"  -c n    streams per input file (default 1)\n");
+   fprintf(stderr,"  -b n    frames per stream decoded in one go (default 16)\n");
+   fprintf(stderr,"  -r n    frames per stream handed over per round (default 50)\n");
+   fprintf(stderr,"  -s      also run with 1, 2, 4, ... threads and report the scaling\n");
+   fprintf(stderr,"  -p      decode each stream in turn with the two-stage pipeline\n");
+   fprintf(stderr,"  -o dir  write the speech of stream k to dir/k.raw\n");
+   exit(1);
+}
+
+static double now(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+
+static void sink(void *ctx, int stream, Word16 *pcm, int nframes)
+{
+   struct Job *job = (struct Job *)ctx;
+
+   if (job->out)
+      memcpy(job->out[stream] + job->done[stream]*FRSZ, pcm, nframes*FRSZ*sizeof(Word16));
+   job->done[stream] += nframes;
+}
+
+static void pipe_sink(void *ctx, Word16 *pcm, int nframes)
+{
+   struct PipeCtx *pc = (struct PipeCtx *)ctx;
+
+   sink(pc->job, pc->stream, pcm, nframes);
+}
+
+static int load(struct Input *in)
+{
+   FILE     *fi;
+   long     size;
+
+   if (!(fi = fopen(in->name, "rb")))
+      return 0;
+   fseek(fi, 0, SEEK_END);
+   size = ftell(fi);
+   fseek(fi, 0, SEEK_SET);
+   in->nframes = (int)(size / BV32_PACKED_BYTES);
+   in->buf = (UWord8 *)malloc(in->nframes*BV32_PACKED_BYTES + 1);
+   if (in->buf)
+      in->nframes = (int)fread(in->buf, BV32_PACKED_BYTES, in->nframes, fi);
+   fclose(fi);
+   return in->buf != NULL;
+}
+
+/* decode all streams with nthreads workers; returns the wall-clock time */
+static double decode(struct Job *job, int nthreads, int batch, int round,
+                     struct BV32_MSDec_Stats *st)
+{
+   struct BV32_MSDec *msd;
+   struct Input *in;
+   double   t0, t1;
+   int      f, k, n;
+
+   msd = BV32_MSDec_Open(job->nstreams, nthreads, round, batch, sink, job);
+   if (!msd) {
+      fprintf(stderr,"error: can't start %d decoder threads\n", nthreads);
+      exit(4);
+   }
+   for (k = 0; k < job->nstreams; k++)
+      job->done[k] = 0;
+
+   t0 = now();
+   for (f = 0; f < job->maxframes; f += round) {
+      for (k = 0; k < job->nstreams; k++) {
+         in = &job->in[k % job->ninputs];
+         n = in->nframes - f;
+         if (n > round)
+            n = round;
+         if (n > 0)
+            BV32_MSDec_Push(msd, k, in->buf + f*BV32_PACKED_BYTES, NULL, n);
+      }
+      BV32_MSDec_Wait(msd);
+   }
+   t1 = now();
+
+   BV32_MSDec_Stats(msd, st);
+   BV32_MSDec_Close(msd);
+   return t1 - t0;
+}
+
+/* decode one stream after another, each with the pipelined decoder */
+static double pipe_decode(struct Job *job, int round, struct BV32_MSDec_Stats *st)
+{
+   struct BV32_PipeDec *pd;
+   struct PipeCtx pc;
+   struct Input *in;
+   double   t0, t1;
+   int      f, k, n;
+
+   pc.job = job;
+   st->frames = st->batches = st->steals = 0;
+   t0 = now();
+   for (k = 0; k < job->nstreams; k++) {
+      job->done[k] = 0;
+      pc.stream = k;
+      if (!(pd = BV32_PipeDec_Open(round, pipe_sink, &pc))) {
+         fprintf(stderr,"error: can't start the synthesis thread\n");
+         exit(4);
+      }
+      in = &job->in[k % job->ninputs];
+      for (f = 0; f < in->nframes; f += round) {
+         n = in->nframes - f;
+         if (n > round)
+            n = round;
+         BV32_PipeDec_Push(pd, in->buf + f*BV32_PACKED_BYTES, NULL, n);
+      }
+      BV32_PipeDec_Wait(pd);
+      BV32_PipeDec_Close(pd);
+      st->frames += job->done[k];
+   }
+   t1 = now();
+   return t1 - t0;
+}
+
+static void report(int nthreads, double t, double t1, struct BV32_MSDec_Stats *st)
+{
+   double   fps = (t > 0.) ? st->frames / t : 0.;
+
+   fprintf(stderr," %3d thread%s %8.3f s %10.0f frames/s %8.0f streams in real time",
+      nthreads, (nthreads == 1) ? " " : "s", t, fps, fps*FRSZ/(SF*1000.));
+   if (t1 > 0. && t > 0.)
+      fprintf(stderr,"  speed-up %5.2f (%3.0f%%)", t1/t, 100.*t1/t/nthreads);
+   fprintf(stderr,"  %ld steals\n", st->steals);
+}
+
+int   main(int argc, char **argv)
+{
+   struct Job job;
+   struct BV32_MSDec_Stats st;
+   char     *outdir = NULL;
+   char     path[1024];
+   FILE     *fo;
+   long     total;
+   double   t, t1 = 0., fps;
+   int      nthreads, copies = 1, batch = 16, round = 50, scale = 0, pipe = 0;
+   int      i, k;
+
+   nthreads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+   if (nthreads < 1)
+      nthreads = 1;
+
+   for (i = 1; i < argc && argv[i][0] == '-'; i++) {
+      if (!strcmp(argv[i], "-s"))
+         scale = 1;
+      else if (!strcmp(argv[i], "-p"))
+         pipe = 1;
+      else if (i+1 >= argc)
+         usage(argv[0]);
+      else if (!strcmp(argv[i], "-t"))
+         nthreads = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-c"))
+         copies = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-b"))
+         batch = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-r"))
+         round = atoi(argv[++i]);
+      else if (!strcmp(argv[i], "-o"))
+         outdir = argv[++i];
+      else
+         usage(argv[0]);
+   }
+   if (i >= argc || nthreads < 1 || copies < 1 || batch < 1 || round < 1)
+      usage(argv[0]);
+
+   fprintf(stderr," BroadVoice32 Fixed-Point Multi-Stream Decoder V1.2 with packed bit-stream\n");
+
+   job.ninputs = argc - i;
+   job.in = (struct Input *)calloc(job.ninputs, sizeof(struct Input));
+   job.maxframes = 0;
+   total = 0;
+   for (k = 0; k < job.ninputs; k++) {
+      job.in[k].name = argv[i+k];
+      if (!load(&job.in[k])) {
+         fprintf(stderr,"error: can't read %s\n", job.in[k].name);
+         exit(2);
+      }
+      if (job.in[k].nframes > job.maxframes)
+         job.maxframes = job.in[k].nframes;
+      total += job.in[k].nframes;
+   }
+   job.nstreams = job.ninputs * copies;
+   job.done = (int *)calloc(job.nstreams, sizeof(int));
+   job.out = NULL;
+   if (outdir) {
+      job.out = (Word16 **)calloc(job.nstreams, sizeof(Word16 *));
+      for (k = 0; k < job.nstreams; k++)
+         job.out[k] = (Word16 *)malloc((job.in[k % job.ninputs].nframes*FRSZ + 1)*sizeof(Word16));
+   }
+
+   fprintf(stderr," %d streams, %ld frames (%.1f s of speech), %d frames per batch, %d per round\n",
+      job.nstreams, total*copies, total*copies*FRSZ/(SF*1000.), batch, round);
+
+   if (pipe) {
+      t1 = decode(&job, 1, batch, round, &st);
+      report(1, t1, t1, &st);
+      t = pipe_decode(&job, round, &st);
+      fps = (t > 0.) ? st.frames / t : 0.;
+      fprintf(stderr," pipeline   %8.3f s %10.0f frames/s %8.0f streams in real time  speed-up %5.2f\n",
+         t, fps, fps*FRSZ/(SF*1000.), (t > 0.) ? t1/t : 0.);
+   }
+   else {
+      if (scale)
+         for (k = 1; k < nthreads; k *= 2) {
+            t = decode(&job, k, batch, round, &st);
+            if (k == 1)
+               t1 = t;
+            report(k, t, t1, &st);
+         }
+      t = decode(&job, nthreads, batch, round, &st);
+      report(nthreads, t, (nthreads == 1) ? t : t1, &st);
+   }
+
+   if (outdir)
+      for (k = 0; k < job.nstreams; k++) {
+         sprintf(path, "%.1000s/%d.raw", outdir, k);
+         if (!(fo = fopen(path, "wb"))) {
+            fprintf(stderr,"error: can't write to %s\n", path);
+            exit(3);
+         }
+         fwrite(job.out[k], sizeof(Word16), job.done[k]*FRSZ, fo);
+         fclose(fo);
+      }
+
+   return 0;
+}
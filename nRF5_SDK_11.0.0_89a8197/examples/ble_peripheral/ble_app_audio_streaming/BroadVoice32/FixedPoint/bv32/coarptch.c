@@ -31,6 +31,7 @@
 #include "bv32strct.h"
 #include "bv32externs.h"
 #include "basop32.h"
+#include "dspop.h"
 
 Word16 	coarsepitch(
                      Word16 	*xw,				/* (i) Q0 weighted low-band signal frame */
@@ -58,7 +59,8 @@ Word16 	coarsepitch(
    
    Word16    i, j, k, n, npeaks, imax, idx[MAXPPD-MINPPD+1];
    Word16    cpp;
-   Word16 plag[HMAXPPD], _cor2[MAXPPD1+1], _cor2_exp[MAXPPD1+1];
+   Word16 plag[HMAXPPD] = {0}; /* npeaks >= 2 below, but the compiler cannot tell */
+   Word16 _cor2[MAXPPD1+1], _cor2_exp[MAXPPD1+1];
    Word16 cor2i[HMAXPPD], cor2i_exp[HMAXPPD], xwd[LXD];
    Word16 tmp_h[DFO+FRSZ], tmp_l[DFO+FRSZ]; /* DPF Q7 */
    Word32 _cor[MAXPPD1+1], _energy[MAXPPD1+1], lxwd[FRSZD];
@@ -67,6 +69,11 @@ Word16 	coarsepitch(
    Word16 *energy_man, *energy_exp;
    Word16 energym_man, energym_exp;
    Word16 energymax_man, energymax_exp;
+#if DSPOP
+   Word16 dsp;
+#endif
+   
+   WMOPS_ENTER("coarsepitch");
    
    /* LOWPASS FILTER xw() TO 800 Hz; SHIFT & OUTPUT INTO xwd() */
    /* AP and AZ filtering and decimation */
@@ -77,11 +84,46 @@ Word16 	coarsepitch(
    a1 = 1;
    
    exp = 0;
-   for (i=0;i<DFO;i++) tmp_h[i] = cstate->dfm_h[2*i+1];
-   for (i=0;i<DFO;i++) tmp_l[i] = cstate->dfm_h[2*i];
+   for (i=0;i<DFO;i++) tmp_h[i] = cstate->dfm_h[i];
+   for (i=0;i<DFO;i++) tmp_l[i] = cstate->dfm_l[i];
    
    lp0 = lxwd;
    
+#if DSPOP
+   /* AP filter the whole frame before decimating: the AZ part only reads */
+   /* AP outputs, and a single check of their range then covers all of   */
+   /* its 32x16 multiply-accumulates, each |Mpy_32_16| <= 2*(|hi|+1)*|b| */
+   for (i=0;i<FRSZ;i++) {
+      a0 = L_shr(L_deposit_h(*sp++),11);
+      fp2_h = fp1_h-1;
+      fp2_l = fp1_l-1;
+      for (j=0;j<DFO;j++)		/* adf Q12 */ 
+         a0 = L_sub(a0, Mpy_32(*fp2_h--,*fp2_l--,adf_h[j+1], adf_l[j+1]));
+      a0 = L_shl(a0, 3);
+      L_Extract(a0, fp1_h++, fp1_l++);
+   }
+   dsp = DSPOP_GUARD((Word64)2*(dsp_maxabs(tmp_h, DFO+FRSZ)+1)*dsp_sumabs(bv32fx_bdf, DFO+1) <= MAX_32);
+   
+   for (i=0;i<FRSZD;i++) {
+      fp2_h = tmp_h+DFO+(i+1)*DECF-1;
+      fp2_l = tmp_l+DFO+(i+1)*DECF-1;
+      if (dsp) {
+         a0 = 0;
+         for (j=0;j<=DFO;j++)	/* Mpy_32_16 = 2*SMULWB(L_Comp(hi,lo),b) */
+            a0 = dsp_smlawb(L_Comp(*fp2_h--,*fp2_l--), bv32fx_bdf[j], a0);
+         a0 = dsp_qadd(a0, a0); /* Q17 */
+      }
+      else {
+         a0 = Mpy_32_16(*fp2_h--, *fp2_l--, bv32fx_bdf[0]); /* Q17 */
+         for (j=0;j<DFO;j++)
+            a0=L_add(a0,Mpy_32_16(*fp2_h--,*fp2_l--,bv32fx_bdf[j+1]));
+      }
+      a0 = L_shr(a0, exp);
+      *lp0++ = a0;
+      a0 = L_abs(a0);
+      if (a1 < a0) a1 = a0;
+   }
+#else
    for (i=0;i<FRSZD;i++) {
       for (k=0;k<DECF;k++) {
          a0 = L_shr(L_deposit_h(*sp++),11);
@@ -94,21 +136,22 @@ Word16 	coarsepitch(
       }
       fp2_h = fp1_h-1;
       fp2_l = fp1_l-1;
-      a0 = Mpy_32_16(*fp2_h--, *fp2_l--, bdf[0]); /* Q17 */
+      a0 = Mpy_32_16(*fp2_h--, *fp2_l--, bv32fx_bdf[0]); /* Q17 */
       for (j=0;j<DFO;j++)
-         a0=L_add(a0,Mpy_32_16(*fp2_h--,*fp2_l--,bdf[j+1]));
+         a0=L_add(a0,Mpy_32_16(*fp2_h--,*fp2_l--,bv32fx_bdf[j+1]));
       a0 = L_shr(a0, exp);
       *lp0++ = a0;
       a0 = L_abs(a0);
       if (a1 < a0) a1 = a0;
    }
+#endif
    
    /* copy temp buffer to memory */
    fp1_h -= DFO;
    fp1_l -= DFO;
    for (i=0;i<DFO;i++) {
-      cstate->dfm_h[2*i+1] = fp1_h[i];
-      cstate->dfm_h[2*i] = fp1_l[i];
+      cstate->dfm_h[i] = fp1_h[i];
+      cstate->dfm_l[i] = fp1_l[i];
    }
    
    /* setup local xwd[] */
@@ -187,12 +230,10 @@ Word16 	coarsepitch(
    fp2 = xwd+LXD-M1-1;
    fp3 = xwd+MAXPPD1-M1-1;
    
+   Crosscorr(cor+M1, xwd+MAXPPD1, xwd+MAXPPD1-M1-1, LXD-MAXPPD1, M2-M1);
+   
    for (i=M1;i<M2;i++) {
-      fp0 = xwd+MAXPPD1;
-      fp1 = xwd+MAXPPD1-i-1;
-      a1 = 0;
-      for (j=0;j<(LXD-MAXPPD1);j++) a1 = L_mac0(a1,*fp0++,*fp1++); 
-      cor[i] = a1;
+      a1 = cor[i];
       a0 = L_msu0(a0, *fp2, *fp2);
       a0 = L_mac0(a0, *fp3, *fp3);
       fp2--; fp3--;
@@ -242,10 +283,12 @@ Word16 	coarsepitch(
    /* RETURN EARLY IF THERE IS NO PEAK OR ONLY ONE PEAK */
    if (npeaks == 0){   /* if there are no positive peak, */
       
+      WMOPS_LEAVE();
       return MINPPD*DECF; /* return minimum pitch period */
    }
    if (npeaks == 1){   /* if there is exactly one peak, */
       
+      WMOPS_LEAVE();
       return (idx[0]+1)*DECF; /* return the time lag for this single peak */
    }
    
@@ -291,7 +334,7 @@ Word16 	coarsepitch(
          deltae = L_shr(L_sub(energy[n+1], eni), 3);
          
          for (k = 0; k < HDECF; k++) {
-            a0=L_add(L_add(Mpy_32_16(ah,al,x2[k]),Mpy_32_16(bh,bl,x[k])),cc);
+            a0=L_add(L_add(Mpy_32_16(ah,al,bv32fx_x2[k]),Mpy_32_16(bh,bl,bv32fx_x[k])),cc);
             eni = L_add(eni, deltae);
             a1 = eni;
             
@@ -321,7 +364,7 @@ Word16 	coarsepitch(
          
          deltae = L_shr(L_sub(energy[n-1], eni), 3);
          for (k = 0; k < HDECF; k++) {
-            a0=L_add(L_sub(Mpy_32_16(ah,al,x2[k]),Mpy_32_16(bh,bl,x[k])),cc);
+            a0=L_add(L_sub(Mpy_32_16(ah,al,bv32fx_x2[k]),Mpy_32_16(bh,bl,bv32fx_x[k])),cc);
             eni = L_add(eni, deltae);
             a1=eni;
             
@@ -446,7 +489,7 @@ Word16 	coarsepitch(
                  /* then check if peak value large enough */
                  a0 = L_mult(cor2i[j],energymax_man);
                  if (k<4) 
-                    t1 = MPTH[k];
+                    t1 = bv32fx_MPTH[k];
                  else 
                     t1 = MPTH4;
                  t1 = extract_h(L_mult(t1, energyi_man[j]));
@@ -477,6 +520,7 @@ Word16 	coarsepitch(
            
            cpp = plag[i];
            
+           WMOPS_LEAVE();
            return cpp;         /* return to calling function */
         }
      }       
@@ -492,6 +536,7 @@ Word16 	coarsepitch(
   if (im != -1) {   /* if there is at least one peak around last pitch */
      if (im == imax) { /* if this peak is also the global maximum, */
         
+        WMOPS_LEAVE();
         return cpp;   /* return first pitch candidate at global max */
      }
      if (im < imax) { /* if lag of this peak < lag of global max, */
@@ -508,6 +553,7 @@ Word16 	coarsepitch(
               
               cpp = plag[im];
               
+              WMOPS_LEAVE();
               return cpp;
            }
            for (k=2; k<=5;k++) { /* check if current candidate pitch */
@@ -519,6 +565,7 @@ Word16 	coarsepitch(
                  
                  cpp = plag[im];		/* accept this lag */
 
+                 WMOPS_LEAVE();
                  return cpp;         /* and return as pitch */
               }
            }
@@ -536,6 +583,7 @@ Word16 	coarsepitch(
            
            cpp = plag[im];	/* accept its lag */
            
+           WMOPS_LEAVE();
            return cpp;
         }
      }
@@ -544,6 +592,7 @@ Word16 	coarsepitch(
   /* IF PROGRAM PROCEEDS TO HERE, WE HAVE NO CHOICE BUT TO ACCEPT THE
   LAG OF THE GLOBAL MAXIMUM */
   
+  WMOPS_LEAVE();
   return cpp;
   
 }
@@ -30,10 +30,17 @@
 #include "bv32cnst.h"
 #include "bv32strct.h"
 #include "bv32externs.h"
+#include "bv32.h"
+#include "bitpack.h"
 #include "basop32.h"
 #include "utility.h"
 #include "mathutil.h"
 
+/* the de-emphasis filters are the first-order kernels */
+#if PFO != 1
+#error PFO must be 1
+#endif
+
 void Reset_BV32_Decoder(struct BV32_Decoder_State *c)
 {
    int i;
@@ -61,50 +68,46 @@ void Reset_BV32_Decoder(struct BV32_Decoder_State *c)
       c->atplc[i+1] = 0;
 }
 
-void BV32_Decode(
-                 struct BV32_Bit_Stream      *bs,
-                 struct BV32_Decoder_State   *ds,
-                 Word16 *x)
+/* smaller of hdr and the left shift head-room of x (zero has unlimited head-room) */
+static Word16 memhdr(Word16 x, Word16 hdr)
+{
+   Word16 n;
+   
+   if(x == 0)
+      return hdr;
+   n = norm_s(x);
+   return (n < hdr) ? n : hdr;
+}
+
+/* Parameter stage: everything that depends only on the bit-stream and  */
+/* the LSP, gain and level predictor state. It does not touch the state */
+/* BV32_Synthesize() uses, so the next frame can be decoded while this  */
+/* one is synthesized; BV32_PLC() uses both and must run in between.    */
+void BV32_DecodeParams(
+                       struct BV32_Bit_Stream      *bs,
+                       struct BV32_Decoder_State   *ds,
+                       struct BV32_Frame_Params    *fp)
 {
    Word32 a0;
-   Word16 gainq;              /* Q2 */
-   Word16 gain_exp;
-   Word16 pp, ssf, ssfo;
-   Word16 i;
-   Word16 tmp, max, new_exp, dif_exp;
+   Word16 ssf;
    Word32 lgq[NSF];           /* DQ25 */
-   Word16 xq[FRSZ+PFO];
-   Word16 ltsym[LTMOFF+FRSZ];
-   Word16 qv[FRSZ];
-   Word32 qv32[FRSZ];
-   Word16 a[LPCO+1];
-   Word16 lspq[LPCO];        /* Q15 */
-   Word16 cbs[VDIM*CBSZ];     /* Q0 */
-   Word16 bq[3];              /* Q15 */
-   Word16 memtmp[LPCO]; /* Q0 */
-   Word32 bss;
-   Word32  E;
+   Word16 lspq[LPCO];         /* Q15 */
    
-   ds->cfecount = 0; /* reset frame erasure counter */ 
+   WMOPS_ENTER("BV32_DecodeParams");
    
    /* decode spectral information */
    lspdec(lspq,bs->lspidx,ds->lsppm,ds->lsplast);
-   lsp2a(lspq,a);
+   bv32fx_lsp2a(lspq,fp->a);
    W16copy(ds->lsplast, lspq, LPCO);
    
-   /* copy state memory ltsym[] to local buffer */
-   W16copy(ltsym, ds->ltsym, LTMOFF);
-   
    /* decode pitch period */
-   pp = bs->ppidx + MINPP;
+   fp->pp = bs->ppidx + MINPP;
    
    /* decode pitch taps */
-   pp3dec(bs->bqidx, bq);
+   pp3dec(bs->bqidx, fp->bq);
    
    /* loop thru sub-subframes */
-   for (ssf=0;ssf<2;ssf++) {
-      
-      ssfo = ssf*SFSZ;     /* SubFrame Offset */
+   for (ssf=0;ssf<NSF;ssf++) {
       
       /* decode gain */
       a0 = gaindec(lgq+ssf,bs->gidx[ssf],ds->lgpm,ds->prevlg,ds->level,
@@ -116,20 +119,55 @@ void BV32_Decode(
          ds->lctimer = LEVEL_CONVERGENCE_TIME;
       
       /* gain normalization */
-      gain_exp = sub(norm_l(a0), 2);
-      gainq = round(L_shl(a0, gain_exp)); /* Q2 w.r.t gain_exp */
+      fp->gain_exp[ssf] = sub(norm_l(a0), 2);
+      fp->gainq[ssf] = round(L_shl(a0, fp->gain_exp[ssf])); /* Q2 w.r.t gain_exp */
       
       /* Level Estimation */
-      estlevel(ds->prevlg[0],&ds->level,&ds->lmax,&ds->lmin,
+      bv32fx_estlevel(ds->prevlg[0],&ds->level,&ds->lmax,&ds->lmin,
          &ds->lmean,&ds->x1);
+   }
+   
+   /* update average quantized log-gain */
+   ds->lgq_last = L_shr(L_add(lgq[0],lgq[1]),1);
+   
+   W16copy(fp->qvidx, bs->qvidx, NVPSF);
+   WMOPS_LEAVE();
+}
+
+/* Synthesis stage: excitation, LPC synthesis and de-emphasis of a frame */
+/* from BV32_DecodeParams(), in the order the frames were decoded.       */
+void BV32_Synthesize(
+                     struct BV32_Frame_Params    *fp,
+                     struct BV32_Decoder_State   *ds,
+                     Word16 *x)
+{
+   Word16 ssf, ssfo;
+   Word16 i;
+   Word16 tmp, max, new_exp, dif_exp, hdr;
+   Word16 xq[FRSZ+PFO];
+   Word16 ltsym[LTMOFF+FRSZ];
+   Word16 qv[FRSZ];
+   Word32 qv32[FRSZ];
+   Word16 memtmp[LPCO]; /* Q0 */
+   Word32 bss;
+   Word32  E;
+   
+   WMOPS_ENTER("BV32_Synthesize");
+   
+   ds->cfecount = 0; /* reset frame erasure counter */ 
+   
+   /* copy state memory ltsym[] to local buffer */
+   W16copy(ltsym, ds->ltsym, LTMOFF);
+   
+   /* loop thru sub-subframes */
+   for (ssf=0;ssf<NSF;ssf++) {
       
-      /* normalize (by gainq & gain_exp) the excitation codebook */
-      for (i=0;i<(VDIM*CBSZ);i++)         /* Q0 w.r..t. gain_exp */ 
-         cbs[i] = mult_r(gainq, cccb[i]);
+      ssfo = ssf*SFSZ;     /* SubFrame Offset */
       
-      /* decode the excitation signal */
-      excdec_w_LT_synth(qv32+ssfo,ltsym+LTMOFF+ssfo,bs->qvidx+ssf*NVPSSF,
-         bq,cbs,pp,gain_exp, &E);
+      /* decode the excitation signal; only the codevectors selected by */
+      /* qvidx[] are scaled by gainq, inside the synthesis loop          */
+      excdec_w_LT_synth(qv32+ssfo,ltsym+LTMOFF+ssfo,fp->qvidx+ssf*NVPSSF,
+         fp->bq,fp->gainq[ssf],fp->pp,fp->gain_exp[ssf], &E);
       
       ds->E = E;
       
@@ -139,7 +177,7 @@ void BV32_Decode(
    /* LPC pre-synthesis to determine optimal shift */
    for(i=0; i<LPCO; i++)
       memtmp[i] = shr(ds->stsym[i], ds->prv_exp);
-   apfilterQ1_Q0(a, LPCO, ltsym+LTMOFF, xq+PFO, FRSZ, memtmp, 0);
+   apfilterQ1_Q0_lpco(fp->a, ltsym+LTMOFF, xq+PFO, FRSZ, memtmp, 0);
    
    /* find exponent */
    max = abs_s(xq[PFO]);
@@ -162,17 +200,19 @@ void BV32_Decode(
    /* shift of memory relative to previous exponent */ 
    dif_exp = sub(ds->prv_exp, new_exp);
    
-   /* adapt the exponent s.t. the scaled instance memory does not overflow */
-   do {
-      Overflow = 0; /* reset the overflow flag */
-      for(i=0; i<LPCO; i++) shr(ds->stsym[i], dif_exp);
-      shr(ds->depfm[0], dif_exp);
-      shr(ds->dezfm[0], dif_exp);
-      if (Overflow) {
-         dif_exp++;
-         new_exp--;
+   /* adapt the exponent s.t. the scaled instance memory does not overflow: */
+   /* a left shift must not exceed the head-room of any non-zero value     */
+   if(dif_exp < 0){
+      hdr = MAX_16;
+      for(i=0; i<LPCO; i++)
+         hdr = memhdr(ds->stsym[i], hdr);
+      hdr = memhdr(ds->depfm[0], hdr);
+      hdr = memhdr(ds->dezfm[0], hdr);
+      if(add(dif_exp, hdr) < 0){
+         new_exp = add(new_exp, add(dif_exp, hdr));
+         dif_exp = negate(hdr);
       }
-   } while (Overflow);  
+   }
    
    /* shift short-term memory */
    for(i=0; i<LPCO; i++)
@@ -187,23 +227,20 @@ void BV32_Decode(
       qv[i] = round(L_shl(qv32[i], new_exp)); /* Q0 normalized by new_exp */
    
    /* LPC synthesis */
-   apfilter(a, LPCO, qv, xq+PFO, FRSZ, ds->stsym, 1);
+   apfilter_lpco(fp->a, qv, xq+PFO, FRSZ, ds->stsym, 1);
    
    /* update pitch period of last frame */
-   ds->pp_last = pp;
+   ds->pp_last = fp->pp;
    
    /* update signal memory */
    W16copy(ds->ltsym, ltsym+FRSZ, LTMOFF);
-   W16copy(ds->bq_last, bq, 3);
-   
-   /* update average quantized log-gain */
-   ds->lgq_last = L_shr(L_add(lgq[0],lgq[1]),1);
+   W16copy(ds->bq_last, fp->bq, 3);
    
    /* DE-EMPHASIS FILTERING */
-   apfilter(b_pre,PFO,xq+PFO,xq+PFO,FRSZ,ds->depfm,1);
+   apfilter_1(bv32fx_b_pre,xq+PFO,xq+PFO,FRSZ,ds->depfm,1);
    W16copy(xq,ds->dezfm,PFO);
    W16copy(ds->dezfm,xq+FRSZ,PFO);
-   azfilter(a_pre,PFO,xq+PFO,x,FRSZ);
+   azfilter_1(bv32fx_a_pre,xq+PFO,x,FRSZ);
    
    /* shift output back */
    for(i=0; i<FRSZ; i++)
@@ -211,12 +248,52 @@ void BV32_Decode(
    
    ds->prv_exp = new_exp;
    
-   W16copy(ds->atplc, a, LPCO+1);
-   bss = L_add(L_add(bq[0], bq[1]), bq[2]);
+   W16copy(ds->atplc, fp->a, LPCO+1);
+   bss = L_add(L_add(fp->bq[0], fp->bq[1]), fp->bq[2]);
    if (bss > 32768)
       bss = 32768;
    else if (bss < 0)
       bss = 0;
    ds->per = add(shr(ds->per, 1), (Word16)L_shr(bss, 1));
    
+   WMOPS_LEAVE();
+}
+
+void BV32_Decode(
+                 struct BV32_Bit_Stream      *bs,
+                 struct BV32_Decoder_State   *ds,
+                 Word16 *x)
+{
+   struct BV32_Frame_Params fp;
+   
+   WMOPS_ENTER("BV32_Decode");
+   
+   BV32_DecodeParams(bs, ds, &fp);
+   BV32_Synthesize(&fp, ds, x);
+   WMOPS_LEAVE();
+}
+
+/* Decode nframes consecutive packed frames into nframes*FRSZ samples.    */
+/* Frames with a nonzero bfi[] entry are concealed by BV32_PLC instead,   */
+/* their packed bytes are not read; bfi may be NULL when none are lost.   */
+void BV32_DecodeFrames(
+                       UWord8  *PackedStream,
+                       UWord8  *bfi,
+                       int     nframes,
+                       struct BV32_Decoder_State  *ds,
+                       Word16  *out)
+{
+   struct BV32_Bit_Stream bs;
+   int n;
+   
+   for (n = 0; n < nframes; n++) {
+      if (bfi && bfi[n])
+         BV32_PLC(ds, out);
+      else {
+         bv32fx_BitUnPack(PackedStream, &bs);
+         BV32_Decode(&bs, ds, out);
+      }
+      PackedStream += BV32_PACKED_BYTES;
+      out += FRSZ;
+   }
 }
@@ -56,6 +56,13 @@ void Reset_BV32_Encoder(struct BV32_Encoder_State *c)
    c->level = 0x1b000000;     /* 13.5 Q25 */
 }
 
+void BV32_SetEncoderMode(struct BV32_Encoder_State *c, Word16 mode)
+{
+   if ((mode < BV32_MODE_FULL) || (mode > BV32_MODE_FAST))
+      mode = BV32_MODE_FULL;
+   c->mode = mode;
+}
+
 void BV32_Encode(
                  struct 	BV32_Bit_Stream	*bs,
                  struct	BV32_Encoder_State	*cs,
@@ -82,6 +89,8 @@ void BV32_Encode(
    Word32	ee;		/* Q3 */ 
    Word16	gain_exp;
    
+   WMOPS_ENTER("BV32_Encode");
+   
    /* copy state memory to local memory buffers */
    W16copy(x, cs->x, XOFF);
    W16copy(ltnfm, cs->ltnfm, MAXPP1);
@@ -94,7 +103,7 @@ void BV32_Encode(
    W16copy(cs->x,x+FRSZ,XOFF);
    
    /* perform lpc analysis with asymmetrical window */
-   Autocorr(r, x+LX-WINSZ, winl, WINSZ, LPCO);
+   Autocorr(r, x+LX-WINSZ, bv32fx_winl, WINSZ, LPCO);
    Spectral_Smoothing(LPCO, r, sstwinl_h, sstwinl_l);
    Levinson(r, a, cs->old_a, LPCO);
    
@@ -104,13 +113,13 @@ void BV32_Encode(
    a2lsp(a,lsp,cs->lsplast);
    W16copy(cs->lsplast,lsp,LPCO);
    
-   lspquan(lspq,bs->lspidx,lsp,cs->lsppm);
+   lspquan(lspq,bs->lspidx,lsp,cs->lsppm,lspncb1[cs->mode]);
    
-   lsp2a(lspq,a);
+   bv32fx_lsp2a(lspq,a);
    
    /* calculate lpc prediction residual */
    W16copy(dq,cs->dq,XOFF);
-   azfilterQ0_Q1(a,LPCO,x+XOFF,dq+XOFF,FRSZ);
+   azfilterQ0_Q1_lpco(a,x+XOFF,dq+XOFF,FRSZ);
    
    /* use weighted version of lpc filter as noise feedback filter */
    
@@ -119,7 +128,7 @@ void BV32_Encode(
    
    /* get perceptually weighted version of speech */
    for (i=0;i<FRSZ;i++) xw[i] = shr(dq[XOFF+i], 2);
-   apfilter(aw, LPCO, xw, xw, FRSZ, cs->stwpm, 1); 
+   apfilter_lpco(aw, xw, xw, FRSZ, cs->stwpm, 1); 
    
    /* get the coarse version of pitch period using 8:1 decimation */
    cpp = coarsepitch(xw, cs);
@@ -129,7 +138,7 @@ void BV32_Encode(
    also calculate the pitch predictor tap for single-tap predictor */
    
    for (i=0;i<LX;i++) sdq[i] = shr(dq[i],3);
-   pp = refinepitch(sdq, cpp, &ppt);
+   pp = refinepitch(sdq, cpp, ptdev[cs->mode], &ppt);
    bs->ppidx = pp - MINPP;
    
    /* vq 3 pitch predictor taps with minimum residual energy */
@@ -156,15 +165,15 @@ void BV32_Encode(
       gainq  = round(L_shl(a0, gain_exp));
       
       /* Level Estimation */
-      estlevel(cs->prevlg[0],&cs->level,&cs->lmax,&cs->lmin,
+      bv32fx_estlevel(cs->prevlg[0],&cs->level,&cs->lmax,&cs->lmin,
          &cs->lmean,&cs->x1);
       
       /* scale the excitation codebook */
-      for (i=0;i<(VDIM*CBSZ);i++) cbs[i] = mult_r(gainq, cccb[i]);
+      for (i=0;i<(VDIM*CBSZ);i++) cbs[i] = mult_r(gainq, bv32fx_cccb[i]);
       
       /* perform noise feedback coding of the excitation signal */
       excquan(bs->qvidx+ssf*NVPSSF,dq+XOFF+ssfo,aw,bq,beta,ltsym+ssfo,
-         ltnfm+ssfo,cs->stnfm,cbs,pp,gain_exp);   
+         ltnfm+ssfo,cs->stnfm,cbs,pp,gain_exp,cs->mode);   
       
    }	/* end of sub-subframe loop */ 
    
@@ -174,4 +183,5 @@ void BV32_Encode(
    W16copy(cs->ltsym,ltsym+FRSZ,MAXPP1);
    W16copy(cs->ltnfm,ltnfm+FRSZ,MAXPP1);
    
+   WMOPS_LEAVE();
 }
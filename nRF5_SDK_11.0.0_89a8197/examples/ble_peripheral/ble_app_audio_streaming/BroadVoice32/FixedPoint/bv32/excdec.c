@@ -26,7 +26,9 @@
 ******************************************************************************/
 
 #include "typedef.h"
+#include "bvcommon.h"
 #include "bv32cnst.h"
+#include "bv32externs.h"
 #include "basop32.h"
 
 void excdec_w_LT_synth(
@@ -34,7 +36,7 @@ void excdec_w_LT_synth(
                        Word16	*ltsym,	/* (i/o) Q16 long-term synthesis filter memory */
                        Word16 	*idx,   /* (o) quantizer codebook index for uq[] vector */
                        Word16	*b,     /* (i) Q15 coefficient of 3-tap pitch predictor */
-                       Word16 	*cb,    /* (i) Q0 scalar quantizer codebook */
+                       Word16 	gainq,  /* (i) Q2 gain w.r.t. new_exp */
                        Word16 	pp,     /* pitch period (# of 8 kHz samples) */
                        Word16	new_exp,	/* gain_exp of current sub-frame */
                        Word32   *EE
@@ -45,6 +47,8 @@ void excdec_w_LT_synth(
    Word16 m, n, jmin, iv, sign, tt;
    Word32 E;
    
+   WMOPS_ENTER("excdec_w_LT_synth");
+   
    E=0;
    
    /* LOOP THROUGH EVERY VECTOR OF THE CURRENT SUBFRAME */
@@ -55,7 +59,7 @@ void excdec_w_LT_synth(
       jmin = idx[iv++];
       sign = (jmin&CBSZ);
       jmin = jmin-sign;
-      sp2 = &cb[jmin*VDIM];	/* normalized (new_exp) excitation codebook */
+      sp2 = &bv32fx_cccb[jmin*VDIM];	/* Q13 excitation codevector */
       
                               /* COMPUTE PITCH-PREDICTED VECTOR, WHICH SHOULD BE INDEPENDENT OF THE
       RESIDUAL VQ CODEVECTORS BEING TRIED IF vdim < MIN. PITCH PERIOD */
@@ -66,7 +70,7 @@ void excdec_w_LT_synth(
          a0 = L_mult0(*sp1--, b[0]); /* Q16 */
          a0 = L_mac0(a0, *sp1--, b[1]); /* Q16 */
          a0 = L_mac0(a0, *sp1--, b[2]); /* Q16 */
-         a1 = L_shr(L_deposit_h(*sp2++), new_exp);
+         a1 = L_shr(L_deposit_h(mult_r(gainq, *sp2++)), new_exp); /* Q0 codevector scaled on the fly */
          if (sign!=0) a1 = L_negate(a1);
          a0 = L_add(a0, a1); /* Q16 */
          qv[n] = a0; /* Q16 */
@@ -80,4 +84,5 @@ void excdec_w_LT_synth(
    }
    *EE = E;
    
+   WMOPS_LEAVE();
 }
@@ -37,6 +37,8 @@
 #include "bv32cnst.h"
 #include "basop32.h"
 #include "utility.h"
+#include "dspop.h"
+#include "simdop.h"
 
 void excquan(
              Word16 *idx,   /* quantizer codebook index for uq[] vector */
@@ -49,7 +51,8 @@ void excquan(
              Word16	*stnfm, /* (i/o) Q16 filter memory before filtering */
              Word16 *cb,    /* (i) Q1 scalar quantizer codebook */
              Word16 pp,     /* pitch period (# of 8 kHz samples) */
-             Word16	gain_exp
+             Word16	gain_exp,
+             Word16 mode    /* complexity mode, BV32_MODE_* */
              )
 {
    Word32 a0, a1, a2;
@@ -60,11 +63,33 @@ void excquan(
    Word16 gexpm3;
    Word32 Emin, E;
    Word16 e;
+   Word16 tv[VDIM];            /* Q2 VQ target, shl(qzir[],2) */
+   Word16 j0, jinc;
    Word16 qzir[VDIM];	        /* Q0 */
    Word16 buf[LPCO+SFSZ];      /* Q16 buffer for filter memory & signal */
    Word32 ltfv[VDIM], ppv[VDIM]; /* Q16 */
    Word16 qzsr[VDIM*CBSZ];
    Word32 Ezsr[CBSZ];
+#if DSPOP
+   Word16 hr[LPCO];            /* Q12 -h[LPCO], ..., -h[1] */
+   Word16 dsp;
+#endif
+#if SIMDOP
+   Word32 Evq[2*CBSZ];         /* VQ error energies, + and - sign */
+   Word16 simd;
+#endif
+   
+   WMOPS_ENTER("excquan");
+   
+#if DSPOP
+   /* the products summed below are bounded by 32768*|h[i]|; with  */
+   /* 4096*|d| + 2*sum(...) in range no partial sum can saturate    */
+   dsp = DSPOP_GUARD(dsp_maxabs(h+1, LPCO) <= 32767
+      && 4096 + 2*dsp_sumabs(h+1, LPCO) <= 65535);
+   if (dsp)
+      for (i = 0; i < LPCO; i++)
+         hr[i] = negate(h[LPCO-i]);
+#endif
    
    gexpm3 = sub(gain_exp, 3);
    
@@ -82,6 +107,13 @@ void excquan(
          sp1 = &h[n];		/* Q12 */
          sp4 = sp3;			/* Q-1 */
          a0 = 0;
+#if DSPOP
+         if (dsp) {
+            a0 = dsp_dotp(sp4, hr+LPCO-n, n, 0); /* Q11 gain_exp */
+            sp4 += n;
+         }
+         else
+#endif
          for (i=0;i<n;i++) a0 = L_msu0(a0,*sp4++,*sp1--); /* Q11 gain_exp */
          a0 = L_shl(a0, 4);	/* Q15 gain_exp */
          a0 = L_add(L_shr(L_deposit_h(*sp2++),1), a0);  /* Q15 gain_exp */
@@ -121,6 +153,14 @@ void excquan(
          /* PERFORM MULTIPLY-ADDS ALONG THE DELAY LINE OF FILTER */
          sp1 = &buf[n];	/* Q16 */
          a0 = L_mult(d[n], 2048); /* Q13 */
+#if DSPOP
+         if (dsp) {
+            a1 = dsp_dotp(sp1, hr, LPCO, 0);
+            a0 = dsp_qadd(a0, dsp_qadd(a1, a1));
+            sp1 += LPCO;
+         }
+         else
+#endif
          for (i = LPCO; i > 0; i--) a0 = L_msu(a0, *sp1++, h[i]);
          a0 = L_shl(a0, 3);								/* Q16 */
          
@@ -144,31 +184,79 @@ void excquan(
       jmin = 0;
       sign = 1;
       sp4 = qzsr;
-      for (j = 0; j < CBSZ; j++) {
-         /* Try positive sign */
-         sp2 = qzir;
-         E = 0;
-         for (n=0;n<VDIM;n++){
-            e = sub(shl(*sp2++,2), *sp4++);
-            E = L_mac0(E, e, e);
-         }
-         if(L_sub(E, Emin) < 0){
-            jmin = j;
-            Emin = E;
-            sign = 1;
+      if (mode != BV32_MODE_FULL) {
+         
+         /* The error energy of codevector j with sign +-1 is |tv|^2 -   */
+         /* +-2*c + Ezsr[j], c the correlation of tv and qzsr[j]: each   */
+         /* codevector is only tried with the sign of c, and its energy  */
+         /* is found from c alone. FAST tries every other codevector,    */
+         /* the odd ones for odd vectors                                 */
+         j0 = 0;
+         jinc = 1;
+         if (mode == BV32_MODE_FAST) {
+            j0 = iv & 1;
+            jinc = 2;
          }
-         /* Try negative sign */
-         sp4 -= VDIM;
-         sp2 = qzir;
-         E = 0;
-         for (n=0;n<VDIM;n++){
-            e = add(shl(*sp2++,2), *sp4++);
-            E = L_mac0(E, e, e);
+         for (n=0;n<VDIM;n++) tv[n] = shl(qzir[n],2);
+         sp4 = qzsr + j0*VDIM;
+         for (j = j0; j < CBSZ; j += jinc) {
+            a0 = 0;
+            for (n=0;n<VDIM;n++) a0 = L_mac0(a0, tv[n], *sp4++);
+            sp4 += (jinc-1)*VDIM;
+            E = L_sub(Ezsr[j], L_shl(L_abs(a0),1));
+            if(L_sub(E, Emin) < 0){
+               jmin = j;
+               Emin = E;
+               sign = (a0 < 0) ? -1 : 1;
+            }
          }
-         if(L_sub(E, Emin) < 0){
-            jmin = j;
-            Emin = E;
-            sign = -1;
+      }
+      else {
+#if SIMDOP && VDIM == 4
+         simd = simd_vqe4(Evq, qzir, qzsr, CBSZ);
+#elif SIMDOP
+         simd = 0;
+#endif
+         for (j = 0; j < CBSZ; j++) {
+            /* Try positive sign */
+            sp2 = qzir;
+            E = 0;
+#if SIMDOP
+            if (simd) {
+               E = Evq[2*j];
+               sp4 += VDIM;
+            }
+            else
+#endif
+            for (n=0;n<VDIM;n++){
+               e = sub(shl(*sp2++,2), *sp4++);
+               E = L_mac0(E, e, e);
+            }
+            if(L_sub(E, Emin) < 0){
+               jmin = j;
+               Emin = E;
+               sign = 1;
+            }
+            /* Try negative sign */
+            sp4 -= VDIM;
+            sp2 = qzir;
+            E = 0;
+#if SIMDOP
+            if (simd) {
+               E = Evq[2*j+1];
+               sp4 += VDIM;
+            }
+            else
+#endif
+            for (n=0;n<VDIM;n++){
+               e = add(shl(*sp2++,2), *sp4++);
+               E = L_mac0(E, e, e);
+            }
+            if(L_sub(E, Emin) < 0){
+               jmin = j;
+               Emin = E;
+               sign = -1;
+            }
          }
       }
       
@@ -191,6 +279,14 @@ void excquan(
          /* PERFORM MULTIPLY-ADDS ALONG THE DELAY LINE OF FILTER */
          sp1 = &buf[n];
          a0 = L_mult(d[n], 2048); /* Q13 */
+#if DSPOP
+         if (dsp) {
+            a1 = dsp_dotp(sp1, hr, LPCO, 0);
+            a0 = dsp_qadd(a0, dsp_qadd(a1, a1));
+            sp1 += LPCO;
+         }
+         else
+#endif
          for (i = LPCO; i > 0; i--) a0 = L_msu(a0, *sp1++, h[i]);
          a0 = L_shl(a0, 3); /* Q16 */
          
@@ -223,4 +319,5 @@ void excquan(
   /* UPDATE NOISE FEEDBACK FILTER MEMORY AFTER FILTERING CURRENT SUBFRAME */
   W16copy(stnfm, (sp1-LPCO+1), LPCO);
   
+   WMOPS_LEAVE();
 }
@@ -38,22 +38,26 @@
 Word16  refinepitch(
                     Word16	*x,		/* (i) Q1 */
                     Word16 	cpp,
+                    Word16	dev,	/* search range, cpp +- dev <= DEV */
                     Word16	*ppt)	/* (o) Q9 */
 {
    Word32	a0, a1;
    Word32	cor, energy, cormax, enermax32;			/* Q3 */
    Word16	energymax, energymax_exp, ener, ener_exp;
    Word16 	cor2, cor2_exp, cor2max, cor2max_exp;
-   Word16	*sp0, *sp1, *sp2, *sp3;
+   Word16	*sp0, *sp1;
    Word16	s, t;
    Word16 	lb, ub;
    Word16 	pp, i, j;
+   Word32	lcor[2*DEV];
+   
+   WMOPS_ENTER("refinepitch");
    
    if (cpp >= MAXPP) cpp = MAXPP-1;
    if (cpp < MINPP) cpp = MINPP;
-   lb=sub((Word16)cpp,DEV); 
+   lb=sub((Word16)cpp,dev); 
    if (lb < MINPP) lb = MINPP; /* lower bound of pitch period search range */
-   ub=add((Word16)cpp,DEV);
+   ub=add((Word16)cpp,dev);
    /* to avoid selecting MAXPP as the refined pitch period */
    if (ub >= MAXPP) ub = MAXPP-1;/* lower bound of pitch period search range */
    
@@ -80,14 +84,14 @@ Word16  refinepitch(
    cor2max_exp = shl(cor2max_exp, 1);
    cor2max = extract_h(L_mult(s, s));
    
+   /* correlations of the other lags; energy is updated as the lag grows */
+   if (ub > lb)
+      Crosscorr(lcor, x+FS-1, x+FS-lb-2, FE-FS+1, sub(ub, lb));
+   
    sp0 = x+FE-lb-1;
    sp1 = x+FS-lb-2;
    for (i=lb+1;i<=ub;i++) {
-      sp2 = x+FS-1;
-      sp3 = x+FS-i-1;
-      cor = 0;
-      for (j=0;j<(FE-FS+1);j++) 
-         cor = L_mac0(cor, *sp2++, *sp3++);
+      cor = lcor[i-lb-1];
       
       a0 = cor;
       cor2_exp = norm_l(a0);
@@ -132,5 +136,6 @@ Word16  refinepitch(
       *ppt = shl(s, lb);
    }
    
+   WMOPS_LEAVE();
    return pp;
 }
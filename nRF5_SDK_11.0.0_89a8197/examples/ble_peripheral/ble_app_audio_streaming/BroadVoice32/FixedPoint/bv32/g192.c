@@ -36,8 +36,6 @@
 #define BIT_1     (short)0x0081
 #define SYNC_WORD (short)0x6b21
 
-extern Word16	bfi;
-
 Word16	bit_table[] = { 
    7, 5, 5,						/* LSP */
       8,								/* Pitch Lag */
@@ -101,7 +99,7 @@ void bv32_fwrite_g192bitstrm(struct BV32_Bit_Stream *bs, FILE *fo)
 }
 
 /* function to read bit-stream in G.192 compliant format */
-Word16 bv32_fread_g192bitstrm(struct BV32_Bit_Stream *bs, FILE *fi)
+Word16 bv32_fread_g192bitstrm(struct BV32_Bit_Stream *bs, FILE *fi, Word16 *bfi)
 {
    Word16 sync_word, n, m, nread;
    Word16 bitstream[NBIT+1], *p_bitstream;
@@ -109,9 +107,9 @@ Word16 bv32_fread_g192bitstrm(struct BV32_Bit_Stream *bs, FILE *fi)
    
    nread=fread(&sync_word, sizeof(Word16), 1, fi);
    if(sync_word == SYNC_WORD)
-      bfi = 0;
+      *bfi = 0;
    else
-      bfi = 1;
+      *bfi = 1;
    
    fread(bitstream, sizeof(Word16), NBIT+1, fi);
    p_bitstream = bitstream + 1;
@@ -27,4 +27,4 @@
 
 /* prototypes for G.192 bit-stream functions */
 extern void bv32_fwrite_g192bitstrm(struct BV32_Bit_Stream *bs, FILE *fo);
-extern Word16 bv32_fread_g192bitstrm(struct BV32_Bit_Stream *bs, FILE *fi);
+extern Word16 bv32_fread_g192bitstrm(struct BV32_Bit_Stream *bs, FILE *fi, Word16 *bfi);
@@ -46,26 +46,28 @@ Word32 gaindec(			/* Q18 */
    Word16	lg_exp, lg_frac, lgc;
    Word16  i, n, k;
    
+   WMOPS_ENTER("gaindec");
+   
    /* CALCULATE ESTIMATED LOG-GAIN */
-   elg = L_shr(L_deposit_h(lgmean),1);		/* Q26 */
+   elg = L_shr(L_deposit_h(bv32fx_lgmean),1);		/* Q26 */
    for (i = 0; i < LGPORDER; i++) {
-      elg = L_mac0(elg, lgp[i],lgpm[i]);	/* Q26 */
+      elg = L_mac0(elg, bv32fx_lgp[i],lgpm[i]);	/* Q26 */
    }
    elg = L_shr(elg,1);
    
    /* CALCULATE DECODED LOG-GAIN */
-   *lgq = L_add(L_shr(L_deposit_h(lgpecb[gidx]), 2), elg); /* Q25 */
+   *lgq = L_add(L_shr(L_deposit_h(bv32fx_lgpecb[gidx]), 2), elg); /* Q25 */
    
    /* next higher gain */
    if(gidx < LGPECBSZ-1){
-      lgq_nh = L_add(L_shr(L_deposit_h(lgpecb_nh[gidx]), 2), elg);	/* Q25 */
+      lgq_nh = L_add(L_shr(L_deposit_h(bv32fx_lgpecb_nh[gidx]), 2), elg);	/* Q25 */
       if(*lgq < ((Word32)MinE-(Word32)8192) && L_abs(L_sub(lgq_nh,((Word32)MinE-(Word32)8192))) < L_abs(L_sub(*lgq,((Word32)MinE-(Word32)8192)))){ 
          /* To avoid thresholding when the enc Q makes it below the threshold */
          *lgq = (Word32)MinE;
       }
    }
    
-   /* LOOK UP FROM lgclimit() TABLE THE MAXIMUM LOG GAIN CHANGE ALLOWED */
+   /* LOOK UP FROM bv32fx_lgclimit() TABLE THE MAXIMUM LOG GAIN CHANGE ALLOWED */
    i = shr(sub(shr(extract_h(L_sub(prevlg[0],level)),9),LGLB),1);   /* get column index */
    if (i >= NGB) {
       i = NGB - 1;
@@ -89,14 +91,14 @@ Word32 gaindec(			/* Q18 */
    
    
    /* CHECK WHETHER DECODED LOG-GAIN EXCEEDS LGCLIMIT */
-   if ((lgc > lgclimit[i]) && (gidx > 0) && lctimer == 0) { /* if decoded log-gain exceeds limit */
+   if ((lgc > bv32fx_lgclimit[i]) && (gidx > 0) && lctimer == 0) { /* if decoded log-gain exceeds limit */
       *lgq = prevlg[0];   /* use the log-gain of previous frame */
       lgpm[0] = extract_h(L_shl(L_sub(*lgq, elg), 2));
       *nclglim = *nclglim+1;
       if(*nclglim > NCLGLIM_TRAPPED)
          *nclglim = NCLGLIM_TRAPPED;
    } else {
-      lgpm[0] = lgpecb[gidx];
+      lgpm[0] = bv32fx_lgpecb[gidx];
       *nclglim = 0;
    }
    
@@ -108,6 +110,7 @@ Word32 gaindec(			/* Q18 */
    elg = L_shr(*lgq,10);		/* Q25 -> Q26 (0.5F) --> Q16 */
    L_Extract(elg, &lg_exp, &lg_frac);
    lg_exp = add(lg_exp, 18);			/* output to be Q2 */
+   WMOPS_LEAVE();
    return Pow2(lg_exp, lg_frac);
 }
 
@@ -117,6 +120,8 @@ void gainplc(Word32 E, Word16 *lgeqm, Word32 *lgqm)
    Word16 exponent, fraction, lge;
    Word32 lg, mrlg, elg;
    
+   WMOPS_ENTER("gainplc");
+   
    exponent = 1;
    fraction = 0;
    if (E > TMinlgXsfsz)
@@ -130,12 +135,12 @@ void gainplc(Word32 E, Word16 *lgeqm, Word32 *lgqm)
    else
       lg = 0;   /* Minlg */
    
-   mrlg = L_shr(L_deposit_h(lgmean),2); /* Q25 */
+   mrlg = L_shr(L_deposit_h(bv32fx_lgmean),2); /* Q25 */
    mrlg = L_sub(lg, mrlg);  /* Q25 */
    
    elg = 0;
    for(k=0; k<GPO; k++)
-      elg = L_mac0(elg, lgp[k], lgeqm[k]);  /* Q26 */
+      elg = L_mac0(elg, bv32fx_lgp[k], lgeqm[k]);  /* Q26 */
    
    elg = L_shr(elg,1);                    /* Q25 */
    
@@ -151,5 +156,6 @@ void gainplc(Word32 E, Word16 *lgeqm, Word32 *lgqm)
    lgqm[1] = lgqm[0];
    lgqm[0] = lg;
    
+   WMOPS_LEAVE();
    return;
 }
@@ -45,6 +45,8 @@ Word16 gainquan(
    Word16	lg_exp, lg_frac, lgpe, d, dmin;
    Word16  i, n, gidx=0, *p_gidx;
    
+   WMOPS_ENTER("gainquan");
+   
    /* DIVIDE ee by HFRSZ = 8*5 */
    if (ee < TMinE) lg = MinE;
    else {
@@ -57,9 +59,9 @@ Word16 gainquan(
    }
    
    /* CALCULATE ESTIMATED LOG-GAIN */
-   elg = L_shr(L_deposit_h(lgmean),1);			/* Q26 */
+   elg = L_shr(L_deposit_h(bv32fx_lgmean),1);			/* Q26 */
    for (i = 0; i < LGPORDER; i++) {
-      elg = L_mac0(elg, lgp[i],lgpm[i]);		/* Q26 */
+      elg = L_mac0(elg, bv32fx_lgp[i],lgpm[i]);		/* Q26 */
    }
    elg = L_shr(elg, 1);						/* Q25 */
    
@@ -68,9 +70,9 @@ Word16 gainquan(
    
    /* SCALAR QUANTIZATION OF LOG-GAIN PREDICTION ERROR */
    dmin = MAX_16;
-   p_gidx = idxord;
+   p_gidx = bv32fx_idxord;
    for (i = 0; i < LGPECBSZ; i++) {
-      d = abs_s(sub(lgpe, lgpecb[*p_gidx++]));
+      d = abs_s(sub(lgpe, bv32fx_lgpecb[*p_gidx++]));
       if (d < dmin) {
          dmin = d;
          gidx= i;
@@ -78,9 +80,9 @@ Word16 gainquan(
    }
    
    /* CALCULATE QUANTIZED LOG-GAIN */
-   lgq = L_add(L_shr(L_deposit_h(lgpecb[idxord[gidx]]),2),elg); /* Q25 */
+   lgq = L_add(L_shr(L_deposit_h(bv32fx_lgpecb[bv32fx_idxord[gidx]]),2),elg); /* Q25 */
    
-   /* LOOK UP FROM lgclimit() TABLE THE MAXIMUM LOG GAIN CHANGE ALLOWED */
+   /* LOOK UP FROM bv32fx_lgclimit() TABLE THE MAXIMUM LOG GAIN CHANGE ALLOWED */
    i = shr(sub(shr(extract_h(L_sub(prevlg[0],level)),9),LGLB),1);   /* get column index */
    if (i >= NGB) {
       i = NGB - 1;
@@ -96,14 +98,14 @@ Word16 gainquan(
    i = i * NGCB + n;
    
    /* CHECK WHETHER QUANTIZED LOG-GAIN CAUSE A GAIN CHANGE > LGCLIMIT */
-   limit = L_add(prevlg[0],L_deposit_h(lgclimit[i])); /* limit log-gain */
+   limit = L_add(prevlg[0],L_deposit_h(bv32fx_lgclimit[i])); /* limit log-gain */
    while ((lgq > limit) && (gidx > 0) ) { /* if q log-gain exceeds limit */
       gidx -= 1;     /* decrement gain quantizer index by 1 */
-      lgq = L_add(L_shr(L_deposit_h(lgpecb[idxord[gidx]]),2),elg);
+      lgq = L_add(L_shr(L_deposit_h(bv32fx_lgpecb[bv32fx_idxord[gidx]]),2),elg);
    }
    
    /* get true codebook index */
-   gidx = idxord[gidx];
+   gidx = bv32fx_idxord[gidx];
    
    /* UPDATE LOG-GAIN PREDICTOR MEMORY */
    prevlg[1] = prevlg[0];
@@ -111,7 +113,7 @@ Word16 gainquan(
    for (i = LGPORDER - 1; i > 0; i--) {
       lgpm[i] = lgpm[i-1];
    }
-   lgpm[0] = lgpecb[gidx];
+   lgpm[0] = bv32fx_lgpecb[gidx];
    
    /* CONVERT QUANTIZED LOG-GAIN TO LINEAR DOMAIN */
    elg = L_shr(lgq,10);		/* Q25 -> Q26 (0.5F) --> Q16 */
@@ -119,5 +121,6 @@ Word16 gainquan(
    lg_exp = add(lg_exp, 18);			/* output to be Q2 */
    *gainq = Pow2(lg_exp, lg_frac);
    
+   WMOPS_LEAVE();
    return gidx;
 }
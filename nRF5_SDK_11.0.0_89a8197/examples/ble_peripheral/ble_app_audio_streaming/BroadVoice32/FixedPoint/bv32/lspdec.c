@@ -44,8 +44,10 @@ void lspdec(
    Word16 elsp[LPCO], lspe[LPCO]; 
    Word16 lspeq1[LPCO], lspeq2[LPCO];
    
+   WMOPS_ENTER("lspdec");
+   
    /* CALCULATE ESTIMATED (MA-PREDICTED) LSP VECTOR */
-   fp1 = lspp;		/* Q14 */
+   fp1 = bv32fx_lspp;		/* Q14 */
    fp2 = lsppm;	/* Q15 */
    for (i = 0; i < LPCO; i++) {
       a0 = 0;
@@ -56,11 +58,11 @@ void lspdec(
    }
    
    /* PERFORM FIRST-STAGE VQ CODEBOOK DECODE */
-   vqdec(lspeq1,lspidx[0],lspecb1,LPCO);	/* lspeq1 is Q16 */ 
+   vqdec(lspeq1,lspidx[0],bv32fx_lspecb1,LPCO);	/* lspeq1 is Q16 */ 
    
    /* PERFORM SECOND-STAGE VQ CODEBOOK DECODE */
-   vqdec(lspeq2,lspidx[1],lspecb21,SVD1);
-   vqdec(lspeq2+SVD1,lspidx[2],lspecb22,SVD2);	/* lspeq2 is Q19 */
+   vqdec(lspeq2,lspidx[1],bv32fx_lspecb21,SVD1);
+   vqdec(lspeq2+SVD1,lspidx[2],bv32fx_lspecb22,SVD2);	/* lspeq2 is Q19 */
    
    /* ENFORCE BIT_EXACT AS IN lspquan.c V1.10 */
    for (i=0;i<LPCO;i++) lspeq2[i] = shr(lspeq2[i], 1);
@@ -71,7 +73,7 @@ void lspdec(
       lspe[i] = (Word16) L_shr(L_add(				/* rounding */
          L_shl(L_deposit_l(lspeq1[i]),3),
          L_shl(L_deposit_l(lspeq2[i]),1) ), 4);
-      lspq[i] = add(add(lspe[i],elsp[i]),lspmean[i]);
+      lspq[i] = add(add(lspe[i],elsp[i]),bv32fx_lspmean[i]);
    }
    
    /* detect bit-errors based on ordering property */
@@ -85,7 +87,7 @@ void lspdec(
    if (lspdordr) {
       for (i=0; i<LPCO; i++){
          lspq[i] = lspq_last[i];
-         lspe[i] = sub(sub(lspq[i],elsp[i]),lspmean[i]);
+         lspe[i] = sub(sub(lspq[i],elsp[i]),bv32fx_lspmean[i]);
       }
    }
    
@@ -102,8 +104,9 @@ void lspdec(
    }
    
    /* ENSURE CORRECT ORDERING OF LSP TO GUARANTEE LPC FILTER STABILITY */
-   stblz_lsp(lspq, LPCO);
+   bv32fx_stblz_lsp(lspq, LPCO);
    
+   WMOPS_LEAVE();
 }
 
 void lspplc(
@@ -115,8 +118,10 @@ void lspplc(
    Word16  i, k;
    Word16 elsp[LPCO];
    
+   WMOPS_ENTER("lspplc");
+   
    /* CALCULATE ESTIMATED (MA-PREDICTED) LSP VECTOR */
-   fp1 = lspp;		/* Q14 */
+   fp1 = bv32fx_lspp;		/* Q14 */
    fp2 = lsppm;	/* Q15 */
    for (i = 0; i < LPCO; i++) {
       a0 = 0;
@@ -135,8 +140,9 @@ void lspplc(
       for (k = LSPPORDER; k > 1; k--) {
          *fp1-- = *fp2--;
       }
-      *fp1-- = sub(sub(lspq[i],lspmean[i]),elsp[i]);
+      *fp1-- = sub(sub(lspq[i],bv32fx_lspmean[i]),elsp[i]);
       fp2--;
    }
    
+   WMOPS_LEAVE();
 }
@@ -32,12 +32,16 @@
 #include "bv32strct.h"
 #include "bv32externs.h"
 #include "basop32.h"
+#include "simdop.h"
 
 void vqmse(
            Word16  *xq,
            Word16  *idx,
            Word16  *x,
            Word16  *cb,
+           Word16  *ord,
+           Word16  *dim,
+           Word16  nvis,
            Word16  vdim,
            Word16  cbsz);
 
@@ -64,7 +68,8 @@ void lspquan(
              Word16  *lspq, 		/* Q15 */ 
              Word16  *lspidx,  
              Word16  *lsp,    	/* Q15 */ 
-             Word16  *lsppm)		/* Q15 */
+             Word16  *lsppm,		/* Q15 */
+             Word16  ncb1)		/* bv32fx_lspecb1[] codevectors to search */
 {
    Word32 a0;
    Word16 min_d;
@@ -74,6 +79,8 @@ void lspquan(
    Word16 elsp[LPCO], lspe[LPCO]; 
    Word16 lspeq1[LPCO], lspeq2[LPCO];
    Word16 lspa[LPCO];
+   
+   WMOPS_ENTER("lspquan");
   
    /* CALCULATE THE WEIGHTS FOR WEIGHTED MEAN-SQUARE ERROR DISTORTION */
    min_d = MAX_16;
@@ -92,7 +99,7 @@ void lspquan(
    w[LPCO-1] = div_s(min_d, d[LPCO-2]);
    
    /* CALCULATE ESTIMATED (MA-PREDICTED) LSP VECTOR */
-   fp1 = lspp;		/* Q14 */
+   fp1 = bv32fx_lspp;		/* Q14 */
    fp2 = lsppm;	/* Q15 */
    for (i = 0; i < LPCO; i++) {
       a0 = 0;
@@ -104,11 +111,11 @@ void lspquan(
    
    /* SUBTRACT LSP MEAN VALUE & ESTIMATED LSP TO GET PREDICTION ERROR */
    for (i = 0; i < LPCO; i++) {
-      lspe[i] = shl(sub(sub(lsp[i],lspmean[i]),elsp[i]),1);	/* Q15 -> Q16 */
+      lspe[i] = shl(sub(sub(lsp[i],bv32fx_lspmean[i]),elsp[i]),1);	/* Q15 -> Q16 */
    }
    
    /* PERFORM FIRST-STAGE VQ CODEBOOK SEARCH, MSE VQ */
-   vqmse(lspeq1,lspidx,lspe,lspecb1,LPCO,LSPECBSZ1);
+   vqmse(lspeq1,lspidx,lspe,bv32fx_lspecb1,lspecb1_ord,lspecb1_dim,ncb1,LPCO,LSPECBSZ1);
    
    /* CALCULATE QUANTIZATION ERROR VECTOR OF FIRST-STAGE VQ */
    for (i = 0; i < LPCO; i++) {
@@ -117,11 +124,11 @@ void lspquan(
    
    /* PERFORM SECOND-STAGE VQ CODEBOOK SEARCH */
    for (i = 0; i < SVD1; i++)
-      lspa[i] = add(add(shr(lspeq1[i],1),elsp[i]),lspmean[i]); 	/* Q15 */
+      lspa[i] = add(add(shr(lspeq1[i],1),elsp[i]),bv32fx_lspmean[i]); 	/* Q15 */
    
-   vqwmse_stbl(lspeq2,lspidx+1,lspe,w,lspa,lspecb21,SVD1,LSPECBSZ21);
+   vqwmse_stbl(lspeq2,lspidx+1,lspe,w,lspa,bv32fx_lspecb21,SVD1,LSPECBSZ21);
    
-   vqwmse(lspeq2+SVD1,lspidx+2,lspe+SVD1,w+SVD1,lspecb22,SVD2,LSPECBSZ22);
+   vqwmse(lspeq2+SVD1,lspidx+2,lspe+SVD1,w+SVD1,bv32fx_lspecb22,SVD2,LSPECBSZ22);
    
    /* GET OVERALL QUANTIZER OUTPUT VECTOR OF THE TWO-STAGE VQ */
    for (i = 0; i < LPCO; i++) {
@@ -144,11 +151,12 @@ void lspquan(
    
    /* CALCULATE QUANTIZED LSP */
    for (i = 0; i < LPCO; i++) {
-      lspq[i] = add(add(lspe[i],elsp[i]),lspmean[i]);
+      lspq[i] = add(add(lspe[i],elsp[i]),bv32fx_lspmean[i]);
    }
    
    /* ENSURE CORRECT ORDERING OF LSP TO GUARANTEE LPC FILTER STABILITY */
-   stblz_lsp(lspq,LPCO);
+   bv32fx_stblz_lsp(lspq,LPCO);
+   WMOPS_LEAVE();
 }
 
 /*==========================================================================*/
@@ -166,16 +174,29 @@ void vqwmse(
    Word32 	dmin, d;
    Word16 	*fp1, t, s;
    Word16 	j, k;
+#if SIMDOP
+   Word32   dist[LSPECBSZ1];
+   Word16   simd;
+   
+   simd = (cbsz <= LSPECBSZ1) && simd_vqwmse_dist(dist, x, w, cb, vdim, cbsz);
+#endif
    
    fp1 = cb;
    dmin = MAX_32;
    for (j = 0; j < cbsz; j++) {
       d = 0;
+#if SIMDOP
+      if (simd)
+         d = dist[j];
+      else
+#endif
       for (k = 0; k < vdim; k++) {
-         t = sub(x[k],shr(*fp1++,1));
+         t = sub(x[k],shr(fp1[k],1));
          s = extract_h(L_mult0(w[k],t));
          d = L_mac0(d, s, t);
+         if (d >= dmin) break;	/* the terms are >= 0 */
       }
+      fp1 += vdim;
       if (d < dmin) {
          dmin = d;
          *idx = j;
@@ -202,6 +223,12 @@ void vqwmse_stbl(
    Word16 *fp1, *fp2;
    Word16 j, k, stbl, s, t;
    Word16 xqc[LPCO];
+#if SIMDOP
+   Word32 dist[LSPECBSZ1];
+   Word16 simd;
+   
+   simd = (cbsz <= LSPECBSZ1) && simd_vqwmse_dist(dist, x, w, cb, vdim, cbsz);
+#endif
    
    fp1     = cb;
    dmin    = MAX_32;
@@ -219,21 +246,28 @@ void vqwmse_stbl(
          if(xqc[k] < xqc[k-1]) stbl = 0;
       }
       
-      /* calculate distortion */
-      d = 0;
-      for (k=0; k<vdim; k++){
-         t = sub(x[k],shr(*fp1++,1));
-         s = extract_h(L_mult0(w[k],t));
-         d = L_mac0(d, s, t);
-      }
-      
-      /* update matches */
-      if (stbl > 0){
+      /* calculate distortion of the stable candidates */
+      if (stbl > 0) {
+         d = 0;
+#if SIMDOP
+         if (simd)
+            d = dist[j];
+         else
+#endif
+         for (k=0; k<vdim; k++){
+            t = sub(x[k],shr(fp1[k],1));
+            s = extract_h(L_mult0(w[k],t));
+            d = L_mac0(d, s, t);
+            if (d >= dmin) break;	/* the terms are >= 0 */
+         }
+         
+         /* update matches */
          if (d < dmin) {
             dmin = d;
             *idx = j;
          }
       }
+      fp1 += vdim;
    }	/* end of j-loop */
    
    if(*idx == -1){
@@ -250,32 +284,94 @@ void vqmse(
            Word16  *idx,   /* VQ codebook index for the nearest neighbor */
            Word16  *x,     /* Q16 input vector */
            Word16  *cb,    /* VQ codebook */
+           Word16  *ord,   /* codevectors in ascending order of component dim[0] */
+           Word16  *dim,   /* components in the order they are summed */
+           Word16  nvis,   /* codevectors to visit at most; cbsz: exhaustive */
            Word16	vdim,   /* vector dimension */
            Word16	cbsz)   /* codebook size (number of codevectors) */
 {
    
-   Word32 	dmin, d;
+   Word32 	dmin, d, dl, dh;
    Word16 	*fp1;
-   Word16 	j, k;
+   Word16 	j, k, lo, hi, xk;
    
    Word16 e;
+#if SIMDOP
+   Word32   dist[LSPECBSZ1];
+   Word16   simd;
    
-   fp1 = cb;
-   dmin = MAX_32;
-   for (j = 0; j < cbsz; j++) {
-      d = 0;
-      for (k = 0; k < vdim; k++) {
-         e = sub(x[k], *fp1++);     // Q17
-         d = L_mac0(d, e, e);       // Q34
+   simd = (nvis >= cbsz) && (cbsz <= LSPECBSZ1) && simd_vqmse_dist(dist, x, cb, vdim, cbsz);
+   if (simd) {
+      dmin = MAX_32;
+      for (j = 0; j < cbsz; j++) {
+         if (L_sub(dist[j], dmin) < 0) {
+            dmin = dist[j];
+            *idx = j;
+         }
       }
-      if (L_sub(d, dmin) < 0) {
-         dmin = d;
-         *idx = j;
+   }
+   else
+#endif
+   {
+      /* Start from the codevectors nearest x in component dim[0] and    */
+      /* work outwards both ways. The squared error in that component    */
+      /* grows as we go and bounds the distortion from below, so a side  */
+      /* is done once it exceeds dmin; and as all the terms are >= 0, a  */
+      /* codevector is dropped once its partial sum does. Of equal        */
+      /* distortions the lowest index wins, as in a search in index order. */
+      /* With nvis < cbsz only the nvis nearest in dim[0] are tried       */
+      xk = x[dim[0]];
+      lo = 0;
+      hi = cbsz;
+      while (lo < hi) {
+         k = shr(add(lo, hi), 1);
+         if (cb[ord[k]*vdim+dim[0]] < xk) lo = k + 1;
+         else hi = k;
+      }
+      lo = hi - 1;
+      
+      dmin = MAX_32;
+      *idx = cbsz;
+      dl = dh = MAX_32;
+      for (; nvis > 0; nvis--) {
+         if (lo >= 0) {
+            e = sub(xk, cb[ord[lo]*vdim+dim[0]]);
+            dl = L_mult0(e, e);
+            if (dl > dmin) lo = -1;
+         }
+         if (hi < cbsz) {
+            e = sub(xk, cb[ord[hi]*vdim+dim[0]]);
+            dh = L_mult0(e, e);
+            if (dh > dmin) hi = cbsz;
+         }
+         if (lo < 0) {
+            if (hi >= cbsz) break;
+            j = ord[hi++];
+            d = dh;
+         }
+         else if (hi >= cbsz || dl <= dh) {
+            j = ord[lo--];
+            d = dl;
+         }
+         else {
+            j = ord[hi++];
+            d = dh;
+         }
+         
+         fp1 = cb + j*vdim;
+         for (k = 1; k < vdim; k++) {
+            if (d > dmin) break;
+            e = sub(x[dim[k]], fp1[dim[k]]);     // Q17
+            d = L_mac0(d, e, e);                 // Q34
+         }
+         if ((d < dmin) || ((d == dmin) && (j < *idx))) {
+            dmin = d;
+            *idx = j;
+         }
       }
    }
    j = *idx * vdim;
    for (k = 0; k < vdim; k++) {
       xq[k] = cb[j + k];
    }
-}  
-
+}
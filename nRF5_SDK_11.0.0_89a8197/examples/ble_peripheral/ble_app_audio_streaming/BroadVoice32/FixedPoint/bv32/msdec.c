@@ -0,0 +1,358 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  msdec.c : BV32 multi-stream decoder
+
+  Locking: a stream's lock covers its frame queue and its queued flag, a
+  worker's lock covers its queue of streams, and the decoder lock covers
+  the counters the threads sleep on. No two are held at once. A stream
+  is put on a worker queue only by whoever sets its queued flag, and
+  only the worker that takes it off touches its decoder state, which
+  keeps its frames in order.
+
+  A worker serves its own queue from the front and steals from the back
+  of the others, where the streams queued last are.
+
+  $Log$
+******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "typedef.h"
+#include "bvcommon.h"
+#include "bv32cnst.h"
+#include "bv32strct.h"
+#include "bv32.h"
+#include "bitpack.h"
+#include "msdec.h"
+
+struct MSD_Stream {
+   struct BV32_Decoder_State ds;
+   pthread_mutex_t lock;
+   UWord8   *q;              /* nqueue packed frames */
+   UWord8   *bfi;            /* their erasure flags */
+   long     head, tail;      /* frames taken out, frames put in */
+   int      queued;          /* on a worker queue or being decoded */
+};
+
+struct MSD_Worker {
+   struct BV32_MSDec *msd;
+   pthread_t thread;
+   pthread_mutex_t lock;
+   int      *q;              /* streams, a ring of nstreams */
+   int      head, n;
+   int      id;
+   Word16   *pcm;            /* batch*FRSZ */
+   long     frames, batches, steals;
+};
+
+struct BV32_MSDec {
+   int      nstreams, nthreads, nqueue, batch;
+   BV32_MSDec_Sink sink;
+   void     *ctx;
+   struct MSD_Stream *s;
+   struct MSD_Worker *w;
+   pthread_mutex_t lock;
+   pthread_cond_t work;      /* a stream was queued, or quit */
+   pthread_cond_t done;      /* pending reached 0 */
+   long     queued;          /* streams on worker queues */
+   long     pending;         /* frames pushed and not yet decoded */
+   int      quit;
+   int      started;         /* worker threads running */
+};
+
+static void put(struct MSD_Worker *w, int s)
+{
+   struct BV32_MSDec *msd = w->msd;
+
+   pthread_mutex_lock(&w->lock);
+   w->q[(w->head + w->n) % msd->nstreams] = s;
+   w->n++;
+   pthread_mutex_unlock(&w->lock);
+
+   pthread_mutex_lock(&msd->lock);
+   msd->queued++;
+   pthread_cond_signal(&msd->work);
+   pthread_mutex_unlock(&msd->lock);
+}
+
+/* front of the queue for its owner, back for a thief; -1 if empty */
+static int take(struct MSD_Worker *w, int back)
+{
+   int s = -1;
+
+   pthread_mutex_lock(&w->lock);
+   if (w->n > 0) {
+      w->n--;
+      if (back)
+         s = w->q[(w->head + w->n) % w->msd->nstreams];
+      else {
+         s = w->q[w->head];
+         w->head = (w->head + 1) % w->msd->nstreams;
+      }
+   }
+   pthread_mutex_unlock(&w->lock);
+   return s;
+}
+
+static void run(struct MSD_Worker *w, int s, int stolen)
+{
+   struct BV32_MSDec *msd = w->msd;
+   struct MSD_Stream *st = &msd->s[s];
+   long first;
+   int i, n, m, more;
+
+   pthread_mutex_lock(&st->lock);
+   first = st->head;
+   n = (int)(st->tail - st->head);
+   pthread_mutex_unlock(&st->lock);
+   if (n > msd->batch)
+      n = msd->batch;
+
+   /* the pusher only writes past tail, so these frames stay put; */
+   /* they are decoded in at most two runs, split where q wraps     */
+   for (i = 0; i < n; i += m) {
+      m = msd->nqueue - (int)((first + i) % msd->nqueue);
+      if (m > n - i)
+         m = n - i;
+      BV32_DecodeFrames(st->q + ((first + i) % msd->nqueue) * BV32_PACKED_BYTES,
+         st->bfi + (first + i) % msd->nqueue, m, &st->ds, w->pcm + i*FRSZ);
+   }
+   if (msd->sink)
+      msd->sink(msd->ctx, s, w->pcm, n);
+
+   pthread_mutex_lock(&st->lock);
+   st->head += n;
+   more = (st->tail != st->head);
+   if (!more)
+      st->queued = 0;
+   pthread_mutex_unlock(&st->lock);
+   if (more)
+      put(w, s);
+
+   pthread_mutex_lock(&msd->lock);
+   w->frames += n;
+   w->batches++;
+   w->steals += stolen;
+   msd->pending -= n;
+   if (msd->pending == 0)
+      pthread_cond_broadcast(&msd->done);
+   pthread_mutex_unlock(&msd->lock);
+}
+
+static void *worker(void *arg)
+{
+   struct MSD_Worker *w = (struct MSD_Worker *)arg;
+   struct BV32_MSDec *msd = w->msd;
+   int k, s, stolen;
+
+   while (1) {
+      stolen = 0;
+      s = take(w, 0);
+      for (k = 1; s < 0 && k < msd->nthreads; k++) {
+         s = take(&msd->w[(w->id + k) % msd->nthreads], 1);
+         stolen = 1;
+      }
+
+      pthread_mutex_lock(&msd->lock);
+      if (s >= 0)
+         msd->queued--;
+      else {
+         while (!msd->quit && msd->queued == 0)
+            pthread_cond_wait(&msd->work, &msd->lock);
+      }
+      k = msd->quit;
+      pthread_mutex_unlock(&msd->lock);
+
+      if (k)
+         break;
+      if (s >= 0)
+         run(w, s, stolen);
+   }
+   return NULL;
+}
+
+struct BV32_MSDec *BV32_MSDec_Open(
+int    nstreams,
+int    nthreads,
+int    nqueue,
+int    batch,
+BV32_MSDec_Sink sink,
+void   *ctx)
+{
+   struct BV32_MSDec *msd;
+   int i;
+
+   if (nstreams < 1 || nthreads < 1 || nqueue < 1 || batch < 1)
+      return NULL;
+   if (!(msd = (struct BV32_MSDec *)calloc(1, sizeof(*msd))))
+      return NULL;
+   msd->nstreams = nstreams;
+   msd->nthreads = nthreads;
+   msd->nqueue = nqueue;
+   msd->batch = batch;
+   msd->sink = sink;
+   msd->ctx = ctx;
+   pthread_mutex_init(&msd->lock, NULL);
+   pthread_cond_init(&msd->work, NULL);
+   pthread_cond_init(&msd->done, NULL);
+
+   msd->s = (struct MSD_Stream *)calloc(nstreams, sizeof(struct MSD_Stream));
+   msd->w = (struct MSD_Worker *)calloc(nthreads, sizeof(struct MSD_Worker));
+   if (!msd->s || !msd->w) {
+      free(msd->s);
+      free(msd->w);
+      msd->s = NULL;
+      msd->w = NULL;
+      BV32_MSDec_Close(msd);
+      return NULL;
+   }
+   for (i = 0; i < nstreams; i++) {
+      Reset_BV32_Decoder(&msd->s[i].ds);
+      pthread_mutex_init(&msd->s[i].lock, NULL);
+   }
+   for (i = 0; i < nthreads; i++) {
+      msd->w[i].msd = msd;
+      msd->w[i].id = i;
+      pthread_mutex_init(&msd->w[i].lock, NULL);
+   }
+   for (i = 0; i < nstreams; i++) {
+      msd->s[i].q = (UWord8 *)malloc(nqueue * BV32_PACKED_BYTES);
+      msd->s[i].bfi = (UWord8 *)malloc(nqueue);
+      if (!msd->s[i].q || !msd->s[i].bfi) {
+         BV32_MSDec_Close(msd);
+         return NULL;
+      }
+   }
+   for (i = 0; i < nthreads; i++) {
+      msd->w[i].q = (int *)malloc(nstreams * sizeof(int));
+      msd->w[i].pcm = (Word16 *)malloc(batch * FRSZ * sizeof(Word16));
+      if (!msd->w[i].q || !msd->w[i].pcm) {
+         BV32_MSDec_Close(msd);
+         return NULL;
+      }
+   }
+   for (i = 0; i < nthreads; i++) {
+      if (pthread_create(&msd->w[i].thread, NULL, worker, &msd->w[i])) {
+         BV32_MSDec_Close(msd);
+         return NULL;
+      }
+      msd->started++;
+   }
+   return msd;
+}
+
+int BV32_MSDec_Push(
+struct BV32_MSDec *msd,
+int    stream,
+UWord8 *frames,
+UWord8 *bfi,
+int    nframes)
+{
+   struct MSD_Stream *st = &msd->s[stream];
+   long room, k;
+   int i, sched;
+
+   pthread_mutex_lock(&st->lock);
+   room = msd->nqueue - (st->tail - st->head);
+   if (nframes > room)
+      nframes = (int)room;
+   for (i = 0; i < nframes; i++) {
+      k = (st->tail + i) % msd->nqueue;
+      memcpy(st->q + k*BV32_PACKED_BYTES, frames + i*BV32_PACKED_BYTES, BV32_PACKED_BYTES);
+      st->bfi[k] = bfi ? bfi[i] : 0;
+   }
+   st->tail += nframes;
+   sched = (nframes > 0 && !st->queued);
+   if (sched)
+      st->queued = 1;
+   pthread_mutex_unlock(&st->lock);
+
+   if (nframes > 0) {
+      pthread_mutex_lock(&msd->lock);
+      msd->pending += nframes;
+      pthread_mutex_unlock(&msd->lock);
+   }
+   /* a stream is always queued on the same worker, unless stolen */
+   if (sched)
+      put(&msd->w[stream % msd->nthreads], stream);
+   return nframes;
+}
+
+void BV32_MSDec_Wait(
+struct BV32_MSDec *msd)
+{
+   pthread_mutex_lock(&msd->lock);
+   while (msd->pending > 0)
+      pthread_cond_wait(&msd->done, &msd->lock);
+   pthread_mutex_unlock(&msd->lock);
+}
+
+void BV32_MSDec_Stats(
+struct BV32_MSDec *msd,
+struct BV32_MSDec_Stats *st)
+{
+   int i;
+
+   memset(st, 0, sizeof(*st));
+   pthread_mutex_lock(&msd->lock);
+   for (i = 0; i < msd->nthreads; i++) {
+      st->frames += msd->w[i].frames;
+      st->batches += msd->w[i].batches;
+      st->steals += msd->w[i].steals;
+   }
+   pthread_mutex_unlock(&msd->lock);
+}
+
+/* frames still queued are dropped */
+void BV32_MSDec_Close(
+struct BV32_MSDec *msd)
+{
+   int i;
+
+   pthread_mutex_lock(&msd->lock);
+   msd->quit = 1;
+   pthread_cond_broadcast(&msd->work);
+   pthread_mutex_unlock(&msd->lock);
+   for (i = 0; i < msd->started; i++)
+      pthread_join(msd->w[i].thread, NULL);
+
+   if (msd->w)
+      for (i = 0; i < msd->nthreads; i++) {
+         free(msd->w[i].q);
+         free(msd->w[i].pcm);
+         pthread_mutex_destroy(&msd->w[i].lock);
+      }
+   if (msd->s)
+      for (i = 0; i < msd->nstreams; i++) {
+         free(msd->s[i].q);
+         free(msd->s[i].bfi);
+         pthread_mutex_destroy(&msd->s[i].lock);
+      }
+   free(msd->w);
+   free(msd->s);
+   pthread_mutex_destroy(&msd->lock);
+   pthread_cond_destroy(&msd->work);
+   pthread_cond_destroy(&msd->done);
+   free(msd);
+}
@@ -0,0 +1,85 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  msdec.h : BV32 multi-stream decoder
+
+  Decodes many independent BV32 streams on a pool of POSIX threads. Each
+  stream has its own decoder state and a queue of packed 20-byte frames
+  (the bv32fx_BitUnPack format), any of which may be marked as lost. A
+  stream with frames waiting is queued on one worker at a time, so its
+  frames are decoded in order; the worker takes up to a batch of them in
+  one go, to keep the decoder state in its cache. Each worker has its own
+  queue of streams, and an idle worker steals from the others.
+
+  Decoded frames are handed to a sink function, called from the worker
+  threads. Calls for one stream never overlap and come in frame order.
+
+  $Log$
+******************************************************************************/
+
+#ifndef MSDEC_H
+#define MSDEC_H
+
+struct BV32_MSDec;
+
+typedef void (*BV32_MSDec_Sink)(
+void   *ctx,
+int    stream,
+Word16 *pcm,                 /* nframes*FRSZ samples */
+int    nframes);
+
+struct BV32_MSDec_Stats {
+   long  frames;             /* frames decoded */
+   long  batches;            /* stream batches run */
+   long  steals;             /* batches taken from another worker's queue */
+};
+
+/* nqueue is the largest number of undecoded frames a stream can hold */
+extern struct BV32_MSDec *BV32_MSDec_Open(
+int    nstreams,
+int    nthreads,
+int    nqueue,
+int    batch,
+BV32_MSDec_Sink sink,
+void   *ctx);
+
+/* queue up to nframes packed frames, those with a nonzero bfi[] */
+/* entry (bfi may be NULL) to be concealed; returns the number taken */
+extern int BV32_MSDec_Push(
+struct BV32_MSDec *msd,
+int    stream,
+UWord8 *frames,
+UWord8 *bfi,
+int    nframes);
+
+/* wait until every frame pushed so far has been decoded */
+extern void BV32_MSDec_Wait(
+struct BV32_MSDec *msd);
+
+extern void BV32_MSDec_Stats(
+struct BV32_MSDec *msd,
+struct BV32_MSDec_Stats *st);
+
+extern void BV32_MSDec_Close(
+struct BV32_MSDec *msd);
+
+#endif
@@ -0,0 +1,191 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  pipedec.c : BV32 two-stage pipelined decoder
+
+  The queue holds decoded frames from head to tail. The pushing thread
+  only writes the slot at tail and the worker only reads those before
+  it, and each moves its end under the lock, so the slots need no lock
+  of their own. The stages use separate parts of the decoder state,
+  except in BV32_PLC, which runs only while the pushing thread waits.
+
+  $Log$
+******************************************************************************/
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "typedef.h"
+#include "bvcommon.h"
+#include "bv32cnst.h"
+#include "bv32strct.h"
+#include "bv32.h"
+#include "bitpack.h"
+#include "pipedec.h"
+
+struct PD_Slot {
+   struct BV32_Frame_Params fp;
+   int      lost;
+};
+
+struct BV32_PipeDec {
+   struct BV32_Decoder_State ds;
+   int      nqueue;
+   BV32_PipeDec_Sink sink;
+   void     *ctx;
+   struct PD_Slot *q;
+   Word16   *pcm;            /* nqueue*FRSZ */
+   long     head, tail;      /* frames synthesized, frames decoded */
+   pthread_t thread;
+   pthread_mutex_t lock;
+   pthread_cond_t more;      /* tail moved, or quit */
+   pthread_cond_t room;      /* head moved */
+   int      quit;
+   int      started;
+};
+
+static void *worker(void *arg)
+{
+   struct BV32_PipeDec *pd = (struct BV32_PipeDec *)arg;
+   struct PD_Slot *sl;
+   long     first;
+   int      i, n;
+
+   while (1) {
+      pthread_mutex_lock(&pd->lock);
+      while (!pd->quit && pd->tail == pd->head)
+         pthread_cond_wait(&pd->more, &pd->lock);
+      first = pd->head;
+      n = (int)(pd->tail - pd->head);
+      i = pd->quit;
+      pthread_mutex_unlock(&pd->lock);
+      if (i)
+         break;
+
+      for (i = 0; i < n; i++) {
+         sl = &pd->q[(first + i) % pd->nqueue];
+         if (sl->lost)
+            BV32_PLC(&pd->ds, pd->pcm + i*FRSZ);
+         else
+            BV32_Synthesize(&sl->fp, &pd->ds, pd->pcm + i*FRSZ);
+      }
+      if (pd->sink)
+         pd->sink(pd->ctx, pd->pcm, n);
+
+      pthread_mutex_lock(&pd->lock);
+      pd->head += n;
+      pthread_cond_broadcast(&pd->room);
+      pthread_mutex_unlock(&pd->lock);
+   }
+   return NULL;
+}
+
+struct BV32_PipeDec *BV32_PipeDec_Open(
+int    nqueue,
+BV32_PipeDec_Sink sink,
+void   *ctx)
+{
+   struct BV32_PipeDec *pd;
+
+   if (nqueue < 1)
+      return NULL;
+   if (!(pd = (struct BV32_PipeDec *)calloc(1, sizeof(*pd))))
+      return NULL;
+   pd->nqueue = nqueue;
+   pd->sink = sink;
+   pd->ctx = ctx;
+   Reset_BV32_Decoder(&pd->ds);
+   pthread_mutex_init(&pd->lock, NULL);
+   pthread_cond_init(&pd->more, NULL);
+   pthread_cond_init(&pd->room, NULL);
+
+   pd->q = (struct PD_Slot *)malloc(nqueue * sizeof(struct PD_Slot));
+   pd->pcm = (Word16 *)malloc(nqueue * FRSZ * sizeof(Word16));
+   if (!pd->q || !pd->pcm || pthread_create(&pd->thread, NULL, worker, pd)) {
+      BV32_PipeDec_Close(pd);
+      return NULL;
+   }
+   pd->started = 1;
+   return pd;
+}
+
+void BV32_PipeDec_Push(
+struct BV32_PipeDec *pd,
+UWord8 *frames,
+UWord8 *bfi,
+int    nframes)
+{
+   struct BV32_Bit_Stream bs;
+   struct PD_Slot *sl;
+   long     tail;
+   int      i;
+
+   for (i = 0; i < nframes; i++) {
+      pthread_mutex_lock(&pd->lock);
+      while (pd->tail - pd->head >= pd->nqueue)
+         pthread_cond_wait(&pd->room, &pd->lock);
+      tail = pd->tail;
+      pthread_mutex_unlock(&pd->lock);
+
+      sl = &pd->q[tail % pd->nqueue];
+      sl->lost = (bfi && bfi[i]);
+      if (!sl->lost) {
+         bv32fx_BitUnPack(frames + i*BV32_PACKED_BYTES, &bs);
+         BV32_DecodeParams(&bs, &pd->ds, &sl->fp);
+      }
+
+      pthread_mutex_lock(&pd->lock);
+      pd->tail++;
+      pthread_cond_signal(&pd->more);
+      /* BV32_PLC updates the parameter state too: wait for it */
+      if (sl->lost)
+         while (pd->head != pd->tail)
+            pthread_cond_wait(&pd->room, &pd->lock);
+      pthread_mutex_unlock(&pd->lock);
+   }
+}
+
+void BV32_PipeDec_Wait(
+struct BV32_PipeDec *pd)
+{
+   pthread_mutex_lock(&pd->lock);
+   while (pd->head != pd->tail)
+      pthread_cond_wait(&pd->room, &pd->lock);
+   pthread_mutex_unlock(&pd->lock);
+}
+
+void BV32_PipeDec_Close(
+struct BV32_PipeDec *pd)
+{
+   pthread_mutex_lock(&pd->lock);
+   pd->quit = 1;
+   pthread_cond_signal(&pd->more);
+   pthread_mutex_unlock(&pd->lock);
+   if (pd->started)
+      pthread_join(pd->thread, NULL);
+
+   free(pd->q);
+   free(pd->pcm);
+   pthread_mutex_destroy(&pd->lock);
+   pthread_cond_destroy(&pd->more);
+   pthread_cond_destroy(&pd->room);
+   free(pd);
+}
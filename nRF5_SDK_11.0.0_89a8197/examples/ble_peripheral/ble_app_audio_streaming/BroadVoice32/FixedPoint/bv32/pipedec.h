@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  pipedec.h : BV32 two-stage pipelined decoder
+
+  Decodes one BV32 stream in two stages on two threads. The thread that
+  pushes the packed frames decodes their parameters (BV32_DecodeParams)
+  into a queue, from which a worker thread synthesizes the speech
+  (BV32_Synthesize), so frame n+1 is unpacked and decoded while frame n
+  is synthesized. A lost frame is a barrier: BV32_PLC needs the state
+  of both stages, so the push waits for the worker to conceal it before
+  it decodes the next frame.
+
+  Decoded frames are handed to a sink function, called from the worker
+  thread in frame order.
+
+  $Log$
+******************************************************************************/
+
+#ifndef PIPEDEC_H
+#define PIPEDEC_H
+
+struct BV32_PipeDec;
+
+typedef void (*BV32_PipeDec_Sink)(
+void   *ctx,
+Word16 *pcm,                 /* nframes*FRSZ samples */
+int    nframes);
+
+/* nqueue is the number of decoded frames the two stages can be apart */
+extern struct BV32_PipeDec *BV32_PipeDec_Open(
+int    nqueue,
+BV32_PipeDec_Sink sink,
+void   *ctx);
+
+/* decode the parameters of nframes packed frames, those with a nonzero */
+/* bfi[] entry (bfi may be NULL) to be concealed, and queue them for    */
+/* synthesis; waits while the queue is full                             */
+extern void BV32_PipeDec_Push(
+struct BV32_PipeDec *pd,
+UWord8 *frames,
+UWord8 *bfi,
+int    nframes);
+
+/* wait until every frame pushed so far has been synthesized */
+extern void BV32_PipeDec_Wait(
+struct BV32_PipeDec *pd);
+
+/* frames not yet synthesized are dropped */
+extern void BV32_PipeDec_Close(
+struct BV32_PipeDec *pd);
+
+#endif
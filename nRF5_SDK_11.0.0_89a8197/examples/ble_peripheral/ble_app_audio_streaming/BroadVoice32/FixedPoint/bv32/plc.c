@@ -49,6 +49,8 @@ void BV32_PLC(
    Word16   hi, lo, i_sf,i;
    Word16   d[LTMOFF+FRSZ];
    Word16   r[SFSZ];
+   
+   WMOPS_ENTER("BV32_PLC");
 
    /*************************************************************/
    /* FEC operates on fixed Q0 speech (stsym, xq, dezfm, depfm) */
@@ -136,7 +138,7 @@ void BV32_PLC(
       /************************************************************/
       /*                Short-term synthesis filter               */
       /************************************************************/
-      apfilterQ1_Q0(ds->atplc, LPCO,  d+i_sf*SFSZ+LTMOFF, xq, SFSZ, ds->stsym, 1);
+      apfilterQ1_Q0_lpco(ds->atplc, d+i_sf*SFSZ+LTMOFF, xq, SFSZ, ds->stsym, 1);
       
       /**********************************************************/
       /*                    De-emphasis filter                  */
@@ -159,7 +161,7 @@ void BV32_PLC(
       /************************************************************/
       /*                  Signal level estimation                 */
       /************************************************************/
-      estlevel(ds->prevlg[0],&ds->level,&ds->lmax,&ds->lmin,
+      bv32fx_estlevel(ds->prevlg[0],&ds->level,&ds->lmax,&ds->lmin,
          &ds->lmean,&ds->x1);
    }
    /************************************************************/
@@ -188,5 +190,6 @@ void BV32_PLC(
       ds->E = Mpy_32_16(hi, lo, gain);
    }
 
+   WMOPS_LEAVE();
    return;
 }
@@ -48,17 +48,19 @@ void preprocess(
    Word16 n;
    Word32 a0;
    
+   WMOPS_ENTER("preprocess");
+   
    for(n=0; n<N; n++)
    {
       
       /* pole section of filtering */
-      a0 = Mpy_32_16(cs->hpfpm[0], cs->hpfpm[1], hpfa[1]);              // Q15
-      a0 = L_add(a0, Mpy_32_16(cs->hpfpm[2], cs->hpfpm[3], hpfa[2]));   // Q15
+      a0 = Mpy_32_16(cs->hpfpm[0], cs->hpfpm[1], bv32fx_hpfa[1]);              // Q15
+      a0 = L_add(a0, Mpy_32_16(cs->hpfpm[2], cs->hpfpm[3], bv32fx_hpfa[2]));   // Q15
 
       /* zero section of filtering */
-      a0 = L_mac(a0, input[n], hpfb[0]);                                // Q15
-      a0 = L_mac(a0, cs->hpfzm[0], hpfb[1]);                            // Q15
-      a0 = L_mac(a0, cs->hpfzm[1], hpfb[2]);                            // Q15
+      a0 = L_mac(a0, input[n], bv32fx_hpfb[0]);                                // Q15
+      a0 = L_mac(a0, cs->hpfzm[0], bv32fx_hpfb[1]);                            // Q15
+      a0 = L_mac(a0, cs->hpfzm[1], bv32fx_hpfb[2]);                            // Q15
 
       /* update pole section of memory */
       cs->hpfpm[2] = cs->hpfpm[0];
@@ -73,4 +75,5 @@ void preprocess(
       cs->hpfzm[1] = cs->hpfzm[0];                                      // Q0
       cs->hpfzm[0] = input[n];                                          // Q0
    }
+   WMOPS_LEAVE();
 }
@@ -46,6 +46,8 @@ Word16  pitchtapquan(
    Word32 p[9];
    Word16 sp[9];
    
+   WMOPS_ENTER("pitchtapquan");
+   
    ppm2 = pp-2;
    xt=x + XOFF;
    
@@ -86,7 +88,7 @@ Word16  pitchtapquan(
    for (i=0;i<9;i++) sp[i] = extract_h(L_shl(p[i],s2));
    
    cormax=MIN_32;
-   sp0 = pp9cb;	/* Q14 */
+   sp0 = bv32fx_pp9cb;	/* Q14 */
    for (i=0;i<PPCBSZ;i++) {
       cor = 0;
       sp1 = sp;
@@ -96,9 +98,10 @@ Word16  pitchtapquan(
       }
    } 
    
-   sp2 = pp9cb + qidx*9;
+   sp2 = bv32fx_pp9cb + qidx*9;
    for (i=0;i<3;i++) b[i] = sp2[i];	/* multiplied by 0.5 : Q14 -> Q15 */ 
    
+   WMOPS_LEAVE();
    return qidx;
 }
 
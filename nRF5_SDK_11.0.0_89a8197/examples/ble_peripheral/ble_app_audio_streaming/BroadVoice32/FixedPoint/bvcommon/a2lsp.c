@@ -36,59 +36,59 @@
 
 Word16 FNevChebP(Word16 x, Word16 *t_man, Word16 *t_exp, Word16 nd2);
 
-void a2lsp(
-           Word16 pc[],       /* (i) Q12: predictor coefficients */
-           Word16 lsp[],      /* (o) Q15: line spectral pairs    */
-           Word16 old_lsp[])  /* (i) Q15: old lsp                */
+/*
+ * Skip the grid ahead to one step short of the interval in which the
+ * previous frame had the next root, when the polynomial has there the same
+ * sign as at the current start. A polynomial of order nd2 has no more than
+ * nd2 roots, so the skipped intervals can only hold a pair of roots if some
+ * other root goes missing, and then all LPCO are not found.
+ */
+static Word16 warmstart(
+   Word16 ngrd,      /* (i) current grid index                   */
+   Word16 *xlow,     /* (i/o) Q15: start of the search           */
+   Word16 *ylow,     /* (i/o) Q13: polynomial at *xlow           */
+   Word16 lsp,       /* (i) Q15: previous frame's lsp            */
+   Word16 *t_man, Word16 *t_exp, Word16 nd2)
 {
-   Word16 i, j, exp;
-   Word16 fa_man[NAB], fa_exp[NAB], fb_man[NAB], fb_exp[NAB];
-   Word16 ta_man[NAB], ta_exp[NAB], tb_man[NAB], tb_exp[NAB];
-   Word16 *t_man, *t_exp;
+   Word16 k, x, y, index, offset;
    Word32 a0;
-   Word16 nd2, nf, ngrd;
-   Word16 xroot, xlow, ylow, ind, xhigh, yhigh, xmid, ymid, dx, dy, dxdy, x, sign;
 
+   /* cosine mapping of the old lsp */
+   index = shr(lsp, 9);                                              // Q6
+   offset = lsp&(Word16)0x01ff;                                      // Q9
+   a0 = L_mult(sub(costable[index+1], costable[index]), offset);     // Q10
+   x = add(costable[index], round(L_shl(a0, 6)));                    // Q15
 
-   /* Find normalization for fa and fb */
-   /*   fb[0] = fa[0] = 1.0;                             */
-   /*   for (i = 1, j = LPCO; i <= (LPCO/2); i++, j--) { */
-   /*      fa[i] = pc[i] + pc[j] - fa[i-1];              */
-   /*      fb[i] = pc[i] - pc[j] + fb[i-1];              */
-   /*   }                                                */
-   fa_man[0] = 16384; 
-   fa_exp[0] = 6;       // fa_man[0] in high 16-bits >> fa_exp[0] = 1.0 in Q24 
-   fb_man[0] = 16384;
-   fb_exp[0] = 6;       // fb_man[0] in high 16-bits >> fb_exp[0] = 1.0 in Q24
-   for (i = 1, j = LPCO; i <= (LPCO/2); i++, j--) {
-      a0 = L_mult0(pc[i], 4096);     // Q24
-      a0 = L_mac0(a0, pc[j], 4096);  // Q24
-      a0 = L_sub(a0, L_shr(L_deposit_h(fa_man[i-1]),fa_exp[i-1]));  // Q24
-      fa_exp[i] = norm_l(a0);
-      fa_man[i] = round(L_shl(a0, fa_exp[i]));  // Q(8+fb_exp[i])
+   /* first grid point past it, less 2 steps of margin */
+   k = add(ngrd, 1);
+   while ((k < Ngrd-1) && (grid[k] >= x)) k++;
+   k = sub(k, 2);
 
-      a0 = L_mult0(pc[i], 4096);     // Q24
-      a0 = L_msu0(a0, pc[j], 4096);  // Q24
-      a0 = L_add(a0, L_shr(L_deposit_h(fb_man[i-1]),fb_exp[i-1]));  // Q24
-      fb_exp[i] = norm_l(a0);
-      fb_man[i] = round(L_shl(a0, fb_exp[i]));  // Q(8+fb_exp[i])
+   if (sub(k, add(ngrd, 1)) > 0) {
+      y = FNevChebP(grid[k], t_man, t_exp, nd2);
+      if (L_mult(y, *ylow) > 0) {
+         *xlow = grid[k];
+         *ylow = y;
+         return k;
+      }
    }
+   return ngrd;
+}
 
-   nd2 = (LPCO)/2;
-
-   /* ta[] and tb[] in Q(7+exp)               */
-   /* ta[0] = fa[nab-1]; ta[i] = 2.0 * fa[j]; */
-   /* tb[0] = fb[nab-1]; tb[i] = 2.0 * fb[j]; */
-   ta_man[0] = fa_man[NAB-1];
-   ta_exp[0] = add(fa_exp[NAB-1], 1);
-   tb_man[0] = fb_man[NAB-1];
-   tb_exp[0] = add(fb_exp[NAB-1], 1);
-   for (i = 1, j = NAB - 2; i < NAB; ++i, --j) {
-      ta_man[i] = fa_man[j];
-      ta_exp[i] = fa_exp[j];
-      tb_man[i] = fb_man[j];
-      tb_exp[i] = fb_exp[j];
-   }
+static Word16 lspsearch(
+   Word16 *ta_man,   /* (i) Q7: sum polynomial, mantissas            */
+   Word16 *ta_exp,   /* (i): exponents                               */
+   Word16 *tb_man,   /* (i) Q7: difference polynomial, mantissas     */
+   Word16 *tb_exp,   /* (i): exponents                               */
+   Word16 nd2,       /* (i): order                                   */
+   Word16 lsp[],     /* (o) Q15: line spectral pairs                 */
+   Word16 old_lsp[]) /* (i) Q15: old lsp to start from, or NULL      */
+{
+   Word16 i, exp;
+   Word16 *t_man, *t_exp;
+   Word32 a0;
+   Word16 nf, ngrd, start;
+   Word16 xroot, xlow, ylow, ind, xhigh, yhigh, xmid, ymid, dx, dy, dxdy, x, sign;
 
    nf = 0;
    t_man = ta_man;
@@ -98,10 +98,16 @@ void a2lsp(
    xlow  = grid[0];  // Q15
    ylow = FNevChebP(xlow, t_man, t_exp, nd2);
    ind = 0;
+   start = (old_lsp != NULL);
 
    /* Root search loop */
    while (ngrd<(Ngrd-1) && nf < LPCO) {
       
+      if (start) {
+         start = 0;
+         ngrd = warmstart(ngrd, &xlow, &ylow, old_lsp[nf], t_man, t_exp, nd2);
+      }
+
       ngrd++;
       xhigh = xlow;
       yhigh = ylow;
@@ -179,16 +185,81 @@ void a2lsp(
          }
          xlow = xmid;
          ylow = FNevChebP(xlow, t_man, t_exp, nd2);
+         start = (old_lsp != NULL);
          
       }
    }
+
+   return nf;
+}
+
+void a2lsp(
+           Word16 pc[],       /* (i) Q12: predictor coefficients */
+           Word16 lsp[],      /* (o) Q15: line spectral pairs    */
+           Word16 old_lsp[])  /* (i) Q15: old lsp                */
+{
+   Word16 i, j;
+   Word16 fa_man[NAB], fa_exp[NAB], fb_man[NAB], fb_exp[NAB];
+   Word16 ta_man[NAB], ta_exp[NAB], tb_man[NAB], tb_exp[NAB];
+   Word32 a0;
+   Word16 nd2, nf;
    
+   WMOPS_ENTER("a2lsp");
+
+
+   /* Find normalization for fa and fb */
+   /*   fb[0] = fa[0] = 1.0;                             */
+   /*   for (i = 1, j = LPCO; i <= (LPCO/2); i++, j--) { */
+   /*      fa[i] = pc[i] + pc[j] - fa[i-1];              */
+   /*      fb[i] = pc[i] - pc[j] + fb[i-1];              */
+   /*   }                                                */
+   fa_man[0] = 16384; 
+   fa_exp[0] = 6;       // fa_man[0] in high 16-bits >> fa_exp[0] = 1.0 in Q24 
+   fb_man[0] = 16384;
+   fb_exp[0] = 6;       // fb_man[0] in high 16-bits >> fb_exp[0] = 1.0 in Q24
+   for (i = 1, j = LPCO; i <= (LPCO/2); i++, j--) {
+      a0 = L_mult0(pc[i], 4096);     // Q24
+      a0 = L_mac0(a0, pc[j], 4096);  // Q24
+      a0 = L_sub(a0, L_shr(L_deposit_h(fa_man[i-1]),fa_exp[i-1]));  // Q24
+      fa_exp[i] = norm_l(a0);
+      fa_man[i] = round(L_shl(a0, fa_exp[i]));  // Q(8+fb_exp[i])
+
+      a0 = L_mult0(pc[i], 4096);     // Q24
+      a0 = L_msu0(a0, pc[j], 4096);  // Q24
+      a0 = L_add(a0, L_shr(L_deposit_h(fb_man[i-1]),fb_exp[i-1]));  // Q24
+      fb_exp[i] = norm_l(a0);
+      fb_man[i] = round(L_shl(a0, fb_exp[i]));  // Q(8+fb_exp[i])
+   }
+
+   nd2 = (LPCO)/2;
+
+   /* ta[] and tb[] in Q(7+exp)               */
+   /* ta[0] = fa[nab-1]; ta[i] = 2.0 * fa[j]; */
+   /* tb[0] = fb[nab-1]; tb[i] = 2.0 * fb[j]; */
+   ta_man[0] = fa_man[NAB-1];
+   ta_exp[0] = add(fa_exp[NAB-1], 1);
+   tb_man[0] = fb_man[NAB-1];
+   tb_exp[0] = add(fb_exp[NAB-1], 1);
+   for (i = 1, j = NAB - 2; i < NAB; ++i, --j) {
+      ta_man[i] = fa_man[j];
+      ta_exp[i] = fa_exp[j];
+      tb_man[i] = fb_man[j];
+      tb_exp[i] = fb_exp[j];
+   }
+
+   /* Start from the previous frame's lsp; should that miss a pair of roots, */
+   /* walk the whole grid                                                    */
+   nf = lspsearch(ta_man, ta_exp, tb_man, tb_exp, nd2, lsp, old_lsp);
+   if (sub(nf, LPCO) < 0)
+      nf = lspsearch(ta_man, ta_exp, tb_man, tb_exp, nd2, lsp, NULL);
+
    /* Check if all LSPs are found */
    if( sub(nf, LPCO) < 0)
    {
       W16copy(lsp, old_lsp, LPCO);
    }
 
+   WMOPS_LEAVE();
    return;
 }
 
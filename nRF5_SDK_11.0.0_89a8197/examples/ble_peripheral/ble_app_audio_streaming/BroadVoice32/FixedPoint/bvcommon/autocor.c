@@ -21,13 +21,16 @@
 
 /*****************************************************************************
   autocor.c : Common Fixed-Point Library: window an input array and 
-              compute autocorrelation coefficients
+              compute autocorrelation coefficients; cross-correlation
+              over a range of lags
 
   $Log$
 ******************************************************************************/
 
 #include "typedef.h"
 #include "basop32.h"
+#include "dspop.h"
+#include "simdop.h"
 
 #define  WINSZ 160
 
@@ -41,6 +44,11 @@ void Autocorr(
    Word16 n, j, y_shift, shift;
    Word16 buf[WINSZ];
    Word32 a0;
+#if DSPOP
+   Word64 e0;
+#endif
+   
+   WMOPS_ENTER("Autocorr");
 
    /* Window signal */
    for(n=0; n<l_window; n++)
@@ -58,6 +66,36 @@ void Autocorr(
    if(shift < 0)
       shift = 0;
 
+#if DSPOP
+   /* Shift input and calculate autocorrelation coefficient r[0]; the */
+   /* terms are positive, so saturating once at the end is the same   */
+   for(n=0; n<l_window; n++)
+      buf[n] = shr(buf[n], shift);
+   e0 = 1;
+   for(n=0; n<l_window-1; n+=2)
+      e0 = dsp_smlald(dsp_ld2(buf+n), dsp_ld2(buf+n), e0);
+   if(n<l_window)
+      e0 = dsp_smlald((Word16x2)(buf[n] & 0xffff), (Word16x2)(buf[n] & 0xffff), e0);
+   a0 = (e0 > MAX_32) ? MAX_32 : (Word32)e0;
+
+   /* Normalize autocorrelation */
+   shift = norm_l(a0);
+   r[0] = L_shl(a0, shift);
+
+   /* Calculate autocorrelation coefficients r[1], r[2], ..., r[m]; */
+   /* no partial sum exceeds the energy, which fits in a Word32     */
+   if(DSPOP_GUARD(e0 <= MAX_32)){
+      for(j=1; j<=m; j++){
+#if SIMDOP
+         if (!simd_dotp(&a0, buf, buf+j, (Word16)(l_window-j)))
+#endif
+         a0 = dsp_dotp(buf, buf+j, (Word16)(l_window-j), 0);
+         r[j] = L_shl(a0, shift);
+      }
+      WMOPS_LEAVE();
+      return;
+   }
+#else
    /* Shift input and calculate autocorrelation coefficient r[0] */
    a0 = 1;
    for(n=0; n<l_window; n++){ 
@@ -68,6 +106,7 @@ void Autocorr(
    /* Normalize autocorrelation */
    shift = norm_l(a0);
    r[0] = L_shl(a0, shift);
+#endif
 
    /* Calculate autocorrelation coefficients r[1], r[2], ..., r[m] */
    for(j=1; j<=m; j++){
@@ -77,6 +116,54 @@ void Autocorr(
       r[j] = L_shl(a0, shift);
    }
 
+   WMOPS_LEAVE();
+   return;
+}
+
+void Crosscorr(
+               Word32   r[],     /* (o) : r[k] = sum x[n]*y[n-k], n = 0..l-1 */
+               Word16   x[],     /* (i) : target signal x[0..l-1]            */
+               Word16   y[],     /* (i) : signal y[-(nlag-1)..l-1]           */
+               Word16   l,       /* (i) : correlation length                 */
+               Word16   nlag)    /* (i) : number of lags, k = 0..nlag-1      */
+{
+   Word16 n, k;
+   Word32 a0;
+#if DSPOP
+   Word64 e0, e1;
+#endif
+
+#if DSPOP
+   /* no partial sum exceeds the square root of the product of the two */
+   /* energies (Cauchy-Schwarz), so with both in range the products    */
+   /* can be summed without saturation                                 */
+   e0 = dsp_sumsq(x, l);
+   e1 = dsp_sumsq(y-(nlag-1), (Word16)(l+nlag-1));
+   if (DSPOP_GUARD(e0 <= MAX_32 && e1 <= MAX_32)) {
+#if SIMDOP
+      if (simd_dotp(&r[0], x, y, l)) {
+         for (k=1; k<nlag; k++)
+            simd_dotp(&r[k], x, y-k, l);
+         return;
+      }
+#endif
+      for (k=0; k<nlag-1; k+=2) {
+         r[k] = r[k+1] = 0;
+         dsp_dotp2(r+k, x, y-k, l);
+      }
+      if (k<nlag)
+         r[k] = dsp_dotp(x, y-k, l, 0);
+      return;
+   }
+#endif
+
+   for (k=0; k<nlag; k++) {
+      a0 = 0;
+      for (n=0; n<l; n++)
+         a0 = L_mac0(a0, x[n], y[n-k]);
+      r[k] = a0;
+   }
+
    return;
 }
 
@@ -90,9 +177,12 @@ void Spectral_Smoothing(
    Word16    i;
    Word16 hi, lo;
    
+   WMOPS_ENTER("Spectral_Smoothing");
+   
    for(i=1; i<=m; i++)
    {
       L_Extract(r[i], &hi, &lo);
       r[i] = Mpy_32(hi, lo, lag_h[i-1], lag_l[i-1]);
    }
+   WMOPS_LEAVE();
 }
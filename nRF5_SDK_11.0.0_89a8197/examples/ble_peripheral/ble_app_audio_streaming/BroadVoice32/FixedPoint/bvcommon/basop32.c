@@ -1,24 +0,0 @@
-/*****************************************************************************/
-/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
-/* Revision Date: October 5, 2012                                            */
-/* Version 1.2                                                               */
-/*****************************************************************************/
-
-/*****************************************************************************/
-/* Copyright 2000-2012 Broadcom Corporation                                  */
-/*                                                                           */
-/* This software is provided under the GNU Lesser General Public License,    */
-/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
-/* This program is distributed in the hope that it will be useful, but       */
-/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
-/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
-/* more details.  A copy of the LGPL is available at                         */
-/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
-/* or by writing to the Free Software Foundation, Inc.,                      */
-/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
-/*****************************************************************************/
-
-#include "typedef.h"
-#include "basop32.h"
-#include "../itug191lib/basop32.c"
-#include "../itug729ilib/oper_32b.c"
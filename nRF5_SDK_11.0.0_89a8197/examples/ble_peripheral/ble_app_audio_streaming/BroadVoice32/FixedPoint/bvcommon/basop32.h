@@ -18,5 +18,444 @@
 /* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
 /*****************************************************************************/
 
-#include "../itug191lib/basop32.h"
-#include "../itug729ilib/oper_32b.h"
+/*****************************************************************************
+  basop32.h : Common Fixed-Point Library: basic operators
+
+  Inline implementation of the ITU-T G.191 (STL 2005) basic operators and
+  the G.729 double precision operators (oper_32b) used by the codec.
+  Results are the same as those of the ITU-T reference code. The global
+  Overflow flag of the reference code is not kept, so that the operators
+  have no side effects and the codec is reentrant.
+
+  With WMOPS=1 each operator adds its STL weight to the complexity
+  counters (wmops.h). An operator built from others takes back what
+  they count, and the double precision operators count the basic
+  operators they are made of, as in the G.729 reference code.
+
+  $Log$
+******************************************************************************/
+
+#ifndef __BASOP32_H__
+#define __BASOP32_H__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "wmops.h"
+
+#define MAX_32 (Word32)0x7fffffffL
+#define MIN_32 (Word32)0x80000000L
+
+#define MAX_16 (Word16)0x7fff
+#define MIN_16 (Word16)0x8000
+
+#ifndef BASOP_INLINE
+#define BASOP_INLINE static __inline
+#endif
+
+/*****************************************************************************
+  16-bit operators
+******************************************************************************/
+
+BASOP_INLINE Word16 saturate(Word32 L_var1)
+{
+   if (L_var1 > 0x00007fffL)
+      return MAX_16;
+   if (L_var1 < (Word32)0xffff8000L)
+      return MIN_16;
+   return (Word16)L_var1;
+}
+
+BASOP_INLINE Word16 add(Word16 var1, Word16 var2)
+{
+   WMOPS_OPS(1);
+   return saturate((Word32)var1 + var2);
+}
+
+BASOP_INLINE Word16 sub(Word16 var1, Word16 var2)
+{
+   WMOPS_OPS(1);
+   return saturate((Word32)var1 - var2);
+}
+
+BASOP_INLINE Word16 abs_s(Word16 var1)
+{
+   WMOPS_OPS(1);
+   if (var1 == MIN_16)
+      return MAX_16;
+   return (var1 < 0) ? (Word16)-var1 : var1;
+}
+
+BASOP_INLINE Word16 negate(Word16 var1)
+{
+   WMOPS_OPS(1);
+   return (var1 == MIN_16) ? MAX_16 : (Word16)-var1;
+}
+
+BASOP_INLINE Word16 extract_h(Word32 L_var1)
+{
+   WMOPS_OPS(1);
+   return (Word16)(L_var1 >> 16);
+}
+
+BASOP_INLINE Word16 extract_l(Word32 L_var1)
+{
+   WMOPS_OPS(1);
+   return (Word16)L_var1;
+}
+
+BASOP_INLINE Word16 shr(Word16 var1, Word16 var2);
+
+BASOP_INLINE Word16 shl(Word16 var1, Word16 var2)
+{
+   Word32 result;
+   
+   if (var2 < 0) {
+      if (var2 < -16)
+         var2 = -16;
+      return shr(var1, (Word16)-var2);
+   }
+   
+   WMOPS_OPS(1);
+   result = (Word32)var1 * ((Word32)1 << (var2 & 31));
+   if ((var2 > 15 && var1 != 0) || (result != (Word32)((Word16)result)))
+      return (var1 > 0) ? MAX_16 : MIN_16;
+   return (Word16)result;
+}
+
+BASOP_INLINE Word16 shr(Word16 var1, Word16 var2)
+{
+   if (var2 < 0) {
+      if (var2 < -16)
+         var2 = -16;
+      return shl(var1, (Word16)-var2);
+   }
+   
+   WMOPS_OPS(1);
+   if (var2 >= 15)
+      return (var1 < 0) ? -1 : 0;
+   
+   /* arithmetic shift, rounding toward minus infinity */
+   return (var1 < 0) ? (Word16)~((~var1) >> var2) : (Word16)(var1 >> var2);
+}
+
+BASOP_INLINE Word16 shr_r(Word16 var1, Word16 var2)
+{
+   Word16 var_out;
+   
+   WMOPS_OPS(3);
+   if (var2 > 15)
+      return 0;
+   
+   var_out = shr(var1, var2);
+   WMOPS_OPS(-1);
+   if (var2 > 0 && (var1 & ((Word16)1 << (var2 - 1))) != 0)
+      var_out++;
+   return var_out;
+}
+
+BASOP_INLINE Word16 mult(Word16 var1, Word16 var2)
+{
+   Word32 L_product = ((Word32)var1 * var2) >> 15;
+   
+   WMOPS_OPS(1);
+   /* only -1 * -1 saturates */
+   if (L_product == 0x00008000L)
+      return MAX_16;
+   return (Word16)L_product;
+}
+
+BASOP_INLINE Word16 mult_r(Word16 var1, Word16 var2)
+{
+   Word32 L_product = ((Word32)var1 * var2 + 0x00004000L) >> 15;
+   
+   WMOPS_OPS(1);
+   if (L_product == 0x00008000L)
+      return MAX_16;
+   return (Word16)L_product;
+}
+
+BASOP_INLINE Word16 norm_s(Word16 var1)
+{
+   Word16 var_out;
+   
+   WMOPS_OPS(1);
+   if (var1 == 0)
+      return 0;
+   if (var1 == (Word16)0xffff)
+      return 15;
+   
+   if (var1 < 0)
+      var1 = (Word16)~var1;
+   for (var_out = 0; var1 < 0x4000; var_out++)
+      var1 = (Word16)(var1 << 1);
+   return var_out;
+}
+
+/*****************************************************************************
+  32-bit operators
+******************************************************************************/
+
+BASOP_INLINE Word32 L_add(Word32 L_var1, Word32 L_var2)
+{
+   Word32 L_var_out = (Word32)((UWord32)L_var1 + (UWord32)L_var2);
+   
+   WMOPS_OPS(1);
+   /* overflow only if both operands have the same sign and the result does not */
+   if ((((L_var1 ^ L_var2) & MIN_32) == 0) && ((L_var_out ^ L_var1) & MIN_32))
+      return (L_var1 < 0) ? MIN_32 : MAX_32;
+   return L_var_out;
+}
+
+BASOP_INLINE Word32 L_sub(Word32 L_var1, Word32 L_var2)
+{
+   Word32 L_var_out = (Word32)((UWord32)L_var1 - (UWord32)L_var2);
+   
+   WMOPS_OPS(1);
+   /* overflow only if the operands have different signs and the result differs from the first */
+   if ((((L_var1 ^ L_var2) & MIN_32) != 0) && ((L_var_out ^ L_var1) & MIN_32))
+      return (L_var1 < 0) ? MIN_32 : MAX_32;
+   return L_var_out;
+}
+
+BASOP_INLINE Word32 L_negate(Word32 L_var1)
+{
+   WMOPS_OPS(1);
+   return (L_var1 == MIN_32) ? MAX_32 : -L_var1;
+}
+
+BASOP_INLINE Word32 L_abs(Word32 L_var1)
+{
+   WMOPS_OPS(1);
+   if (L_var1 == MIN_32)
+      return MAX_32;
+   return (L_var1 < 0) ? -L_var1 : L_var1;
+}
+
+BASOP_INLINE Word32 L_mult(Word16 var1, Word16 var2)
+{
+   Word32 L_var_out = (Word32)var1 * var2;
+   
+   WMOPS_OPS(1);
+   if (L_var_out == (Word32)0x40000000L)
+      return MAX_32;
+   return L_var_out * 2;
+}
+
+BASOP_INLINE Word32 L_mult0(Word16 var1, Word16 var2)
+{
+   WMOPS_OPS(1);
+   return (Word32)var1 * var2;
+}
+
+BASOP_INLINE Word32 L_mac(Word32 L_var3, Word16 var1, Word16 var2)
+{
+   WMOPS_OPS(-1);
+   return L_add(L_var3, L_mult(var1, var2));
+}
+
+BASOP_INLINE Word32 L_msu(Word32 L_var3, Word16 var1, Word16 var2)
+{
+   WMOPS_OPS(-1);
+   return L_sub(L_var3, L_mult(var1, var2));
+}
+
+BASOP_INLINE Word32 L_mac0(Word32 L_var3, Word16 var1, Word16 var2)
+{
+   WMOPS_OPS(-1);
+   return L_add(L_var3, L_mult0(var1, var2));
+}
+
+BASOP_INLINE Word32 L_msu0(Word32 L_var3, Word16 var1, Word16 var2)
+{
+   WMOPS_OPS(-1);
+   return L_sub(L_var3, L_mult0(var1, var2));
+}
+
+BASOP_INLINE Word32 L_deposit_h(Word16 var1)
+{
+   WMOPS_OPS(1);
+   return (Word32)((UWord32)(Word32)var1 << 16);
+}
+
+BASOP_INLINE Word32 L_deposit_l(Word16 var1)
+{
+   WMOPS_OPS(1);
+   return (Word32)var1;
+}
+
+BASOP_INLINE Word16 round_fx(Word32 L_var1)
+{
+   WMOPS_OPS(-1);
+   return extract_h(L_add(L_var1, (Word32)0x00008000L));
+}
+
+#define round round_fx
+
+BASOP_INLINE Word32 L_shr(Word32 L_var1, Word16 var2);
+
+BASOP_INLINE Word32 L_shl(Word32 L_var1, Word16 var2)
+{
+   if (var2 <= 0) {
+      if (var2 < -32)
+         var2 = -32;
+      return L_shr(L_var1, (Word16)-var2);
+   }
+   
+   WMOPS_OPS(1);
+   /* saturate if any of the bits shifted out, or into the sign bit, differ from the sign */
+   if (var2 < 32) {
+      if (L_var1 > (MAX_32 >> var2))
+         return MAX_32;
+      if (L_var1 < (MIN_32 >> var2))
+         return MIN_32;
+      return (Word32)((UWord32)L_var1 << var2);
+   }
+   
+   if (L_var1 > 0)
+      return MAX_32;
+   if (L_var1 < 0)
+      return MIN_32;
+   return 0;
+}
+
+BASOP_INLINE Word32 L_shr(Word32 L_var1, Word16 var2)
+{
+   if (var2 < 0) {
+      if (var2 < -32)
+         var2 = -32;
+      return L_shl(L_var1, (Word16)-var2);
+   }
+   
+   WMOPS_OPS(1);
+   if (var2 >= 31)
+      return (L_var1 < 0) ? -1L : 0;
+   
+   return (L_var1 < 0) ? ~((~L_var1) >> var2) : (L_var1 >> var2);
+}
+
+BASOP_INLINE Word32 L_shr_r(Word32 L_var1, Word16 var2)
+{
+   Word32 L_var_out;
+   
+   WMOPS_OPS(3);
+   if (var2 > 31)
+      return 0;
+   
+   L_var_out = L_shr(L_var1, var2);
+   WMOPS_OPS(-1);
+   if (var2 > 0 && (L_var1 & ((Word32)1 << (var2 - 1))) != 0)
+      L_var_out++;
+   return L_var_out;
+}
+
+BASOP_INLINE Word16 norm_l(Word32 L_var1)
+{
+   Word16 var_out;
+   
+   WMOPS_OPS(1);
+   if (L_var1 == 0)
+      return 0;
+   if (L_var1 == (Word32)0xffffffffL)
+      return 31;
+   
+   if (L_var1 < 0)
+      L_var1 = ~L_var1;
+   for (var_out = 0; L_var1 < (Word32)0x40000000L; var_out++)
+      L_var1 <<= 1;
+   return var_out;
+}
+
+BASOP_INLINE Word16 div_s(Word16 var1, Word16 var2)
+{
+   Word16 var_out = 0;
+   Word32 L_num, L_denom;
+   int i;
+   
+   WMOPS_OPS(18);
+   if ((var1 > var2) || (var1 < 0) || (var2 < 0)) {
+      printf("Division Error var1=%d  var2=%d\n", var1, var2);
+      exit(0);
+   }
+   if (var2 == 0) {
+      printf("Division by 0, Fatal error \n");
+      exit(0);
+   }
+   
+   if (var1 == 0)
+      return 0;
+   if (var1 == var2)
+      return MAX_16;
+   
+   /* restoring division, one quotient bit per iteration */
+   L_num   = var1;
+   L_denom = var2;
+   for (i = 0; i < 15; i++) {
+      var_out <<= 1;
+      L_num   <<= 1;
+      if (L_num >= L_denom) {
+         L_num -= L_denom;
+         var_out++;
+      }
+   }
+   return var_out;
+}
+
+/*****************************************************************************
+  Double precision operators (G.729 oper_32b)
+
+  A 32-bit value is represented as L_32 = hi<<16 + lo<<1, with hi the
+  16 MSBs and lo the next 15 bits (0 <= lo < 2^15).
+******************************************************************************/
+
+BASOP_INLINE void L_Extract(Word32 L_32, Word16 *hi, Word16 *lo)
+{
+   *hi = extract_h(L_32);
+   *lo = extract_l(L_msu(L_shr(L_32, 1), *hi, 16384));
+}
+
+BASOP_INLINE Word32 L_Comp(Word16 hi, Word16 lo)
+{
+   return L_mac(L_deposit_h(hi), lo, 1);
+}
+
+BASOP_INLINE Word32 Mpy_32(Word16 hi1, Word16 lo1, Word16 hi2, Word16 lo2)
+{
+   Word32 L_32;
+   
+   L_32 = L_mult(hi1, hi2);
+   L_32 = L_mac(L_32, mult(hi1, lo2), 1);
+   L_32 = L_mac(L_32, mult(lo1, hi2), 1);
+   return L_32;
+}
+
+BASOP_INLINE Word32 Mpy_32_16(Word16 hi, Word16 lo, Word16 n)
+{
+   Word32 L_32;
+   
+   L_32 = L_mult(hi, n);
+   L_32 = L_mac(L_32, mult(lo, n), 1);
+   return L_32;
+}
+
+BASOP_INLINE Word32 Div_32(Word32 L_num, Word16 denom_hi, Word16 denom_lo)
+{
+   Word16 approx, hi, lo, n_hi, n_lo;
+   Word32 L_32;
+   
+   /* first approximation: 1 / L_denom = 1/denom_hi */
+   approx = div_s((Word16)0x3fff, denom_hi);
+   
+   /* 1/L_denom = approx * (2.0 - L_denom * approx) */
+   L_32 = Mpy_32_16(denom_hi, denom_lo, approx);
+   L_32 = L_sub((Word32)0x7fffffffL, L_32);
+   L_Extract(L_32, &hi, &lo);
+   L_32 = Mpy_32_16(hi, lo, approx);
+   
+   /* L_num * (1/L_denom) */
+   L_Extract(L_32, &hi, &lo);
+   L_Extract(L_num, &n_hi, &n_lo);
+   L_32 = Mpy_32(n_hi, n_lo, hi, lo);
+   return L_shl(L_32, 2);
+}
+
+#endif /* __BASOP32_H__ */
@@ -0,0 +1,368 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  allpole.c : Common Fixed-Point Library: all-pole filter
+
+  $Log$
+******************************************************************************/
+
+#include "typedef.h"
+#include "bvcommon.h"
+#include "basop32.h"
+#include "utility.h"
+#include "dspop.h"
+
+#define BUFFERSIZE  (LPCO+160)
+
+#if DSPOP
+/* all-pole filtering with packed dual 16-bit multiply-accumulates:   */
+/* buf[n+m] = round(L_shl(L_mult0(4096,x[n]) + sum c[i]*buf[n+i], q)) */
+/* with c[] the coefficients a[m..1], negated and scaled by k (1,2).   */
+/* Stops before the first sample whose partial sums could saturate,   */
+/* as bounded by the largest |buf| so far; returns the samples done.  */
+static Word16 apfilter_dsp(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 m,       /* (i)     : LPC order                */
+              Word16 k,       /* (i)     : product scaling          */
+              Word16 q,       /* (i)     : output shift             */
+              Word16 x[],     /* (i)     : input signal             */
+              Word16 buf[],   /* (i/o)   : memory, then output      */
+              Word16 lg       /* (i)     : size of filtering        */
+              )
+{
+   Word16 c[LPCO];
+   Word32 a0, sa, ma, t;
+   Word16 *fp1;
+   Word16 i, n;
+   
+   if (m > LPCO || k*dsp_maxabs(a+1, m) > 32767)
+      return 0;
+   
+   for (i = 0; i < m; i++)
+      c[i] = (Word16)(-k*a[m-i]);
+   sa = k*dsp_sumabs(a+1, m);
+   ma = dsp_maxabs(buf, m);
+   
+   for (n = 0; n < lg; n++) {
+      /* |4096*x| + sum k*|a[i]*buf| must stay clear of the rounding */
+      t = (x[n] < 0) ? -(Word32)x[n] : x[n];
+      if ((Word64)4096*t + (Word64)sa*ma > (Word64)MAX_32 - 4096)
+         break;
+      fp1 = &buf[n];
+      a0 = dsp_dotp(fp1, c, m, L_mult0(4096, x[n]));
+      fp1[m] = dsp_round_shr(a0, (Word16)(16-q));
+      t = (fp1[m] < 0) ? -(Word32)fp1[m] : fp1[m];
+      if (t > ma)
+         ma = t;
+   }
+   
+   (void)DSPOP_GUARD(n == lg);
+   return n;
+}
+#endif
+
+void bv32fx_apfilter(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 m,       /* (i)     : LPC order                */
+              Word16 x[],     /* (i) Q0  : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering        */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              )
+{
+   Word16 buf[BUFFERSIZE]; /* buffer for filter memory & signal */
+   Word32 a0;
+   Word16 *fp1;
+   Word16 i, n;
+   
+   WMOPS_ENTER("bv32fx_apfilter");
+   
+   /* copy filter memory to beginning part of temporary buffer */
+   W16copy(buf, mem, m);
+   
+#if DSPOP
+   n = apfilter_dsp(a, m, 1, 4, x, buf, lg);
+#else
+   n = 0;
+#endif
+   
+   /* loop through every element of the current vector */
+   for (; n < lg; n++) {
+      
+      /* perform multiply-adds along the delay line of filter */
+      fp1 = &buf[n];
+      a0 = L_mult0(4096, x[n]); // Q12
+      for (i = m; i > 0; i--)
+         a0 = L_msu0(a0, a[i], *fp1++); // Q12
+      
+      /* update temporary buffer for filter memory */
+      *fp1 = round(L_shl(a0,4));
+   }
+
+   /* copy to output array */
+   W16copy(y, buf+m, lg);
+   
+   /* get the filter memory after filtering the current vector */
+   if(update)
+      W16copy(mem, buf+lg, m);
+
+   WMOPS_LEAVE();
+   return;
+}
+
+void apfilterQ1_Q0(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 m,       /* (i)     : LPC order                */
+              Word16 x[],     /* (i) Q1  : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering        */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              )
+{
+   Word16 buf[BUFFERSIZE]; /* buffer for filter memory & signal */
+   Word32 a0;
+   Word16 *fp1;
+   Word16 i, n;
+   
+   WMOPS_ENTER("apfilterQ1_Q0");
+   
+   /* copy filter memory to beginning part of temporary buffer */
+   W16copy(buf, mem, m);
+   
+#if DSPOP
+   n = apfilter_dsp(a, m, 2, 3, x, buf, lg);
+#else
+   n = 0;
+#endif
+   
+   /* loop through every element of the current vector */
+   for (; n < lg; n++) {
+      
+      /* perform multiply-adds along the delay line of filter */
+      fp1 = &buf[n];
+      a0 = L_mult0(4096, x[n]); // Q13
+      for (i = m; i > 0; i--)
+         a0 = L_msu(a0, a[i], *fp1++); // Q13
+      
+      /* update temporary buffer for filter memory */
+      *fp1 = round(L_shl(a0,3));
+   }
+
+   /* copy to output array */
+   W16copy(y, buf+m, lg);
+   
+   /* get the filter memory after filtering the current vector */
+   if(update)
+      W16copy(mem, buf+lg, m);
+
+   WMOPS_LEAVE();
+   return;
+}
+
+/* The codec's filters always have order LPCO or 1. The kernels below  */
+/* are those filters with the taps written out and without the copy    */
+/* through buf[]: the past outputs are kept in locals, or, where the   */
+/* basic operators are needed, read from a short head buffer after the */
+/* memory for the first LPCO outputs and straight from y[] after that. */
+/* y may be x, to filter in place. The results are identical to those  */
+/* of bv32fx_apfilter() and apfilterQ1_Q0() with m = LPCO and m = 1.          */
+
+#if LPCO != 8
+#error the unrolled taps below are for LPCO = 8
+#endif
+
+/* a0 = op(a0, a[m-i], p[i]), i = 0..LPCO-1 */
+#define TAPS_LPCO(op, a0, a, p) \
+   a0 = op(a0, a[8], p[0]); a0 = op(a0, a[7], p[1]); \
+   a0 = op(a0, a[6], p[2]); a0 = op(a0, a[5], p[3]); \
+   a0 = op(a0, a[4], p[4]); a0 = op(a0, a[3], p[5]); \
+   a0 = op(a0, a[2], p[6]); a0 = op(a0, a[1], p[7])
+
+/* k = 1: L_msu0 taps, Q12 accumulator; k = 2: L_msu taps, Q13 */
+static __inline void apfilter_lpco_k(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 k,       /* (i)     : product scaling          */
+              Word16 x[],     /* (i)     : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering        */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              )
+{
+   Word16 h[2*LPCO];  /* memory, then the first LPCO outputs */
+   Word32 a0;
+   Word16 *p;
+   Word16 n;
+#if DSPOP
+   Word16 c[LPCO];
+   Word32 c0, c1, c2, c3, c4, c5, c6, c7;
+   Word32 s0, s1, s2, s3, s4, s5, s6, s7;
+   Word32 room, ma, t;
+   Word64 sa;
+   Word16 i, ok;
+#endif
+   
+#if DSPOP
+   for (i = 0; i < LPCO; i++)
+      c[i] = (Word16)(-k*a[LPCO-i]);
+   ok = (k*dsp_maxabs(a+1, LPCO) <= 32767);
+   sa = k*dsp_sumabs(a+1, LPCO);
+   
+   /* the memory and the outputs are Word16, so |4096*x| + 32768*sa   */
+   /* bounds every partial sum: if that stays clear of the rounding,  */
+   /* the whole frame is filtered with plain multiply-adds, the last  */
+   /* LPCO outputs kept in s0..s7 (s7 the latest) instead of memory   */
+   if (DSPOP_GUARD(ok && (Word64)4096*dsp_maxabs(x, lg) + 32768*sa
+      <= (Word64)MAX_32 - 4096)) {
+      c0 = c[0]; c1 = c[1]; c2 = c[2]; c3 = c[3];
+      c4 = c[4]; c5 = c[5]; c6 = c[6]; c7 = c[7];
+      s0 = mem[0]; s1 = mem[1]; s2 = mem[2]; s3 = mem[3];
+      s4 = mem[4]; s5 = mem[5]; s6 = mem[6]; s7 = mem[7];
+      for (n = 0; n < lg; n++) {
+         a0 = 4096*(Word32)x[n] + c0*s0 + c1*s1 + c2*s2 + c3*s3
+            + c4*s4 + c5*s5 + c6*s6;
+         a0 += c7*s7;
+         s0 = s1; s1 = s2; s2 = s3; s3 = s4;
+         s4 = s5; s5 = s6; s6 = s7;
+         s7 = dsp_round_shr(a0, (Word16)(11+k));
+         y[n] = (Word16)s7;
+      }
+      if (update) {
+         mem[0] = (Word16)s0; mem[1] = (Word16)s1;
+         mem[2] = (Word16)s2; mem[3] = (Word16)s3;
+         mem[4] = (Word16)s4; mem[5] = (Word16)s5;
+         mem[6] = (Word16)s6; mem[7] = (Word16)s7;
+      }
+      return;
+   }
+   
+   /* otherwise sample by sample, with the largest |output| so far in */
+   /* place of 32768 (as apfilter_dsp) and the basic operators where   */
+   /* even that bound could saturate                                   */
+   ma = dsp_maxabs(mem, LPCO);
+   room = -1;
+   if (ok && sa*ma <= (Word64)MAX_32 - 4096)
+      room = (Word32)((Word64)MAX_32 - 4096 - sa*ma);
+#endif
+   
+   W16copy(h, mem, LPCO);
+   for (n = 0; n < lg; n++) {
+      p = (n < LPCO) ? &h[n] : &y[n-LPCO];
+#if DSPOP
+      t = (x[n] < 0) ? -(Word32)x[n] : x[n];
+      if (4096*t <= room) {
+         a0 = dsp_dotp(p, c, LPCO, L_mult0(4096, x[n]));
+         y[n] = dsp_round_shr(a0, (Word16)(11+k));
+      }
+      else
+#endif
+      {
+         a0 = L_mult0(4096, x[n]);
+         if (k == 1) {
+            TAPS_LPCO(L_msu0, a0, a, p);
+            y[n] = round(L_shl(a0, 4));
+         }
+         else {
+            TAPS_LPCO(L_msu, a0, a, p);
+            y[n] = round(L_shl(a0, 3));
+         }
+      }
+#if DSPOP
+      t = (y[n] < 0) ? -(Word32)y[n] : y[n];
+      if (t > ma) {
+         ma = t;
+         room = -1;
+         if (ok && sa*ma <= (Word64)MAX_32 - 4096)
+            room = (Word32)((Word64)MAX_32 - 4096 - sa*ma);
+      }
+#endif
+      if (n < LPCO)
+         h[LPCO+n] = y[n];
+   }
+   
+   if (update)
+      W16copy(mem, y+lg-LPCO, LPCO);
+}
+
+void apfilter_lpco(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 x[],     /* (i) Q0  : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering, >= LPCO */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              )
+{
+   WMOPS_ENTER("apfilter_lpco");
+   apfilter_lpco_k(a, 1, x, y, lg, mem, update);
+   WMOPS_LEAVE();
+}
+
+void apfilterQ1_Q0_lpco(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 x[],     /* (i) Q1  : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering, >= LPCO */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              )
+{
+   WMOPS_ENTER("apfilterQ1_Q0_lpco");
+   apfilter_lpco_k(a, 2, x, y, lg, mem, update);
+   WMOPS_LEAVE();
+}
+
+/* first order: |4096*x| + |a[1]*y| < 2^31 - 2^11, so neither partial */
+/* sum can saturate, only the shift, which the rounding saturates too */
+void apfilter_1(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 x[],     /* (i) Q0  : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering        */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              )
+{
+   Word32 a0;
+   Word16 s;
+   Word16 n;
+   
+   WMOPS_ENTER("apfilter_1");
+   
+   s = mem[0];
+   for (n = 0; n < lg; n++) {
+#if DSPOP
+      a0 = 4096*(Word32)x[n] - a[1]*(Word32)s;
+      s = dsp_round_shr(a0, 12);
+#else
+      a0 = L_msu0(L_mult0(4096, x[n]), a[1], s);
+      s = round(L_shl(a0, 4));
+#endif
+      y[n] = s;
+   }
+   
+   if (update)
+      mem[0] = s;
+   WMOPS_LEAVE();
+}
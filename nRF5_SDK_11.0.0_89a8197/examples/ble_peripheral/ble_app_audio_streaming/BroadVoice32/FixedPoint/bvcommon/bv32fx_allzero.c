@@ -0,0 +1,245 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  allzero.c : Common Fixed-Point Library: all-zero filter
+
+  $Log$
+******************************************************************************/
+
+#include "typedef.h"
+#include "basop32.h"
+#include "bvcommon.h"
+#include "dspop.h"
+
+#if DSPOP
+/* all-zero filtering with packed dual 16-bit multiply-accumulates:   */
+/* y[n] = round(L_shl(sum a[i]*x[n-i], q)). Returns 0, with nothing   */
+/* done, unless no partial sum can saturate.                          */
+static Word16 azfilter_dsp(
+              Word16 a[],    /* (i) Q12 : prediction coefficients          */
+              Word16 m,      /* (i)     : LPC order                        */
+              Word16 q,      /* (i)     : output shift                     */
+              Word16 x[],    /* (i) Q0  : input signal samples, incl. past */
+              Word16 y[],    /* (o)     : filtered output signal           */
+              Word16 lg      /* (i)     : size of filtering                */
+              )
+{
+   Word16 c[LPCO+1];
+   Word32 a0;
+   Word16 *fp1;
+   Word16 i, n;
+   
+   if (!DSPOP_GUARD(m <= LPCO && (Word64)dsp_sumabs(a, (Word16)(m+1))
+      * dsp_maxabs(x-m, (Word16)(lg+m)) <= (Word64)MAX_32 - 32768))
+      return 0;
+   
+   for (i = 0; i <= m; i++)
+      c[i] = a[m-i];
+   
+   for (n = 0; n < lg; n++) {
+      fp1 = x + n - m;
+      a0 = dsp_dotp(fp1, c, (Word16)(m+1), 0);
+      y[n] = dsp_round_shr(a0, (Word16)(16-q));
+   }
+   
+   return 1;
+}
+#endif
+
+void bv32fx_azfilter(
+              Word16 a[],    /* (i) Q12 : prediction coefficients          */
+              Word16 m,      /* (i)     : LPC order                        */
+              Word16 x[],    /* (i) Q0  : input signal samples, incl. past */
+              Word16 y[],    /* (o) Q0  : filtered output signal           */
+              Word16 lg      /* (i)     : size of filtering                */
+              )
+{
+   Word16 i, n;
+   Word32 a0;
+   Word16 *fp1;
+   
+   WMOPS_ENTER("bv32fx_azfilter");
+
+#if DSPOP
+   if (azfilter_dsp(a, m, 4, x, y, lg)) {
+      WMOPS_LEAVE();
+      return;
+   }
+#endif
+   
+   /* loop through every element of the current vector */
+   for (n = 0; n < lg; n++) {
+      
+      /* perform multiply-adds along the delay line of filter */
+      fp1 = x + n;
+      a0 = L_mult0(a[0], *fp1--); // Q12
+      for (i = 1; i <= m; i++)
+         a0 = L_mac0(a0, a[i], *fp1--); // Q12
+      
+      /* get the output with rounding */
+      y[n] = round(L_shl(a0, 4)); // Q0
+   }
+
+   WMOPS_LEAVE();
+   return;
+}
+
+void azfilterQ0_Q1(
+              Word16 a[],    /* (i) Q12 : prediction coefficients          */
+              Word16 m,      /* (i)     : LPC order                        */
+              Word16 x[],    /* (i) Q0  : input signal samples, incl. past */
+              Word16 y[],    /* (o) Q1  : filtered output signal           */
+              Word16 lg      /* (i)     : size of filtering                */
+              )
+{
+   Word16 i, n;
+   Word32 a0;
+   Word16 *fp1;
+   
+   WMOPS_ENTER("azfilterQ0_Q1");
+
+#if DSPOP
+   if (azfilter_dsp(a, m, 5, x, y, lg)) {
+      WMOPS_LEAVE();
+      return;
+   }
+#endif
+   
+   /* loop through every element of the current vector */
+   for (n = 0; n < lg; n++) {
+      
+      /* perform multiply-adds along the delay line of filter */
+      fp1 = x + n;
+      a0 = L_mult0(a[0], *fp1--); // Q12
+      for (i = 1; i <= m; i++)
+         a0 = L_mac0(a0, a[i], *fp1--); // Q12
+      
+      /* get the output with rounding */
+      y[n] = round(L_shl(a0, 5)); // Q1
+   }
+
+   WMOPS_LEAVE();
+   return;
+}
+
+/* The codec's filters always have order LPCO or 1: the same filters */
+/* with the taps written out, identical to azfilterQ0_Q1() and       */
+/* bv32fx_azfilter() with m = LPCO and m = 1.                               */
+
+#if LPCO != 8
+#error the unrolled taps below are for LPCO = 8
+#endif
+
+void azfilterQ0_Q1_lpco(
+              Word16 a[],    /* (i) Q12 : prediction coefficients          */
+              Word16 x[],    /* (i) Q0  : input signal samples, incl. past */
+              Word16 y[],    /* (o) Q1  : filtered output signal           */
+              Word16 lg      /* (i)     : size of filtering                */
+              )
+{
+   Word32 a0;
+   Word16 *p;
+   Word16 n;
+#if DSPOP
+   Word16 c[LPCO];
+   Word16x2 c01, c23, c45, c67;
+   Word16 i;
+#endif
+   
+   WMOPS_ENTER("azfilterQ0_Q1_lpco");
+   
+#if DSPOP
+   /* no partial sum can saturate: the packed path for every sample */
+   if (DSPOP_GUARD((Word64)dsp_sumabs(a, LPCO+1)
+      * dsp_maxabs(x-LPCO, (Word16)(lg+LPCO)) <= (Word64)MAX_32 - 32768)) {
+      for (i = 0; i < LPCO; i++)
+         c[i] = a[LPCO-i];
+      c01 = dsp_ld2(c);
+      c23 = dsp_ld2(c+2);
+      c45 = dsp_ld2(c+4);
+      c67 = dsp_ld2(c+6);
+      for (n = 0; n < lg; n++) {
+         p = x + n - LPCO;
+         a0 = a[0]*(Word32)p[LPCO];
+         a0 = dsp_smlad(dsp_ld2(p), c01, a0);
+         a0 = dsp_smlad(dsp_ld2(p+2), c23, a0);
+         a0 = dsp_smlad(dsp_ld2(p+4), c45, a0);
+         a0 = dsp_smlad(dsp_ld2(p+6), c67, a0);
+         y[n] = dsp_round_shr(a0, 11);
+      }
+      WMOPS_LEAVE();
+      return;
+   }
+#endif
+   
+   for (n = 0; n < lg; n++) {
+      p = x + n;
+      a0 = L_mult0(a[0], p[0]);
+      a0 = L_mac0(a0, a[1], p[-1]); a0 = L_mac0(a0, a[2], p[-2]);
+      a0 = L_mac0(a0, a[3], p[-3]); a0 = L_mac0(a0, a[4], p[-4]);
+      a0 = L_mac0(a0, a[5], p[-5]); a0 = L_mac0(a0, a[6], p[-6]);
+      a0 = L_mac0(a0, a[7], p[-7]); a0 = L_mac0(a0, a[8], p[-8]);
+      y[n] = round(L_shl(a0, 5)); // Q1
+   }
+   WMOPS_LEAVE();
+}
+
+/* y may be x: the past input sample is kept aside */
+void azfilter_1(
+              Word16 a[],    /* (i) Q12 : prediction coefficients          */
+              Word16 x[],    /* (i) Q0  : input signal samples, incl. past */
+              Word16 y[],    /* (o) Q0  : filtered output signal           */
+              Word16 lg      /* (i)     : size of filtering                */
+              )
+{
+   Word32 a0;
+   Word16 s, t;
+   Word16 n;
+#if DSPOP
+   Word16 fast;
+#endif
+   
+   WMOPS_ENTER("azfilter_1");
+   
+#if DSPOP
+   fast = DSPOP_GUARD((Word64)dsp_sumabs(a, 2)
+      * dsp_maxabs(x-1, (Word16)(lg+1)) <= (Word64)MAX_32 - 32768);
+#endif
+   
+   s = x[-1];
+   for (n = 0; n < lg; n++) {
+      t = x[n];
+#if DSPOP
+      if (fast) {
+         a0 = a[0]*(Word32)t + a[1]*(Word32)s;
+         y[n] = dsp_round_shr(a0, 12);
+      }
+      else
+#endif
+      {
+         a0 = L_mac0(L_mult0(a[0], t), a[1], s);
+         y[n] = round(L_shl(a0, 4)); // Q0
+      }
+      s = t;
+   }
+   WMOPS_LEAVE();
+}
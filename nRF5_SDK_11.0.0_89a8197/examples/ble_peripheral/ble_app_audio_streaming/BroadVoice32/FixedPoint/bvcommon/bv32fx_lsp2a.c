@@ -20,7 +20,7 @@
 
 
 /*****************************************************************************
-  lsp2a.c : Common Fixed-Point Library: conversion from lsp's to a's
+  bv32fx_lsp2a.c : Common Fixed-Point Library: conversion from lsp's to a's
 
   $Log$
 ******************************************************************************/
@@ -34,13 +34,15 @@ void get_pq_polynomials(
                         Word32 *f,     /* Q23 */
                         Word16 *lsp);  /* Q15 */
 
-void lsp2a(
+void bv32fx_lsp2a(
            Word16 lsp[],    /* (i) Q15 : line spectral pairs                  */
            Word16 a[])      /* (o) Q12 : predictor coefficients (order = 10)  */
 {
    Word32 p[LPCO+1], q[LPCO+1]; // Q23
    Word32 a0;
    Word16 i, n;
+   
+   WMOPS_ENTER("bv32fx_lsp2a");
 
    get_pq_polynomials(p, lsp);
    get_pq_polynomials(q, lsp+1);
@@ -55,6 +57,7 @@ void lsp2a(
       a[n] = round(L_shl(a0,4)); // Q12 a[n] = 0.5 * (p[i] + p[n] + q[n] - q[i]);
    }
 
+   WMOPS_LEAVE();
    return;
 }
 
@@ -29,7 +29,7 @@
 #include "bvcommon.h"
 #include "basop32.h"
 
-void stblz_lsp(
+void bv32fx_stblz_lsp(
                Word16   *lsp,       /* Q15 */
                Word16   order)
 {
@@ -42,6 +42,8 @@ void stblz_lsp(
    Word16 k, i;
    Word16 mintmp, maxtmp, a0;
    
+   WMOPS_ENTER("bv32fx_stblz_lsp");
+   
    /* order lsps as minimum stability requirement */
    do {
       k = 0;              /* use k as a flag for order reversal */
@@ -77,10 +79,11 @@ void stblz_lsp(
       
    }
    
+   WMOPS_LEAVE();
    return;
 }
 
-Word16 stblchck(
+Word16 bv32fx_stblchck(
                 Word16 *x,
                 Word16 vdim)
 {
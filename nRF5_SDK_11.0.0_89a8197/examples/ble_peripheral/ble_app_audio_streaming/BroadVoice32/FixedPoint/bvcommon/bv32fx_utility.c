@@ -26,19 +26,28 @@
 ******************************************************************************/
 
 #include "typedef.h"
+#include "dspop.h"
+#include "wmops.h"
+
+#if DSPOP_COUNT
+struct DSPOP_Count dspop_count;
+#endif
 
 void W16copy(Word16 *y, Word16 *x, int size)
 {
+   WMOPS_MOVE(size);
    while ((size--)>0) *y++ = *x++;
 }
 
 void W16zero(Word16 *x, int size)
 {
+   WMOPS_MOVE(size);
    while ((size--)>0) *x++ = 0;
 }
 
 void W32copy(Word32 *y, Word32 *x, int size)
 {
+   WMOPS_MOVE(2*size);
    while ((size--)>0) *y++ = *x++;
 }
 
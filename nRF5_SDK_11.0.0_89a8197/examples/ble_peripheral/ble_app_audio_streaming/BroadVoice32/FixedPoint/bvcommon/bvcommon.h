@@ -51,11 +51,11 @@ extern   Word16   STWAL[];
 extern   Word16   invk[];
 
 /* Pitch tap codebook - actually content different for BV16 and BV32 */
-extern Word16 pp9cb[];
+extern Word16 bv32fx_pp9cb[];
 
 /* Function prototypes */
 
-void azfilter(
+void bv32fx_azfilter(
               Word16 a[],    /* (i) Q12 : prediction coefficients          */
               Word16 m,      /* (i)     : LPC order                        */
               Word16 x[],    /* (i) Q0  : input signal samples, incl. past */
@@ -71,7 +71,7 @@ void azfilterQ0_Q1(
               Word16 lg      /* (i)     : size of filtering                */
               );
 
-void apfilter(
+void bv32fx_apfilter(
               Word16 a[],     /* (i) Q12 : prediction coefficients  */
               Word16 m,       /* (i)     : LPC order                */
               Word16 x[],     /* (i) Q0  : input signal             */
@@ -91,15 +91,57 @@ void apfilterQ1_Q0(
               Word16 update   /* (i)     : memory update flag       */
               );
 
-void lsp2a(
+/* the above for the orders the codec uses, the taps unrolled */
+void azfilter_1(
+              Word16 a[],    /* (i) Q12 : prediction coefficients          */
+              Word16 x[],    /* (i) Q0  : input signal samples, incl. past */
+              Word16 y[],    /* (o) Q0  : filtered output signal           */
+              Word16 lg      /* (i)     : size of filtering                */
+              );
+
+void azfilterQ0_Q1_lpco(
+              Word16 a[],    /* (i) Q12 : prediction coefficients          */
+              Word16 x[],    /* (i) Q0  : input signal samples, incl. past */
+              Word16 y[],    /* (o) Q1  : filtered output signal           */
+              Word16 lg      /* (i)     : size of filtering                */
+              );
+
+void apfilter_1(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 x[],     /* (i) Q0  : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering        */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              );
+
+void apfilter_lpco(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 x[],     /* (i) Q0  : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering, >= LPCO */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              );
+
+void apfilterQ1_Q0_lpco(
+              Word16 a[],     /* (i) Q12 : prediction coefficients  */
+              Word16 x[],     /* (i) Q1  : input signal             */
+              Word16 y[],     /* (o) Q0  : output signal            */
+              Word16 lg,      /* (i)     : size of filtering, >= LPCO */
+              Word16 mem[],   /* (i/o) Q0: filter memory            */
+              Word16 update   /* (i)     : memory update flag       */
+              );
+
+void bv32fx_lsp2a(
 Word16 lsp[],    /* (i) Q15 : line spectral frequencies            */
 Word16 a[]);     /* (o) Q12 : predictor coefficients (order = 10)  */
 
-void stblz_lsp(
+void bv32fx_stblz_lsp(
 Word16  *lsp,       /* Q15 */
 Word16  order);
 
-Word16 stblchck(
+Word16 bv32fx_stblchck(
 Word16 *x,
 Word16 vdim);
 
@@ -115,6 +157,13 @@ Word16   window[],   /* (i) : LPC Analysis window  */
 Word16   l_window,   /* (i) : window length     */
 Word16   m);      /* (i) : LPC order      */    
 
+void Crosscorr(
+Word32   r[],     /* (o) : r[k] = sum x[n]*y[n-k], n = 0..l-1 */
+Word16   x[],     /* (i) : target signal x[0..l-1]            */
+Word16   y[],     /* (i) : signal y[-(nlag-1)..l-1]           */
+Word16   l,       /* (i) : correlation length                 */
+Word16   nlag);   /* (i) : number of lags, k = 0..nlag-1      */
+
 void Spectral_Smoothing(
 Word16 m,         /* (i)     : LPC order                    */
 Word32 rl[],      /* (i/o)   : Autocorrelations  lags       */
@@ -0,0 +1,272 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  dspop.h : Common Fixed-Point Library: packed dual 16-bit operators
+
+  Primitives of the ARMv7E-M DSP extension (Cortex-M4): dual 16x16
+  multiply-accumulate on two Word16 packed in one word, 32x16 multiply,
+  and saturating add, subtract and narrowing. They map onto the ACLE
+  intrinsics when the compiler targets the DSP extension, and onto a C
+  emulation with the same results everywhere else.
+
+  Unlike the basic operators, the multiply-accumulates do not saturate
+  at each step. A kernel may only use them where it has checked that no
+  partial sum of the basic-operator version can leave the Word32 range;
+  the results are then identical. DSPOP=0 disables the packed kernels,
+  and is the default in a WMOPS=1 build, which counts basic operators.
+
+  With DSPOP_COUNT=1 the emulation counts the primitives it executes, so
+  that the instruction mix can be checked on the host (not reentrant).
+
+  $Log$
+******************************************************************************/
+
+#ifndef __DSPOP_H__
+#define __DSPOP_H__
+
+#include <string.h>
+
+#ifndef DSPOP
+#if WMOPS
+#define DSPOP 0
+#else
+#define DSPOP 1
+#endif
+#endif
+
+#ifndef DSPOP_COUNT
+#define DSPOP_COUNT 0
+#endif
+
+#if defined(__ARM_FEATURE_DSP) && !DSPOP_COUNT
+#define DSPOP_ARM 1
+#include <arm_acle.h>
+#else
+#define DSPOP_ARM 0
+#endif
+
+#ifndef DSPOP_INLINE
+#define DSPOP_INLINE static __inline
+#endif
+
+typedef UWord32   Word16x2;   /* two Word16, the lower address in the low half */
+typedef long long Word64;
+
+#if DSPOP_COUNT
+struct DSPOP_Count {
+   long smlad;    /* dual 16x16 multiply-accumulate, 32-bit accumulator */
+   long smlald;   /* dual 16x16 multiply-accumulate, 64-bit accumulator */
+   long smlawb;   /* 32x16 multiply-accumulate, upper 32 bits of product */
+   long qadd;     /* saturating 32-bit add or subtract */
+   long ssat;     /* saturation to 16 bits */
+   long guard;    /* kernel calls that passed the no-overflow check */
+   long fallback; /* kernel calls that fell back to the basic operators */
+};
+extern struct DSPOP_Count dspop_count;
+#define DSPOP_INC(op)   (dspop_count.op++)
+#else
+#define DSPOP_INC(op)
+#endif
+
+/* load two adjacent Word16 (any alignment, the Cortex-M4 handles it) */
+DSPOP_INLINE Word16x2 dsp_ld2(const Word16 *p)
+{
+   Word16x2 x;
+
+   memcpy(&x, p, sizeof(x));
+   return x;
+}
+
+/* acc + x.lo*y.lo + x.hi*y.hi */
+DSPOP_INLINE Word32 dsp_smlad(Word16x2 x, Word16x2 y, Word32 acc)
+{
+   DSPOP_INC(smlad);
+#if DSPOP_ARM
+   return (Word32)__smlad(x, y, acc);
+#else
+   return (Word32)((UWord32)acc
+      + (UWord32)((Word32)(Word16)x * (Word16)y)
+      + (UWord32)((Word32)(Word16)(x >> 16) * (Word16)(y >> 16)));
+#endif
+}
+
+/* acc + x.lo*y.lo + x.hi*y.hi, 64-bit accumulator */
+DSPOP_INLINE Word64 dsp_smlald(Word16x2 x, Word16x2 y, Word64 acc)
+{
+   DSPOP_INC(smlald);
+#if DSPOP_ARM
+   return (Word64)__smlald(x, y, acc);
+#else
+   return acc + (Word32)(Word16)x * (Word16)y
+              + (Word32)(Word16)(x >> 16) * (Word16)(y >> 16);
+#endif
+}
+
+/* acc + (a * y.lo) >> 16 */
+DSPOP_INLINE Word32 dsp_smlawb(Word32 a, Word16x2 y, Word32 acc)
+{
+   DSPOP_INC(smlawb);
+#if DSPOP_ARM
+   return (Word32)__smlawb(a, y, acc);
+#else
+   return (Word32)((UWord32)acc + (UWord32)(Word32)(((Word64)a * (Word16)y) >> 16));
+#endif
+}
+
+/* saturating a + b */
+DSPOP_INLINE Word32 dsp_qadd(Word32 a, Word32 b)
+{
+   DSPOP_INC(qadd);
+#if DSPOP_ARM
+   return __qadd(a, b);
+#else
+   {
+      Word64 s = (Word64)a + b;
+
+      if (s > (Word64)0x7fffffffL)
+         return (Word32)0x7fffffffL;
+      if (s < -(Word64)0x80000000L)
+         return (Word32)0x80000000L;
+      return (Word32)s;
+   }
+#endif
+}
+
+/* saturating a - b */
+DSPOP_INLINE Word32 dsp_qsub(Word32 a, Word32 b)
+{
+   DSPOP_INC(qadd);
+#if DSPOP_ARM
+   return __qsub(a, b);
+#else
+   {
+      Word64 s = (Word64)a - b;
+
+      if (s > (Word64)0x7fffffffL)
+         return (Word32)0x7fffffffL;
+      if (s < -(Word64)0x80000000L)
+         return (Word32)0x80000000L;
+      return (Word32)s;
+   }
+#endif
+}
+
+/* saturate to the Word16 range */
+DSPOP_INLINE Word16 dsp_ssat16(Word32 a)
+{
+   DSPOP_INC(ssat);
+#if DSPOP_ARM
+   return (Word16)__ssat(a, 16);
+#else
+   if (a > 32767)
+      return 32767;
+   if (a < -32768)
+      return -32768;
+   return (Word16)a;
+#endif
+}
+
+/* round(L_shl(a, 16-n)) for 0 < n < 16 and |a| < 2^31 - 2^(n-1) */
+DSPOP_INLINE Word16 dsp_round_shr(Word32 a, Word16 n)
+{
+   return dsp_ssat16((a + ((Word32)1 << (n - 1))) >> n);
+}
+
+/* sum of |a[i]|, i = 0..m-1 */
+DSPOP_INLINE Word32 dsp_sumabs(const Word16 *a, Word16 m)
+{
+   Word32 s = 0;
+   Word16 i;
+
+   for (i = 0; i < m; i++)
+      s += (a[i] < 0) ? -(Word32)a[i] : a[i];
+   return s;
+}
+
+/* largest |x[i]|, i = 0..n-1 */
+DSPOP_INLINE Word32 dsp_maxabs(const Word16 *x, Word16 n)
+{
+   Word32 s = 0, t;
+   Word16 i;
+
+   for (i = 0; i < n; i++) {
+      t = (x[i] < 0) ? -(Word32)x[i] : x[i];
+      if (t > s)
+         s = t;
+   }
+   return s;
+}
+
+/* acc + sum x[i]*c[i], i = 0..n-1, two products at a time */
+DSPOP_INLINE Word32 dsp_dotp(const Word16 *x, const Word16 *c, Word16 n, Word32 acc)
+{
+   Word16 i;
+
+   for (i = 0; i < n-1; i += 2)
+      acc = dsp_smlad(dsp_ld2(x+i), dsp_ld2(c+i), acc);
+   if (i < n)
+      acc = dsp_smlad((Word16x2)(x[i] & 0xffff), (Word16x2)(c[i] & 0xffff), acc);
+   return acc;
+}
+
+/* acc[0] + sum x[i]*y[i] and acc[1] + sum x[i]*y[i-1], i = 0..n-1: two */
+/* adjacent lags of a correlation, sharing the loads of x               */
+DSPOP_INLINE void dsp_dotp2(Word32 acc[2], const Word16 *x, const Word16 *y, Word16 n)
+{
+   Word16x2 xx;
+   Word32 s0 = acc[0], s1 = acc[1];
+   Word16 i;
+
+   for (i = 0; i < n-1; i += 2) {
+      xx = dsp_ld2(x+i);
+      s0 = dsp_smlad(xx, dsp_ld2(y+i), s0);
+      s1 = dsp_smlad(xx, dsp_ld2(y+i-1), s1);
+   }
+   if (i < n) {
+      xx = (Word16x2)(x[i] & 0xffff);
+      s0 = dsp_smlad(xx, (Word16x2)(y[i] & 0xffff), s0);
+      s1 = dsp_smlad(xx, (Word16x2)(y[i-1] & 0xffff), s1);
+   }
+   acc[0] = s0;
+   acc[1] = s1;
+}
+
+/* sum x[i]*x[i], i = 0..n-1, without saturation */
+DSPOP_INLINE Word64 dsp_sumsq(const Word16 *x, Word16 n)
+{
+   Word64 e = 0;
+   Word16 i;
+
+   for (i = 0; i < n-1; i += 2)
+      e = dsp_smlald(dsp_ld2(x+i), dsp_ld2(x+i), e);
+   if (i < n)
+      e = dsp_smlald((Word16x2)(x[i] & 0xffff), (Word16x2)(x[i] & 0xffff), e);
+   return e;
+}
+
+#if DSPOP_COUNT
+#define DSPOP_GUARD(ok) ((ok) ? (dspop_count.guard++, 1) : (dspop_count.fallback++, 0))
+#else
+#define DSPOP_GUARD(ok) (ok)
+#endif
+
+#endif /* __DSPOP_H__ */
@@ -40,6 +40,8 @@ void Levinson(
    Word16 a_hi[LPCO+1], a_lo[LPCO+1], anew_hi[LPCO+1], anew_lo[LPCO+1];
    Word16 rc_hi, rc_lo;
    Word32 a0, a1, alpha_man;
+   
+   WMOPS_ENTER("Levinson");
 
    /* Normalization of autocorrelation coefficients */
    exp = norm_l(r32[0]);
@@ -101,6 +103,7 @@ void Levinson(
          for(j=1; j<=m; j++)
             a[j] = old_a[j];
 
+         WMOPS_LEAVE();
          return;
       }
       
@@ -141,5 +144,6 @@ void Levinson(
       old_a[j] = a[j];
    }
 
+   WMOPS_LEAVE();
    return;
 }
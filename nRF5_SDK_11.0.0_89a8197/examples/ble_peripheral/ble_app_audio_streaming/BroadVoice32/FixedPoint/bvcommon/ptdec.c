@@ -27,6 +27,7 @@
 
 #include "typedef.h"
 #include "bvcommon.h"
+#include "wmops.h"
 
 void pp3dec(
             Word16   idx,
@@ -34,7 +35,10 @@ void pp3dec(
 {
    Word16   *fp;
    Word16   i;
-   fp = pp9cb+idx*9;
+   
+   WMOPS_ENTER("pp3dec");
+   fp = bv32fx_pp9cb+idx*9;
    for (i=0;i<3;i++) 
       b[i] = *fp++;
+   WMOPS_LEAVE();
 }
@@ -0,0 +1,312 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  simdop.c : Common Fixed-Point Library: host SIMD kernels
+
+  The L_mac0 chains replaced here only add non-negative terms, so their
+  saturated result is min(sum, MAX_32) whatever the order. _mm_madd_epi16
+  gives pairs of such terms as unsigned 32-bit lanes of at most 2^31;
+  the lanes are summed pairwise, each partial sum clamped to MAX_32,
+  which gives the same result without 64-bit arithmetic.
+
+  $Log$
+******************************************************************************/
+
+#include <string.h>
+#include "typedef.h"
+#include "simdop.h"
+
+#if SIMDOP
+
+#include <immintrin.h>
+
+#define SSE41 __attribute__((target("sse4.1")))
+#define AVX2  __attribute__((target("avx2")))
+
+Word16 simd_isa(void)
+{
+   if (__builtin_cpu_supports("avx2"))
+      return 2;
+   if (__builtin_cpu_supports("sse4.1"))
+      return 1;
+   return 0;
+}
+
+/*****************************************************************************
+  SSE4.1
+******************************************************************************/
+
+/* min(lane0 + lane1 + lane2 + lane3, MAX_32), lanes taken as unsigned */
+static SSE41 __inline Word32 satsum4_sse41(__m128i m)
+{
+   const __m128i lim = _mm_set1_epi32(0x7fffffff);
+
+   m = _mm_min_epu32(m, lim);
+   m = _mm_min_epu32(_mm_add_epi32(m, _mm_shuffle_epi32(m, 0x4e)), lim);
+   m = _mm_min_epu32(_mm_add_epi32(m, _mm_shuffle_epi32(m, 0xb1)), lim);
+   return _mm_cvtsi128_si32(m);
+}
+
+/* lanes 0..vdim-1 set */
+static SSE41 __inline __m128i mask_sse41(Word16 vdim)
+{
+   return _mm_cmpgt_epi16(_mm_set1_epi16(vdim), _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+/* codevector j, padded to 8 lanes without reading past the codebook */
+static SSE41 __inline __m128i row_sse41(const Word16 *cb, Word16 j, Word16 vdim, Word16 cbsz)
+{
+   Word16 t[8];
+
+   if (j*vdim + 8 <= cbsz*vdim)
+      return _mm_loadu_si128((const __m128i *)(cb + j*vdim));
+   memset(t, 0, sizeof(t));
+   memcpy(t, cb + j*vdim, vdim*sizeof(Word16));
+   return _mm_loadu_si128((const __m128i *)t);
+}
+
+static SSE41 __inline __m128i vec_sse41(const Word16 *x, Word16 vdim)
+{
+   Word16 t[8];
+
+   memset(t, 0, sizeof(t));
+   memcpy(t, x, vdim*sizeof(Word16));
+   return _mm_loadu_si128((const __m128i *)t);
+}
+
+static SSE41 Word32 dotp_sse41(const Word16 *x, const Word16 *y, Word16 n)
+{
+   __m128i acc = _mm_setzero_si128();
+   Word32 s;
+   Word16 i;
+
+   for (i = 0; i + 8 <= n; i += 8)
+      acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(x+i)),
+                                              _mm_loadu_si128((const __m128i *)(y+i))));
+   acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0x4e));
+   acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, 0xb1));
+   s = _mm_cvtsi128_si32(acc);
+   for (; i < n; i++)
+      s = (Word32)((UWord32)s + (UWord32)(x[i]*y[i]));
+   return s;
+}
+
+static SSE41 void vqmse_sse41(Word32 *d, const Word16 *x, const Word16 *cb, Word16 vdim, Word16 cbsz)
+{
+   __m128i xv = vec_sse41(x, vdim), mask = mask_sse41(vdim), e;
+   Word16 j;
+
+   for (j = 0; j < cbsz; j++) {
+      e = _mm_and_si128(_mm_subs_epi16(xv, row_sse41(cb, j, vdim, cbsz)), mask);
+      d[j] = satsum4_sse41(_mm_madd_epi16(e, e));
+   }
+}
+
+static SSE41 void vqwmse_sse41(Word32 *d, const Word16 *x, const Word16 *w, const Word16 *cb,
+                               Word16 vdim, Word16 cbsz)
+{
+   __m128i xv = vec_sse41(x, vdim), wv = vec_sse41(w, vdim), mask = mask_sse41(vdim), t;
+   Word16 j;
+
+   for (j = 0; j < cbsz; j++) {
+      t = _mm_subs_epi16(xv, _mm_srai_epi16(row_sse41(cb, j, vdim, cbsz), 1));
+      t = _mm_and_si128(t, mask);
+      d[j] = satsum4_sse41(_mm_madd_epi16(_mm_mulhi_epi16(wv, t), t));
+   }
+}
+
+static SSE41 void vqe4_sse41(Word32 *E, const Word16 *q, const Word16 *zsr, Word16 cbsz)
+{
+   const __m128i lim = _mm_set1_epi32(0x7fffffff);
+   __m128i qv, z, mp, mn;
+   Word16 j;
+
+   /* shl(q,2), for two codevectors at a time */
+   qv = _mm_loadl_epi64((const __m128i *)q);
+   qv = _mm_adds_epi16(qv, qv);
+   qv = _mm_adds_epi16(qv, qv);
+   qv = _mm_unpacklo_epi64(qv, qv);
+
+   for (j = 0; j < cbsz; j += 2) {
+      z  = _mm_loadu_si128((const __m128i *)(zsr + 4*j));
+      mp = _mm_subs_epi16(qv, z);
+      mn = _mm_adds_epi16(qv, z);
+      mp = _mm_min_epu32(_mm_madd_epi16(mp, mp), lim);
+      mn = _mm_min_epu32(_mm_madd_epi16(mn, mn), lim);
+      mp = _mm_min_epu32(_mm_add_epi32(mp, _mm_shuffle_epi32(mp, 0xb1)), lim);
+      mn = _mm_min_epu32(_mm_add_epi32(mn, _mm_shuffle_epi32(mn, 0xb1)), lim);
+      /* interleave to E[2j], E[2j+1], E[2j+2], E[2j+3] */
+      _mm_storeu_si128((__m128i *)(E + 2*j), _mm_blend_epi16(mp, _mm_slli_epi64(mn, 32), 0xcc));
+   }
+}
+
+/*****************************************************************************
+  AVX2: the same, two 128-bit halves at a time
+******************************************************************************/
+
+static AVX2 __inline __m256i satsum4x2_avx2(__m256i m)
+{
+   const __m256i lim = _mm256_set1_epi32(0x7fffffff);
+
+   m = _mm256_min_epu32(m, lim);
+   m = _mm256_min_epu32(_mm256_add_epi32(m, _mm256_shuffle_epi32(m, 0x4e)), lim);
+   m = _mm256_min_epu32(_mm256_add_epi32(m, _mm256_shuffle_epi32(m, 0xb1)), lim);
+   return m;
+}
+
+static AVX2 __inline __m256i rows_avx2(const Word16 *cb, Word16 j, Word16 vdim, Word16 cbsz)
+{
+   return _mm256_inserti128_si256(_mm256_castsi128_si256(row_sse41(cb, j, vdim, cbsz)),
+                                  row_sse41(cb, (Word16)(j+1), vdim, cbsz), 1);
+}
+
+static AVX2 Word32 dotp_avx2(const Word16 *x, const Word16 *y, Word16 n)
+{
+   __m256i acc = _mm256_setzero_si256();
+   __m128i a;
+   Word32 s;
+   Word16 i;
+
+   for (i = 0; i + 16 <= n; i += 16)
+      acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)(x+i)),
+                                                    _mm256_loadu_si256((const __m256i *)(y+i))));
+   a = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+   for (; i + 8 <= n; i += 8)
+      a = _mm_add_epi32(a, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(x+i)),
+                                          _mm_loadu_si128((const __m128i *)(y+i))));
+   a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0x4e));
+   a = _mm_add_epi32(a, _mm_shuffle_epi32(a, 0xb1));
+   s = _mm_cvtsi128_si32(a);
+   for (; i < n; i++)
+      s = (Word32)((UWord32)s + (UWord32)(x[i]*y[i]));
+   return s;
+}
+
+static AVX2 void vqmse_avx2(Word32 *d, const Word16 *x, const Word16 *cb, Word16 vdim, Word16 cbsz)
+{
+   __m128i x1 = vec_sse41(x, vdim), m1 = mask_sse41(vdim);
+   __m256i xv = _mm256_broadcastsi128_si256(x1), mask = _mm256_broadcastsi128_si256(m1), e;
+   Word16 j;
+
+   for (j = 0; j + 2 <= cbsz; j += 2) {
+      e = _mm256_and_si256(_mm256_subs_epi16(xv, rows_avx2(cb, j, vdim, cbsz)), mask);
+      e = satsum4x2_avx2(_mm256_madd_epi16(e, e));
+      d[j]   = _mm256_extract_epi32(e, 0);
+      d[j+1] = _mm256_extract_epi32(e, 4);
+   }
+   if (j < cbsz)
+      vqmse_sse41(d + j, x, cb + j*vdim, vdim, (Word16)(cbsz - j));
+}
+
+static AVX2 void vqwmse_avx2(Word32 *d, const Word16 *x, const Word16 *w, const Word16 *cb,
+                             Word16 vdim, Word16 cbsz)
+{
+   __m256i xv = _mm256_broadcastsi128_si256(vec_sse41(x, vdim));
+   __m256i wv = _mm256_broadcastsi128_si256(vec_sse41(w, vdim));
+   __m256i mask = _mm256_broadcastsi128_si256(mask_sse41(vdim)), t;
+   Word16 j;
+
+   for (j = 0; j + 2 <= cbsz; j += 2) {
+      t = _mm256_subs_epi16(xv, _mm256_srai_epi16(rows_avx2(cb, j, vdim, cbsz), 1));
+      t = _mm256_and_si256(t, mask);
+      t = satsum4x2_avx2(_mm256_madd_epi16(_mm256_mulhi_epi16(wv, t), t));
+      d[j]   = _mm256_extract_epi32(t, 0);
+      d[j+1] = _mm256_extract_epi32(t, 4);
+   }
+   if (j < cbsz)
+      vqwmse_sse41(d + j, x, w, cb + j*vdim, vdim, (Word16)(cbsz - j));
+}
+
+static AVX2 void vqe4_avx2(Word32 *E, const Word16 *q, const Word16 *zsr, Word16 cbsz)
+{
+   const __m256i lim = _mm256_set1_epi32(0x7fffffff);
+   __m128i q1;
+   __m256i qv, z, mp, mn;
+   Word16 j;
+
+   q1 = _mm_loadl_epi64((const __m128i *)q);
+   q1 = _mm_adds_epi16(q1, q1);
+   q1 = _mm_adds_epi16(q1, q1);
+   qv = _mm256_broadcastq_epi64(q1);
+
+   for (j = 0; j + 4 <= cbsz; j += 4) {
+      z  = _mm256_loadu_si256((const __m256i *)(zsr + 4*j));
+      mp = _mm256_subs_epi16(qv, z);
+      mn = _mm256_adds_epi16(qv, z);
+      mp = _mm256_min_epu32(_mm256_madd_epi16(mp, mp), lim);
+      mn = _mm256_min_epu32(_mm256_madd_epi16(mn, mn), lim);
+      mp = _mm256_min_epu32(_mm256_add_epi32(mp, _mm256_shuffle_epi32(mp, 0xb1)), lim);
+      mn = _mm256_min_epu32(_mm256_add_epi32(mn, _mm256_shuffle_epi32(mn, 0xb1)), lim);
+      _mm256_storeu_si256((__m256i *)(E + 2*j), _mm256_blend_epi16(mp, _mm256_slli_epi64(mn, 32), 0xcc));
+   }
+   if (j < cbsz)
+      vqe4_sse41(E + 2*j, q, zsr + 4*j, (Word16)(cbsz - j));
+}
+
+/*****************************************************************************
+  Dispatch
+******************************************************************************/
+
+Word16 simd_dotp(Word32 *s, const Word16 *x, const Word16 *y, Word16 n)
+{
+   switch (simd_isa()) {
+   case 2:  *s = dotp_avx2(x, y, n);  return 1;
+   case 1:  *s = dotp_sse41(x, y, n); return 1;
+   default: return 0;
+   }
+}
+
+Word16 simd_vqmse_dist(Word32 *d, const Word16 *x, const Word16 *cb, Word16 vdim, Word16 cbsz)
+{
+   if (vdim < 1 || vdim > 8)
+      return 0;
+   switch (simd_isa()) {
+   case 2:  vqmse_avx2(d, x, cb, vdim, cbsz);  return 1;
+   case 1:  vqmse_sse41(d, x, cb, vdim, cbsz); return 1;
+   default: return 0;
+   }
+}
+
+Word16 simd_vqwmse_dist(Word32 *d, const Word16 *x, const Word16 *w, const Word16 *cb,
+                        Word16 vdim, Word16 cbsz)
+{
+   if (vdim < 1 || vdim > 8)
+      return 0;
+   switch (simd_isa()) {
+   case 2:  vqwmse_avx2(d, x, w, cb, vdim, cbsz);  return 1;
+   case 1:  vqwmse_sse41(d, x, w, cb, vdim, cbsz); return 1;
+   default: return 0;
+   }
+}
+
+Word16 simd_vqe4(Word32 *E, const Word16 *q, const Word16 *zsr, Word16 cbsz)
+{
+   if (cbsz & 1)
+      return 0;
+   switch (simd_isa()) {
+   case 2:  vqe4_avx2(E, q, zsr, cbsz);  return 1;
+   case 1:  vqe4_sse41(E, q, zsr, cbsz); return 1;
+   default: return 0;
+   }
+}
+
+#endif
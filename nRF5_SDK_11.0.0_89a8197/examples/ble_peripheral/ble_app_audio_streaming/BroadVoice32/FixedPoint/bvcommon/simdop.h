@@ -0,0 +1,72 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  simdop.h : Common Fixed-Point Library: host SIMD kernels
+
+  SSE4.1 and AVX2 versions of the encoder's vector searches and of the
+  long dot products, for transcoding on x86 hosts. The instruction set
+  is picked at run time. Each kernel returns 0 without doing anything
+  when the CPU has neither, or the arguments are out of its range, and
+  the caller then runs the scalar code. Results are bit-exact with it.
+
+  SIMDOP=0 leaves them out; they are only built with GCC or Clang on
+  x86 and outside a WMOPS=1 build, and are 0 everywhere else.
+
+  $Log$
+******************************************************************************/
+
+#ifndef __SIMDOP_H__
+#define __SIMDOP_H__
+
+#ifndef SIMDOP
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !WMOPS
+#define SIMDOP 1
+#else
+#define SIMDOP 0
+#endif
+#endif
+
+#if SIMDOP
+
+/* instruction set in use: 2 = AVX2, 1 = SSE4.1, 0 = none */
+Word16 simd_isa(void);
+
+/* sum x[i]*y[i], i = 0..n-1, modulo 2^32 like dsp_dotp() */
+Word16 simd_dotp(Word32 *s, const Word16 *x, const Word16 *y, Word16 n);
+
+/* d[j] = sum L_mac0 of e*e, e = sub(x[k],cb[j*vdim+k]), vdim <= 8 */
+Word16 simd_vqmse_dist(Word32 *d, const Word16 *x, const Word16 *cb,
+                       Word16 vdim, Word16 cbsz);
+
+/* d[j] = sum L_mac0 of extract_h(L_mult0(w[k],t))*t, with            */
+/* t = sub(x[k],shr(cb[j*vdim+k],1)), w[k] >= 0 and vdim <= 8         */
+Word16 simd_vqwmse_dist(Word32 *d, const Word16 *x, const Word16 *w,
+                        const Word16 *cb, Word16 vdim, Word16 cbsz);
+
+/* VQ error energies of the excitation search (VDIM = 4): for each    */
+/* codevector j, E[2j] with e = sub(shl(q[k],2),zsr[4j+k]) and        */
+/* E[2j+1] with e = add(shl(q[k],2),zsr[4j+k]), accumulated by L_mac0 */
+Word16 simd_vqe4(Word32 *E, const Word16 *q, const Word16 *zsr, Word16 cbsz);
+
+#endif
+
+#endif /* __SIMDOP_H__ */
@@ -26,6 +26,7 @@
 ******************************************************************************/
 
 #include "typedef.h"
+#include "wmops.h"
 
 void vqdec(
            Word16  *xq,    /* VQ output vector (quantized version of input vector) */
@@ -35,7 +36,10 @@ void vqdec(
 {
    
    Word16   j, k;
+   
+   WMOPS_ENTER("vqdec");
    j = idx * vdim;
    for (k = 0; k < vdim; k++) 
       xq[k] = cb[j + k];
+   WMOPS_LEAVE();
 }
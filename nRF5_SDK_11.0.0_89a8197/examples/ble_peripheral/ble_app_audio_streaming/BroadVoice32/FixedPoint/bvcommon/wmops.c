@@ -0,0 +1,129 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  wmops.c : Common Fixed-Point Library: complexity counters
+
+  Counter 0 takes what is counted outside the marked functions; it is
+  added to the frame that follows.
+
+  $Log$
+******************************************************************************/
+
+#include "typedef.h"
+#include "wmops.h"
+
+#if WMOPS
+
+#include <stdlib.h>
+
+#define MAXFUNC   64
+#define MAXDEPTH  32
+
+static struct WMOPS_Func func[MAXFUNC] = { { "(other)" } };
+static int     nfunc = 1;
+static int     stack[MAXDEPTH];
+static int     depth = 0;
+static long    frames = 0;
+static long    maxframe = 0;
+static double  sumframe = 0.;
+
+struct WMOPS_Func *wmops_cur = &func[0];
+
+static void frame_end(void)
+{
+   struct WMOPS_Func *f;
+   long n, total = 0;
+   int i;
+
+   for (i = 0; i < nfunc; i++) {
+      f = &func[i];
+      n = f->ops + f->moves;
+      if (n > f->maxops)
+         f->maxops = n;
+      f->sumops += f->ops;
+      f->summoves += f->moves;
+      f->sumcalls += f->calls;
+      total += n;
+      f->ops = f->moves = f->calls = 0;
+   }
+   if (total > maxframe)
+      maxframe = total;
+   sumframe += total;
+   frames++;
+}
+
+void wmops_enter(int *id, const char *name)
+{
+   if (*id < 0) {
+      if (nfunc >= MAXFUNC) {
+         fprintf(stderr, "wmops: more than %d functions\n", MAXFUNC);
+         exit(1);
+      }
+      func[nfunc].name = name;
+      *id = nfunc++;
+   }
+   if (depth >= MAXDEPTH) {
+      fprintf(stderr, "wmops: calls nested deeper than %d\n", MAXDEPTH);
+      exit(1);
+   }
+   stack[depth++] = (int)(wmops_cur - func);
+   wmops_cur = &func[*id];
+   wmops_cur->calls++;
+}
+
+void wmops_leave(void)
+{
+   if (depth == 0) {
+      fprintf(stderr, "wmops: unbalanced WMOPS_LEAVE\n");
+      exit(1);
+   }
+   wmops_cur = &func[stack[--depth]];
+   if (depth == 0)
+      frame_end();
+}
+
+/* per frame, and in millions per second at fps frames per second */
+void wmops_report(FILE *fp, double fps)
+{
+   struct WMOPS_Func *f;
+   double n;
+   int i;
+
+   if (frames == 0)
+      return;
+   n = (double)frames;
+   fprintf(fp, "\n Complexity over %ld frames (weighted operators and moves per frame)\n", frames);
+   fprintf(fp, " %-22s %8s %10s %10s %10s %8s %8s\n",
+      "function", "calls", "ops", "moves", "worst", "WMOPS", "worst");
+   for (i = 0; i < nfunc; i++) {
+      f = &func[i];
+      if (f->sumcalls == 0. && f->sumops + f->summoves == 0.)
+         continue;
+      fprintf(fp, " %-22s %8.2f %10.1f %10.1f %10ld %8.3f %8.3f\n",
+         f->name, f->sumcalls/n, f->sumops/n, f->summoves/n, f->maxops,
+         (f->sumops + f->summoves)/n*fps*1e-6, f->maxops*fps*1e-6);
+   }
+   fprintf(fp, " %-22s %8s %10.1f %10s %10ld %8.3f %8.3f\n",
+      "total", "", sumframe/n, "", maxframe, sumframe/n*fps*1e-6, maxframe*fps*1e-6);
+}
+
+#endif
@@ -0,0 +1,78 @@
+/*****************************************************************************/
+/* BroadVoice(R)32 (BV32) Fixed-Point ANSI-C Source Code                     */
+/* Revision Date: October 5, 2012                                            */
+/* Version 1.2                                                               */
+/*****************************************************************************/
+
+/*****************************************************************************/
+/* Copyright 2000-2012 Broadcom Corporation                                  */
+/*                                                                           */
+/* This software is provided under the GNU Lesser General Public License,    */
+/* version 2.1, as published by the Free Software Foundation ("LGPL").       */
+/* This program is distributed in the hope that it will be useful, but       */
+/* WITHOUT ANY SUPPORT OR WARRANTY; without even the implied warranty of     */
+/* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the LGPL for     */
+/* more details.  A copy of the LGPL is available at                         */
+/* http://www.broadcom.com/licenses/LGPLv2.1.php,                            */
+/* or by writing to the Free Software Foundation, Inc.,                      */
+/* 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                 */
+/*****************************************************************************/
+
+
+/*****************************************************************************
+  wmops.h : Common Fixed-Point Library: complexity counters
+
+  With WMOPS=1 every basic operator adds its ITU-T G.191 (STL 2005)
+  weight to the counter of the innermost codec function marked with
+  WMOPS_ENTER(), and the copy utilities count their memory moves (1 per
+  Word16, 2 per Word32). A function's counts are its own, without those
+  of the marked functions it calls. A frame ends whenever the outermost
+  marked function (BV32_Encode, BV32_Decode or BV32_PLC) returns, and
+  the worst and average counts per frame are kept for each function.
+
+  The packed and SIMD kernels are left out of such a build (DSPOP=0,
+  SIMDOP=0), so that the counts are those of the basic operators. The
+  counters are global (not reentrant).
+
+  $Log$
+******************************************************************************/
+
+#ifndef __WMOPS_H__
+#define __WMOPS_H__
+
+#ifndef WMOPS
+#define WMOPS 0
+#endif
+
+#if WMOPS
+
+#include <stdio.h>
+
+struct WMOPS_Func {
+   const char *name;
+   long  ops, moves, calls;      /* in the current frame */
+   double sumops, summoves, sumcalls;
+   long  maxops;                 /* worst frame, operators and moves */
+};
+
+extern struct WMOPS_Func *wmops_cur;
+
+void wmops_enter(int *id, const char *name);
+void wmops_leave(void);
+void wmops_report(FILE *fp, double fps);
+
+#define WMOPS_OPS(n)       (wmops_cur->ops += (n))
+#define WMOPS_MOVE(n)      (wmops_cur->moves += (n))
+#define WMOPS_ENTER(name)  { static int wmops_id = -1; wmops_enter(&wmops_id, name); }
+#define WMOPS_LEAVE()      wmops_leave()
+
+#else
+
+#define WMOPS_OPS(n)
+#define WMOPS_MOVE(n)
+#define WMOPS_ENTER(name)
+#define WMOPS_LEAVE()
+
+#endif
+
+#endif /* __WMOPS_H__ */
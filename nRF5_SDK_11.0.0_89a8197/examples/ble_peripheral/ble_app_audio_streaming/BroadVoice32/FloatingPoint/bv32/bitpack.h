@@ -28,6 +28,8 @@
 #ifndef BITPACK_H
 #define BITPACK_H
 
+#define BV32_PACKED_BYTES  20   /* packed frame size, 160 bits */
+
 void BV32_BitPack(UWord8 * PackedStream, struct BV32_Bit_Stream * BitStruct);
 void BV32_BitUnPack(UWord8 * PackedStream, struct BV32_Bit_Stream * BitStruct);
 
@@ -28,6 +28,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <time.h>
 #include "typedef.h"
 #include "bv32cnst.h"
 #include "bvcommon.h"
@@ -36,9 +38,10 @@
 #include "utility.h"
 #if G192BITSTREAM
 #include "g192.h"
-#else
-#include "bitpack.h"
 #endif
+#include "bitpack.h"
+
+#define NBATCH 32    /* frames decoded per BV32_DecodeFrames() call */
 
 int      frame;
 short   bfi=0;
@@ -46,6 +49,7 @@ short   bfi=0;
 void  usage(char *name)
 {
    fprintf(stderr,"usage: %s enc|dec input output\n", name);
+   fprintf(stderr,"       %s snr reference_speech test_speech\n", name);
    fprintf(stderr,"\nFormat for speech_file:\n    Binary file of 16 kHz sampled 16-bit PCM data.\n");
 #if G192BITSTREAM
    fprintf(stderr,"\nFormat for bitstream_file per frame: ITU-T G.192 format\n\
@@ -58,21 +62,79 @@ void  usage(char *name)
    exit(1);
 }
 
+/* report SNR and segmental SNR of a decoded speech file against a reference */
+int   snr(char *ref, char *tst)
+{
+   FILE     *fr, *ft;
+   short    xr[FRSZ], xt[FRSZ];
+   double   es, en, tes, ten, segsnr, s;
+   int      i, n, nseg;
+   
+   if (!(fr=fopen(ref,"rb"))) 
+   {
+      fprintf(stderr,"error: can't read %s\n", ref);
+      exit(2);
+   }
+   if (!(ft=fopen(tst,"rb"))) 
+   {
+      fprintf(stderr,"error: can't read %s\n", tst);
+      exit(2);
+   }
+   
+   tes = ten = segsnr = 0.0;
+   nseg = 0;
+   while (1)
+   {
+      n = fread(xr, sizeof(short), FRSZ, fr);
+      if (fread(xt, sizeof(short), FRSZ, ft) < n) n = 0;
+      if (n <= 0) break;
+      es = en = 0.0;
+      for (i=0;i<n;i++)
+      {
+         es += (double)xr[i]*xr[i];
+         en += (double)(xr[i]-xt[i])*(xr[i]-xt[i]);
+      }
+      tes += es;
+      ten += en;
+      /* segmental SNR over active frames only, clipped to [0,100] dB */
+      if (es > FRSZ*100.0)
+      {
+         s = (en > 0.0) ? 10.0*log10(es/en) : 100.0;
+         if (s > 100.0) s = 100.0;
+         else if (s < 0.0) s = 0.0;
+         segsnr += s;
+         nseg++;
+      }
+   }
+   fclose(fr);
+   fclose(ft);
+   
+   if (ten > 0.0)
+      fprintf(stdout," SNR    : %.2f dB\n", 10.0*log10(tes/ten));
+   else
+      fprintf(stdout," SNR    : bit-exact\n");
+   if (nseg > 0)
+      fprintf(stdout," SegSNR : %.2f dB\n", segsnr/nseg);
+   
+   return 0;
+}
+
 int   main(int argc, char **argv)
 {
    FILE     *fi, *fo, *fbdi=NULL;
    int      enc=1;
    int      nread, i;
-   short    x[FRSZ];
+   short    x[NBATCH*FRSZ];
    struct	BV32_Bit_Stream bs;
    struct   BV32_Encoder_State cs;
    struct	BV32_Decoder_State ds;
    
-#if !G192BITSTREAM
-   UWord8 PackedStream[20];
-#endif
+   UWord8   PackedStream[NBATCH*BV32_PACKED_BYTES];
+   UWord8   bfis[NBATCH];
+   int      nb=0;
    
    int next_bad_frame=-1;
+   clock_t  t0, tcodec=0;
    
    fprintf(stderr,"/***************************************************************************/\n");
    fprintf(stderr,"/* BroadVoice(R)32, Copyright (c) 2000-12, Broadcom Corporation.           */\n");
@@ -90,6 +152,7 @@ int   main(int argc, char **argv)
    fprintf(stderr,"/***************************************************************************/\n");
    
    if ((argc!=4)&&(argc!=5)) usage(argv[0]);
+   if (!strcmp(argv[1],"snr")) return snr(argv[2], argv[3]);
    if (!strcmp(argv[1],"enc")) enc=1;
    else if (!strcmp(argv[1],"dec")) enc=0;
    else usage(argv[0]);
@@ -165,9 +228,9 @@ int   main(int argc, char **argv)
       {
 #if G192BITSTREAM
          nread = fread_wb_g192bitstrm(&bs, fi);
+         BV32_BitPack (PackedStream+nb*BV32_PACKED_BYTES, &bs ); 
 #else
-         nread = fread(PackedStream, sizeof(UWord8), 20, fi);
-         BV32_BitUnPack (PackedStream, &bs ); 
+         nread = fread(PackedStream+nb*BV32_PACKED_BYTES, sizeof(UWord8), BV32_PACKED_BYTES, fi);
 #endif
          if (nread<=0) goto End;
          if (frame==next_bad_frame) 
@@ -179,26 +242,29 @@ int   main(int argc, char **argv)
       
       /* BV32 CODING */
       
+      t0 = clock();
       if (enc==1) 
       {
          BV32_Encode(&bs, &cs, x);
+         tcodec += clock() - t0;
 #if G192BITSTREAM
          fwrite_wb_g192bitstrm(&bs,fo);
 #else
          BV32_BitPack( PackedStream, &bs );
-         fwrite(PackedStream, sizeof(UWord8), 20, fo);         
+         fwrite(PackedStream, sizeof(UWord8), BV32_PACKED_BYTES, fo);         
 #endif
       } 
       else 
       {
-         if (!bfi) 
-            BV32_Decode(&bs, &ds, x);   
-         else 
+         /* decode a batch of frames at a time, erased ones are concealed */
+         bfis[nb++] = (UWord8)bfi;
+         if (nb == NBATCH) 
          {
-            BV32_PLC(&ds,x); 
+            BV32_DecodeFrames(PackedStream, bfis, nb, &ds, x);
+            fwrite(x, sizeof(short), nb*FRSZ, fo);
+            nb = 0;
          }
-         
-         fwrite(x, sizeof(short), FRSZ, fo);
+         tcodec += clock() - t0;
       }
       
       if (((frame/100)*100)==frame) fprintf(stderr, "\r %d %d-sample frames processed.", frame, FRSZ);
@@ -207,8 +273,19 @@ int   main(int argc, char **argv)
    
 End: ;
      
+     if (nb > 0)
+     {
+        t0 = clock();
+        BV32_DecodeFrames(PackedStream, bfis, nb, &ds, x);
+        tcodec += clock() - t0;
+        fwrite(x, sizeof(short), nb*FRSZ, fo);
+     }
+     
      frame--;
      fprintf(stderr, "\r %d 40-sample frames processed.\n", frame);
+     if (frame > 0)
+        fprintf(stderr, " Average %s time: %.2f us/frame\n", enc ? "encode" : "decode",
+           1e6*(double)tcodec/CLOCKS_PER_SEC/frame);
      
      fclose(fi);
      fclose(fo);
@@ -56,41 +56,41 @@
 #define NVPSSF		(SFRSZ/VDIM)
 
 /* Packetloss Concealment */
-#define ScPLCGmin 0.1
-#define ScPLCGmax 0.9
+#define ScPLCGmin ((Float)0.1)
+#define ScPLCGmax ((Float)0.9)
 #define PePLCGmin 0.5
 #define PePLCGmax 0.9
-#define ScPLCG_b ((ScPLCGmin-ScPLCGmax)/(PePLCGmax-PePLCGmin))
-#define ScPLCG_a (ScPLCGmin-ScPLCG_b*PePLCGmax)
+#define ScPLCG_b ((Float)((ScPLCGmin-ScPLCGmax)/(PePLCGmax-PePLCGmin)))
+#define ScPLCG_a ((Float)(ScPLCGmin-ScPLCG_b*PePLCGmax))
 #define HoldPLCG  8
 #define AttnPLCG 50
-#define AttnFacPLCG (1.0/(Float)AttnPLCG)
+#define AttnFacPLCG ((Float)(1.0/AttnPLCG))
 
 /* Pre-emphasis filter coefficients */
-#define PEAPFC 0.75
-#define PEAZFC	0.5
+#define PEAPFC ((Float)0.75)
+#define PEAZFC	((Float)0.5)
 
-#define INVSFRSZ (1./(Float)SFRSZ)
+#define INVSFRSZ ((Float)(1./SFRSZ))
 #define FECNSF     2            /* number of FEC subframes per frame         */
 
-#define Minlg    -2.      /* minimum log-gain             */
-#define TMinlg    0.25    /* minimum linear gain          */
+#define Minlg    ((Float)-2.)    /* minimum log-gain             */
+#define TMinlg   ((Float)0.25)   /* minimum linear gain          */
 #define GPO      16       /* order of MA prediction       */
 
 /* Level Estimation */
-#define estl_alpha  (8191./8192.)
-#define estl_beta   (1023./1024.)
-#define estl_beta1  (1.-estl_beta)
-#define estl_a      (511./512.)
-#define estl_a1     (1-estl_a)
-#define estl_TH     0.2
+#define estl_alpha  ((Float)(8191./8192.))
+#define estl_beta   ((Float)(1023./1024.))
+#define estl_beta1  ((Float)(1.-estl_beta))
+#define estl_a      ((Float)(511./512.))
+#define estl_a1     ((Float)(1-estl_a))
+#define estl_TH     ((Float)0.2)
 
 /* Log-Gain Limitation */
 #define LGLB   -24      /* Log-Gain Lower Bound */
 #define GCLB    -8      /* Log-Gain Change Lower Bound */
 #define NGB     18      /* Number of Gain Bins */
 #define NGCB    11      /* Number of Gain Change Bins */
-#define MinE -2.0
+#define MinE ((Float)-2.0)
 
 #define PFO     1   /* preemphasis filter order */
 
@@ -26,43 +26,46 @@
 ******************************************************************************/
 
 /* POINTERS */
-extern Float winl[];
-extern Float sstwin[];
-extern int idxord[];
-extern Float hpfa[];
-extern Float hpfb[];
-extern Float adf[];
-extern Float bdf[];
-extern Float x[];
-extern Float x2[];
-extern Float invk[];
-extern Float MPTH[];
+extern const Float winl[];
+extern const Float sstwin[];
+extern const int idxord[];
+extern const Float hpfa[];
+extern const Float hpfb[];
+extern const Float adf[];
+extern const Float bdf[];
+extern const Float x[];
+extern const Float x2[];
+extern const Float invk[];
+extern const Float MPTH[];
 
 
 /* LSP Quantization */
-extern Float  lspecb1[LSPECBSZ1*LPCO];
-extern Float  lspecb21[LSPECBSZ21*SVD1];
-extern Float  lspecb22[LSPECBSZ22*SVD2];
-extern Float  lspmean[LPCO];
-extern Float  lspp[LSPPORDER*LPCO];
+extern const Float  lspecb1[LSPECBSZ1*LPCO];
+extern const Float  lspecb21[LSPECBSZ21*SVD1];
+extern const Float  lspecb22[LSPECBSZ22*SVD2];
+extern const Float  lspmean[LPCO];
+extern const Float  lspp[LSPPORDER*LPCO];
 
 /* Pitch Predictor Codebook */
-extern Float pp9cb[];
+extern const Float pp9cb[];
 
 /* Log-Gain Quantization */
-extern Float  lgpecb[LGPECBSZ];
-extern Float  lgp[LGPORDER];
-extern Float  lgmean;
+extern const Float  lgpecb[LGPECBSZ];
+#if FAST_GAIN
+extern const Float  gpecb[LGPECBSZ];
+#endif
+extern const Float  lgp[LGPORDER];
+extern const Float  lgmean;
 
 /* Log-Gain Limitation */
-extern Float   lgclimit[];
+extern const Float   lgclimit[];
 
 /* Excitation Codebook */
-extern Float  cccb[CBSZ*VDIM];
+extern const Float  cccb[CBSZ*VDIM];
 
-extern Float lgpecb_nh[];
-extern Float a_pre[];
-extern Float b_pre[];
+extern const Float lgpecb_nh[];
+extern const Float a_pre[];
+extern const Float b_pre[];
 
 /* Function Prototypes */
 
@@ -75,7 +78,9 @@ Float   *lmean,
 Float   *x1);
 
 extern void excdec_w_LT_synth(
-	Float   *ltsymd, /* long-term synthesis filter memory at decoder*/
+	Float   *ltsymd, /* long-term synthesis filter memory at decoder (ring) */
+	short   *ltidx, /* ring position of the oldest sample in ltsymd[] */
+	Float   *qv,    /* long-term synthesized excitation of current frame */
 	short   *idx,   /* excitation codebook index array for current subframe */
 	Float   *gainq, /* quantized linear gains for sub-subframes */
 	Float   *b,     /* coefficient of 3-tap pitch predictor */
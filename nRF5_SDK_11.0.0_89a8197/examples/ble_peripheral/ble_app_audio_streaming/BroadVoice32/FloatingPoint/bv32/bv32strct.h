@@ -30,7 +30,8 @@
 
 struct BV32_Decoder_State {
 Float	stsym[LPCO];
-Float	ltsym[LTMOFF];
+Float	ltsym[LTMOFF];	/* long-term synthesis filter memory, ring buffer */
+short	ltsym_idx;	/* ring position of the oldest sample in ltsym[] */
 Float	lsppm[LPCO*LSPPORDER];
 Float	lgpm[LGPORDER];
 Float	lsplast[LPCO];
@@ -89,4 +90,13 @@ short   gidx[2];
 short   qvidx[NVPSF];
 };
 
+/* one frame as decoded by BV32_DecodeParams(), for BV32_Synthesize() */
+struct BV32_Frame_Params {
+Float   a[LPCO+1];      /* LPC predictor */
+Float   bq[3];          /* pitch taps */
+Float   gainq[NSF];     /* excitation gains */
+short   pp;             /* pitch period */
+short   qvidx[NVPSF];
+};
+
 #endif /* BV32STRCT_H */
@@ -31,6 +31,8 @@
 #include "bvcommon.h"
 #include "bv32strct.h"
 #include "bv32externs.h"
+#include "bv32.h"
+#include "bitpack.h"
 
 #include "utility.h"
 
@@ -42,60 +44,56 @@ void Reset_BV32_Decoder(struct BV32_Decoder_State *c)
       c->lsplast[i] = (Float)(i+1)/(Float)(LPCO+1);
    Fzero(c->stsym,LPCO);
    Fzero(c->ltsym,LTMOFF);
+   c->ltsym_idx = 0;
    Fzero(c->lgpm,LGPORDER);
    Fzero(c->lsppm,LPCO*LSPPORDER);
    Fzero(c->dezfm,PFO);
    Fzero(c->depfm,PFO);
    c->cfecount = 0;
    c->idum=0;
-   c->scplcg=1.0;
-   c->per=0;
-   c->E = 0.0;
+   c->scplcg=1.0F;
+   c->per=0.0F;
+   c->E = 0.0F;
    for(i=0; i<LPCO; i++)
-      c->atplc[i+1] = 0.0;
+      c->atplc[i+1] = 0.0F;
    c->pp_last = 100;
    c->prevlg[0] = MinE;
    c->prevlg[1] = MinE;
    c->lgq_last = MinE;
-   c->lmax = -100.;
-   c->lmin = 100.;
-   c->lmean = 8.0;
-   c->x1 = 13.5;
-   c->level = 13.5;
+   c->lmax = -100.0F;
+   c->lmin = 100.0F;
+   c->lmean = 8.0F;
+   c->x1 = 13.5F;
+   c->level = 13.5F;
    c->nclglim=0;
    c->lctimer=0;
 }
 
-void BV32_Decode(
+/* Parameter stage: everything that depends only on the bit-stream and  */
+/* the LSP, gain and level predictor state. It does not touch the state */
+/* BV32_Synthesize() uses, so the next frame can be decoded while this  */
+/* one is synthesized; BV32_PLC() uses both and must run in between.    */
+void BV32_DecodeParams(
                         struct BV32_Bit_Stream     *bs,
                         struct BV32_Decoder_State  *ds,
-                        short   *out)
+                        struct BV32_Frame_Params   *fp)
 {
-   
-   Float	xq[FRSZ];
-   Float	ltsym[LTMOFF+FRSZ];
-   Float a[LPCO+1];
    Float	lspq[LPCO];
-   Float	bq[3];
-   Float	gainq[NSF];
    Float	lgq[NSF];
-   Float E;
-   short pp, i;
-   Float bss;
-   
-   ds->cfecount = 0; /* reset frame erasure counter */ 
+   short i;
    
    /* decode spectral information */
    lspdec(lspq,bs->lspidx,ds->lsppm,ds->lsplast); 
-   lsp2a(lspq,	a);
+   lsp2a(lspq,	fp->a);
+   Fcopy(ds->lsplast,lspq,LPCO);
    
    /* decode pitch period & 3 pitch predictor taps */
-   pp = (bs->ppidx + MINPP);
-   pp3dec(bs->bqidx, bq);
+   fp->pp = (bs->ppidx + MINPP);
+   pp3dec(bs->bqidx, fp->bq);
    
    /* decode excitation gain */
    for (i=0;i<NSF;i++){ 
-      gainq[i] = gaindec(lgq+i,bs->gidx[i],ds->lgpm,
+      fp->gainq[i] = gaindec(lgq+i,bs->gidx[i],ds->lgpm,
 				     ds->prevlg,ds->level,&ds->nclglim,ds->lctimer); 
       
       if(ds->lctimer > 0)
@@ -108,40 +106,89 @@ void BV32_Decode(
          &ds->lmean,&ds->x1);
    }
    
-   /* copy state memory ltsym[] to local buffer */
-   Fcopy(ltsym, ds->ltsym, LTMOFF);
+   /* update average quantized log-gain */
+   ds->lgq_last = 0.5F*(lgq[0]+lgq[1]);
+   
+   for (i=0;i<NVPSF;i++)
+      fp->qvidx[i] = bs->qvidx[i];
+}
 
-   /* decode the excitation signal */
-   excdec_w_LT_synth(ltsym,bs->qvidx,gainq,bq,pp,&E);
+/* Synthesis stage: excitation, LPC synthesis and de-emphasis of a frame */
+/* from BV32_DecodeParams(), in the order the frames were decoded.       */
+void BV32_Synthesize(
+                        struct BV32_Frame_Params   *fp,
+                        struct BV32_Decoder_State  *ds,
+                        short   *out)
+{
+   
+   Float	xq[FRSZ];
+   Float E;
+   Float bss;
+   
+   ds->cfecount = 0; /* reset frame erasure counter */ 
+   
+   /* decode the excitation signal, long-term synthesis runs in ds->ltsym[] */
+   excdec_w_LT_synth(ds->ltsym,&ds->ltsym_idx,xq,fp->qvidx,fp->gainq,fp->bq,fp->pp,&E);
    
    ds->E = E;
    
    /* lpc synthesis filtering of excitation */
-   apfilter(a, LPCO, ltsym+LTMOFF, xq, FRSZ, ds->stsym, 1); 
+   apfilter(fp->a, LPCO, xq, xq, FRSZ, ds->stsym, 1); 
    
    /* update pitch period of last frame */
-   ds->pp_last = pp;
+   ds->pp_last = fp->pp;
    
    /* update signal memory */
-   Fcopy(ds->ltsym, ltsym+FRSZ, LTMOFF);
-   Fcopy(ds->bq_last, bq, 3);
+   Fcopy(ds->bq_last, fp->bq, 3);
    
-   /* update average quantized log-gain */
-   ds->lgq_last = 0.5*(lgq[0]+lgq[1]);
-
    /* de-emphasis filtering */
    azfilter(a_pre, PFO, xq, xq, FRSZ, ds->dezfm, 1);
    apfilter(b_pre, PFO, xq, xq, FRSZ, ds->depfm, 1);
    
    F2s(out, xq, FRSZ);
-   Fcopy(ds->lsplast,lspq,LPCO);
    
-   Fcopy(ds->atplc, a , LPCO+1);
-   bss = bq[0]+bq[1]+bq[2];
-   if(bss > 1.0)
-      bss = 1.0;
-   else if(bss < 0.0)
-      bss = 0.0;
-   ds->per = 0.5*ds->per+0.5*bss;
+   Fcopy(ds->atplc, fp->a , LPCO+1);
+   bss = fp->bq[0]+fp->bq[1]+fp->bq[2];
+   if(bss > 1.0F)
+      bss = 1.0F;
+   else if(bss < 0.0F)
+      bss = 0.0F;
+   ds->per = 0.5F*ds->per+0.5F*bss;
    
 }
+
+void BV32_Decode(
+                        struct BV32_Bit_Stream     *bs,
+                        struct BV32_Decoder_State  *ds,
+                        short   *out)
+{
+   struct BV32_Frame_Params fp;
+   
+   BV32_DecodeParams(bs, ds, &fp);
+   BV32_Synthesize(&fp, ds, out);
+}
+
+/* Decode nframes consecutive packed frames into nframes*FRSZ samples.    */
+/* Frames with a nonzero bfi[] entry are concealed by BV32_PLC instead,   */
+/* their packed bytes are not read; bfi may be NULL when none are lost.   */
+void BV32_DecodeFrames(
+                       UWord8  *PackedStream,
+                       UWord8  *bfi,
+                       int     nframes,
+                       struct BV32_Decoder_State  *ds,
+                       short  *out)
+{
+   struct BV32_Bit_Stream bs;
+   int n;
+   
+   for (n = 0; n < nframes; n++) {
+      if (bfi && bfi[n])
+         BV32_PLC(ds, out);
+      else {
+         BV32_BitUnPack(PackedStream, &bs);
+         BV32_Decode(&bs, ds, out);
+      }
+      PackedStream += BV32_PACKED_BYTES;
+      out += FRSZ;
+   }
+}
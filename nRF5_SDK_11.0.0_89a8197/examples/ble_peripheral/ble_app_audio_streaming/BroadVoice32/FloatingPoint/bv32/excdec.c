@@ -31,7 +31,9 @@
 #include "bv32externs.h"
 
 void excdec_w_LT_synth(
-                       Float   *ltsymd, /* long-term synthesis filter memory at decoder*/
+                       Float   *ltsymd, /* long-term synthesis filter memory at decoder, ring of LTMOFF samples */
+                       short   *ltidx, /* (i/o) ring position of the oldest sample in ltsymd[] */
+                       Float   *qv,    /* (o) long-term synthesized excitation of current frame */
                        short   *idx,   /* excitation codebook index array for current subframe */
                        Float   *gainq, /* quantized linear gains for sub-subframes */
                        Float   *b,     /* coefficient of 3-tap pitch predictor */
@@ -39,14 +41,17 @@ void excdec_w_LT_synth(
                        Float   *EE
                        )
 {
-   Float a0, *fp1, *fp2, *fp3, gain;
-   int i, m, n, id;
+   Float a0, *fp1, gain;
+   const Float *fp3;
+   int i, m, n, id, k0, k1, k2, w;
    short	*ip;
    Float E, t;
    
    ip=idx;
-   fp1=&ltsymd[LTMOFF]; /* fp1 points to 1st sample of current subframe */
-   fp2=&ltsymd[LTMOFF-pp+1];
+   fp1=qv;
+   w=*ltidx;         /* ring position of the current sample */
+   k0=w-pp-1;        /* ring position of the oldest pitch tap */
+   if (k0 < 0) k0 += LTMOFF;
    for (i = 0; i < NSF; i++) { /* loop through sub-subframes */
       E=0.0;
       for (m = 0; m < SFRSZ; m+=VDIM) { /* loop thru vectors in sub-subframe */
@@ -59,15 +64,21 @@ void excdec_w_LT_synth(
          }
          fp3=&cccb[id*VDIM];
          for (n = 0; n < VDIM; n++) {
-            a0  = b[0] * *fp2--;
-            a0 += b[1] * *fp2--;
-            a0 += b[2] * *fp2;/* a0=pitch predicted value of LT syn filt */
+            k1 = (k0 == LTMOFF-1) ? 0 : k0+1;
+            k2 = (k1 == LTMOFF-1) ? 0 : k1+1;
+            a0  = b[0] * ltsymd[k2];
+            a0 += b[1] * ltsymd[k1];
+            a0 += b[2] * ltsymd[k0];/* a0=pitch predicted value of LT syn filt */
             t = *fp3++ * gain;
             E += t*t;
-            *fp1++ = a0 + t; /* add scale codevector to a0 */
-            fp2 = &fp2[3];    /* prepare fp2 for filtering next sample */
+            *fp1 = a0 + t; /* add scale codevector to a0 */
+            /* the oldest tap is read before its slot is overwritten (pp <= MAXPP) */
+            ltsymd[w] = *fp1++;
+            if (++w == LTMOFF) w = 0;
+            k0 = k1;
          }         
       }
    }
+   *ltidx = (short)w;
    *EE = E;
 }
@@ -31,6 +31,53 @@
 #include "bvcommon.h"
 #include "bv32externs.h"
 
+#if FAST_GAIN
+/* FAST_GAIN=1 replaces the pow() and log() calls of the gain decoder with   */
+/* a table of the linear codebook gains and the approximations below,        */
+/* for targets where the libm functions are slow.                            */
+
+/* 2^x to a relative error of 2.1e-7: 2^k by ldexp() and 2^f, |f| <= 1/2,    */
+/* by a minimax polynomial                                                   */
+static Float fexp2(Float x)
+{
+   Float f, p;
+   int k;
+   
+   k = (int) (x + 0.5F);
+   if ((Float) k > x + 0.5F)
+      k--;
+   f = x - (Float) k;
+   p = 1.327647198e-3F;
+   p = p * f + 9.675541334e-3F;
+   p = p * f + 5.550713274e-2F;
+   p = p * f + 2.402211972e-1F;
+   p = p * f + 6.931469671e-1F;
+   p = p * f + 1.000000072F;
+   return Fldexp(p, k);
+}
+
+/* log2(x), x > 0, to an absolute error of 5e-8 before rounding: x = m*2^e   */
+/* with 1/sqrt(2) <= m < sqrt(2), and log2(m) = 2/ln(2)*atanh((m-1)/(m+1))   */
+static Float flog2(Float x)
+{
+   Float m, t, t2, p;
+   int e;
+   
+   m = Ffrexp(x, &e);
+   if (m < 0.7071067812F) {
+      m *= 2.0F;
+      e--;
+   }
+   t = (m - 1.0F) / (m + 1.0F);
+   t2 = t * t;
+   p = 2.0F / 7.0F;
+   p = p * t2 + 2.0F / 5.0F;
+   p = p * t2 + 2.0F / 3.0F;
+   p = p * t2 + 2.0F;
+   return (Float) e + 1.4426950409F * p * t;
+}
+#endif
+
 Float gaindec(
               Float   *lgq,
               short   gidx,	
@@ -56,7 +103,7 @@ Float gaindec(
    /* next higher gain */
    if(gidx < LGPECBSZ-1){
       lgq_nh = lgpecb_nh[gidx] + elg;
-      if(*lgq < MinE && fabs(lgq_nh-MinE) < fabs(*lgq-MinE)){ 
+      if(*lgq < MinE && Ffabs(lgq_nh-MinE) < Ffabs(*lgq-MinE)){ 
          /* To avoid thresholding when the enc Q makes it below the threshold */
          *lgq = MinE;
       }
@@ -99,7 +146,14 @@ Float gaindec(
    prevlg[0] = *lgq;
    
    /* CONVERT QUANTIZED LOG-GAIN TO LINEAR DOMAIN */
-   gainq = pow(2.0F, 0.5F * *lgq);
+#if FAST_GAIN
+   if (*lgq == lgpecb[gidx] + elg)   /* not thresholded or limited */
+      gainq = gpecb[gidx] * fexp2(0.5F * elg);
+   else
+      gainq = fexp2(0.5F * *lgq);
+#else
+   gainq = Fpow(2.0F, 0.5F * *lgq);
+#endif
    
    return gainq;
 }
@@ -113,14 +167,18 @@ void gainplc(Float E,
    
    pe = INVSFRSZ * E;
    
-   if(pe - TMinlg > 0.0)
-      lg = log(pe)/log(2.0);
+   if(pe - TMinlg > 0.0F)
+#if FAST_GAIN
+      lg = flog2(pe);
+#else
+      lg = Flog(pe)/Flog(2.0F);
+#endif
    else
       lg = Minlg;
    
    mrlg = lg - lgmean;
    
-   elg = 0.0;
+   elg = 0.0F;
    for(k=0; k<GPO; k++)
       elg += lgp[k] * lgeqm[k];
    
@@ -41,7 +41,8 @@ int gainquan(
              )
 {
    Float elg, lgpe, limit, dmin, d;
-   int i, n, gidx=0, *p_gidx;
+   int i, n, gidx=0;
+   const int *p_gidx;
    
    /* CALCULATE ESTIMATED LOG-GAIN */
    elg = lgmean;
@@ -42,7 +42,7 @@ Float	estlevel(
    else *lmax=*lmean+estl_alpha*(*lmax-*lmean); /* o.w. attenuate toward lmean */
    if (lg < *lmin) *lmin=lg;	/* use new log-gain as min if it is < min */
    else *lmin=*lmean+estl_alpha*(*lmin-*lmean); /* o.w. attenuate toward lmean */
-   *lmean=estl_beta*(*lmean)+estl_beta1*(0.5*(*lmax+*lmin));
+   *lmean=estl_beta*(*lmean)+estl_beta1*(0.5F*(*lmax+*lmin));
    
   	/* UPDATE ESTIMATED INPUT LEVEL, BY CALCULATING A RUNNING AVERAGE
    (USING AN EXPONENTIAL WINDOW) OF LOG-GAINS EXCEEDING lmean */
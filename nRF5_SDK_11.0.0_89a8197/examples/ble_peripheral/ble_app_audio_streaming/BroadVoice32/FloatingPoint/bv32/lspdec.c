@@ -31,7 +31,7 @@
 #include "bvcommon.h"
 #include "bv32externs.h"
 
-void vqdec(Float *, short, Float *, int);
+void vqdec(Float *, short, const Float *, int);
 
 void lspdec(
             Float   *lspq,  
@@ -42,15 +42,16 @@ void lspdec(
    Float elsp[LPCO], lspe[LPCO]; 
    Float lspeq1[LPCO], lspeq2[LPCO];
    Float a0, *fp1, *fp2;
+   const Float *fp0;
    int i, k, stbl;
    
    /* calculate estimated (ma-predicted) lsp vector */
-   fp1 = lspp;
+   fp0 = lspp;
    fp2 = lsppm;
    for (i = 0; i < LPCO; i++) {
       a0 = 0.0F;
       for (k = 0; k < LSPPORDER; k++) {
-         a0 += *fp1++ * *fp2++;
+         a0 += *fp0++ * *fp2++;
       }
       elsp[i] = a0;
    }
@@ -110,7 +111,7 @@ void lspdec(
 void vqdec(
            Float   *xq,    /* VQ output vector (quantized version of input vector) */
            short   idx,    /* VQ codebook index for the nearest neighbor */
-           Float   *cb,    /* VQ codebook */
+           const Float *cb, /* VQ codebook */
            int     vdim    /* vector dimension */
            )
 {
@@ -129,15 +130,16 @@ void lspplc(
 {
    Float elsp[LPCO];
    Float a0, *fp1, *fp2;
+   const Float *fp0;
    int i, k;
    
    /* calculate estimated (ma-predicted) lsp vector */
-   fp1 = lspp;
+   fp0 = lspp;
    fp2 = lsppm;
    for (i = 0; i < LPCO; i++) {
       a0 = 0.0F;
       for (k = 0; k < LSPPORDER; k++) {
-         a0 += *fp1++ * *fp2++;
+         a0 += *fp0++ * *fp2++;
       }
       elsp[i] = a0;
    }
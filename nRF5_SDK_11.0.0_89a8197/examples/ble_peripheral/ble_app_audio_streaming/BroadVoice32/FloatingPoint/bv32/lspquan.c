@@ -32,10 +32,10 @@
 #include "bvcommon.h"
 #include "bv32externs.h"
 
-void vqmse(Float *xq, short *idx, Float *x, Float *cb, int vdim, int cbsz);
+void vqmse(Float *xq, short *idx, Float *x, const Float *cb, int vdim, int cbsz);
 void vqwmse_stbl(Float *xq, short *idx, Float *x, Float *w, Float *xa, 
-                 Float *cb , int vdim, int cbsz);
-void vqwmse(Float *xq, short *idx, Float *x, Float *w, Float *cb, int vdim,
+                 const Float *cb , int vdim, int cbsz);
+void vqwmse(Float *xq, short *idx, Float *x, Float *w, const Float *cb, int vdim,
             int cbsz);
 
 void lspquan(
@@ -50,6 +50,7 @@ void lspquan(
    Float lspeq1[LPCO], lspeq2[LPCO];
    Float lspa[LPCO];	
    Float a0, *fp1, *fp2;
+   const Float *fp0;
    int i, k;
    
    /* CALCULATE THE WEIGHTS FOR WEIGHTED MEAN-SQUARE ERROR DISTORTION */
@@ -66,12 +67,12 @@ void lspquan(
    w[LPCO-1] = 1.0F / d[LPCO-2];        
    
    /* CALCULATE ESTIMATED (MA-PREDICTED) LSP VECTOR */
-   fp1 = lspp;
+   fp0 = lspp;
    fp2 = lsppm;
    for (i = 0; i < LPCO; i++) {
       a0 = 0.0F;
       for (k = 0; k < LSPPORDER; k++) {
-         a0 += *fp1++ * *fp2++;
+         a0 += *fp0++ * *fp2++;
       }
       elsp[i] = a0;
    }
@@ -129,12 +130,13 @@ void vqmse(
            Float   *xq,    /* VQ output vector (quantized version of input vector) */
            short   *idx,   /* VQ codebook index for the nearest neighbor */
            Float   *x,     /* input vector */
-           Float   *cb,    /* VQ codebook */
+           const Float *cb, /* VQ codebook */
            int     vdim,   /* vector dimension */
            int     cbsz    /* codebook size (number of codevectors) */
            )
 {
-   Float *fp1, dmin, d;
+   const Float *fp1;
+   Float dmin, d;
    int j, k;
    
    Float e;
@@ -168,12 +170,13 @@ void vqwmse_stbl(
                  Float   *x,     /* input vector */
                  Float   *w,     /* weights for weighted Mean-Square Error */
                  Float   *xa,    /* lsp approximation */
-                 Float   *cb,    /* VQ codebook */
+                 const Float *cb, /* VQ codebook */
                  int     vdim,   /* vector dimension */
                  int     cbsz    /* codebook size (number of codevectors) */
                  )
 {
-   Float a0, *fp1, *fp2, dmin, d, xqc[LPCO];
+   const Float *fp1, *fp2;
+   Float a0, dmin, d, xqc[LPCO];
    int j, k, stbl;
    
    fp1 = cb;
@@ -230,12 +233,13 @@ void vqwmse(
             short   *idx,   /* VQ codebook index for the nearest neighbor */
             Float   *x,     /* input vector */
             Float   *w,     /* weights for weighted Mean-Square Error */
-            Float   *cb,    /* VQ codebook */
+            const Float *cb, /* VQ codebook */
             int     vdim,   /* vector dimension */
             int     cbsz    /* codebook size (number of codevectors) */
             )
 {
-   Float a0, *fp1, dmin, d;
+   const Float *fp1;
+   Float a0, dmin, d;
    int j, k;
    
    fp1 = cb;
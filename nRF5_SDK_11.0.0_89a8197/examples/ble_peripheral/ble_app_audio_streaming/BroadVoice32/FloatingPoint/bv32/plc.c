@@ -38,17 +38,12 @@ extern void BV32_PLC(
                      struct  BV32_Decoder_State   *ds,
                      short   *out)
 {
-   int n, i_sf;
+   int n, i_sf, k0, k1, k2, w;
    Float r[SFRSZ];        /* random excitation                       */
    Float E, gain;
    Float tmp;
    Float xq[SFRSZ];
-   Float	d[LTMOFF+FRSZ];	/* long-term synthesis filter memory */
-   
-   /************************************************************/
-   /*                 Copy decoder state memory                */
-   /************************************************************/
-   Fcopy(d, ds->ltsym, LTMOFF); /* excitation */
+   Float *d = ds->ltsym;  /* long-term synthesis filter memory (ring) */
    
    /************************************************************/
    /*        Update counter of consecutive list frames         */
@@ -62,10 +57,10 @@ extern void BV32_PLC(
       /************************************************************/
       /*                Generate Unscaled Excitation              */
       /************************************************************/
-      E = 0.0;
+      E = 0.0F;
       for(n=0; n<SFRSZ; n++){
          ds->idum = 1664525L*ds->idum + 1013904223L;
-         r[n] = (Float)(ds->idum >> 16) - 32767.0;
+         r[n] = (Float)(ds->idum >> 16) - 32767.0F;
          E += r[n] * r[n];
       }
       
@@ -78,23 +73,33 @@ extern void BV32_PLC(
          ds->scplcg = ScPLCGmax;
       else if(ds->scplcg < ScPLCGmin)
          ds->scplcg = ScPLCGmin;
-      gain = ds->scplcg * sqrt(ds->E / E);
+      gain = ds->scplcg * Fsqrt(ds->E / E);
       
       /************************************************************/
       /*                  Long-term synthesis filter              */
       /************************************************************/
+      w = ds->ltsym_idx;
+      k0 = w - ds->pp_last - 1;
+      if (k0 < 0) k0 += LTMOFF;
       for(n=0; n<SFRSZ; n++){
-         d[LTMOFF+i_sf*SFRSZ+n] = gain * r[n];
-         d[LTMOFF+i_sf*SFRSZ+n] += ds->bq_last[0] * d[LTMOFF+i_sf*SFRSZ+n-ds->pp_last+1];
-         d[LTMOFF+i_sf*SFRSZ+n] += ds->bq_last[1] * d[LTMOFF+i_sf*SFRSZ+n-ds->pp_last];
-         d[LTMOFF+i_sf*SFRSZ+n] += ds->bq_last[2] * d[LTMOFF+i_sf*SFRSZ+n-ds->pp_last-1];
+         k1 = (k0 == LTMOFF-1) ? 0 : k0+1;
+         k2 = (k1 == LTMOFF-1) ? 0 : k1+1;
+         tmp = gain * r[n];
+         tmp += ds->bq_last[0] * d[k2];
+         tmp += ds->bq_last[1] * d[k1];
+         tmp += ds->bq_last[2] * d[k0];
+         r[n] = tmp;    /* r[] now holds the long-term synthesized excitation */
+         d[w] = tmp;
+         if (++w == LTMOFF) w = 0;
+         k0 = k1;
       }
+      ds->ltsym_idx = (short)w;
       
       
       /************************************************************/
       /*                Short-term synthesis filter               */
       /************************************************************/
-      apfilter(ds->atplc, LPCO, d+i_sf*SFRSZ+LTMOFF, xq, SFRSZ, ds->stsym, 1);
+      apfilter(ds->atplc, LPCO, r, xq, SFRSZ, ds->stsym, 1);
       
       /**********************************************************/
       /*                    De-emphasis filter                  */
@@ -103,11 +108,11 @@ extern void BV32_PLC(
          tmp = xq[n] + PEAPFC * ds->dezfm[0] -PEAZFC * ds->depfm[0];
          ds->dezfm[0] = xq[n];
          ds->depfm[0] = tmp;
-         if (tmp>=0) tmp += 0.5;
-         else tmp -= 0.5;
+         if (tmp>=0) tmp += 0.5F;
+         else tmp -= 0.5F;
          
-         if (tmp>32767.0) tmp = 32767.0;
-         else if (tmp<-32768.0) tmp = -32768.0;
+         if (tmp>32767.0F) tmp = 32767.0F;
+         else if (tmp<-32768.0F) tmp = -32768.0F;
          out[i_sf*SFRSZ+n] = (short)tmp;
       }
       
@@ -123,11 +128,6 @@ extern void BV32_PLC(
          &ds->lmean,&ds->x1);
    }
    
-   /************************************************************/
-   /*                 Save decoder state memory                */
-   /************************************************************/
-   Fcopy(ds->ltsym, d+FRSZ, LTMOFF);
-   
    /************************************************************/
    /*        Update memory of predictive LSP quantizer         */
    /************************************************************/
@@ -137,7 +137,7 @@ extern void BV32_PLC(
    /*          Attenuation during long packet losses           */
    /************************************************************/
    if(ds->cfecount >= HoldPLCG){
-      gain = 1.0 -AttnFacPLCG * (Float)(ds->cfecount - (HoldPLCG-1));
+      gain = 1.0F -AttnFacPLCG * (Float)(ds->cfecount - (HoldPLCG-1));
       ds->bq_last[0] = gain * ds->bq_last[0];
       ds->bq_last[1] = gain * ds->bq_last[1];
       ds->bq_last[2] = gain * ds->bq_last[2];
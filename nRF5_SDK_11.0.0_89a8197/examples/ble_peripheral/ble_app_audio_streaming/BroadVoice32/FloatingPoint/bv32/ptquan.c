@@ -37,7 +37,8 @@ int pitchtapquan(
    
    Float	p[9], t, s0, s1, s2, cormax, cor;
    Float	t0, t1, t2;
-   Float	*xt, *fp0, *fp1, *fp2;
+   Float	*xt, *fp0, *fp1;
+   const Float	*cbp;
    int	ppm2, qidx=0, i, j;
    
    ppm2 = pp-2;
@@ -65,18 +66,18 @@ int pitchtapquan(
    p[6] = p[7] + (s1*s1) - t2;
    
    cormax=-1.e30;
-   fp0 = pp9cb;
+   cbp = pp9cb;
    for (i=0;i<PPCBSZ;i++) {
       cor = 0.;
       fp1 = p;
-      for (j=0;j<9;j++) cor += (*fp0++)*(*fp1++);
+      for (j=0;j<9;j++) cor += (*cbp++)*(*fp1++);
       if (cor > cormax) {
          cormax = cor; qidx = i;
       }
    } 
    
-   fp2 = pp9cb + qidx*9;
-   for (i=0;i<3;i++) b[i] = fp2[i]*0.5;
+   cbp = pp9cb + qidx*9;
+   for (i=0;i<3;i++) b[i] = cbp[i]*0.5;
    
    return qidx;
 }
@@ -30,7 +30,7 @@
 
 /* spec */
 /* log-gain change limitation */
-Float	lgclimit[] = {
+const Float	lgclimit[] = {
   0.00000,   0.13477,   2.26563,   2.94336,   4.71875,   0.00000,   0.00000,   0.00000,   0.00000,   0.00000,   0.00000, 
   0.00000,   0.64453,   4.90039,   3.38281,   4.58203,   5.69336,   0.00000,   0.00000,   0.00000,   0.00000,   0.00000, 
   0.00000,   0.33594,   7.27734,   5.82422,  11.66211,  11.66211,   0.00000,   0.00000,   0.00000,   0.00000,   0.00000, 
@@ -51,7 +51,7 @@ Float	lgclimit[] = {
   0.00000,   0.00000,   0.07617,   1.46875,   3.49219,   3.16992,  -0.84180,   3.81250,  -0.50781,   0.00000,   0.00000};
 
 /* spec */
-Float	lspecb1[] = {
+const Float	lspecb1[] = {
 -0.00384521, -0.00849915, -0.01591492, -0.00360107, -0.00013733,  0.00610352,  0.01640320, -0.00166321,
 -0.00511169, -0.01313782, -0.01698303, -0.00103760, -0.01216125, -0.00427246, -0.00271606,  0.00846863,
 -0.00367737, -0.00166321,  0.00045776, -0.00309753,  0.01814270, -0.00053406,  0.00256348, -0.00833130,
@@ -182,7 +182,7 @@ Float	lspecb1[] = {
  0.02717590,  0.07472229,  0.08680725,  0.03575134,  0.00018311, -0.03523254, -0.05368042, -0.04931641};
 
  /* spec */
-Float	lspecb21[] = {
+const Float	lspecb21[] = {
  0.00281525,  0.00292778,  0.00433731,
 -0.00021553, -0.00037766, -0.00252151,
  0.00709152, -0.00558853, -0.00040245,
@@ -217,7 +217,7 @@ Float	lspecb21[] = {
 -0.01263237, -0.04002953,  0.00638008}; 
 
  /* spec */
-Float	lspecb22[] = {
+const Float	lspecb22[] = {
  0.00223160, -0.00800133, -0.00899124,  0.00006485,  0.00058365,
  0.00498199,  0.00384903, -0.00713539, -0.00961494, -0.00307274,
 -0.00000954,  0.00230217,  0.00827026,  0.00367355,  0.00186920,
@@ -252,7 +252,7 @@ Float	lspecb22[] = {
  0.02854538, -0.00962830, -0.00597000, -0.00085640, -0.00148964};
 
  /* spec */
-Float	lspmean[] = {	/* mean value of LSP components */
+const Float	lspmean[] = {	/* mean value of LSP components */
 0.0551453,
 0.1181030,
 0.2249756,
@@ -263,7 +263,7 @@ Float	lspmean[] = {	/* mean value of LSP components */
 0.8278198};
 
 /* spec */
-Float 	lspp[] = {	/* LSP Predictor Coefficients */
+const Float 	lspp[] = {	/* LSP Predictor Coefficients */
 0.7401123, 0.6939697, 0.6031494, 0.5333862, 0.4295044, 0.3234253, 0.2177124, 0.1162720,
 0.7939453, 0.7693481, 0.6712036, 0.5919189, 0.4750366, 0.3556519, 0.2369385, 0.1181030,
 0.7534180, 0.7318115, 0.6326294, 0.5588379, 0.4530029, 0.3394775, 0.2307739, 0.1201172,
@@ -274,7 +274,7 @@ Float 	lspp[] = {	/* LSP Predictor Coefficients */
 0.5134277, 0.4365845, 0.3521729, 0.3118896, 0.2514038, 0.1951294, 0.1443481, 0.0841064};
 
 /* spec */
-Float	lgpecb[] = {	/* Log-Gain Prediction Error CodeBook */
+const Float	lgpecb[] = {	/* Log-Gain Prediction Error CodeBook */
 -4.91895,
 -3.75049,
 -3.09082,
@@ -308,8 +308,45 @@ Float	lgpecb[] = {	/* Log-Gain Prediction Error CodeBook */
  8.74316,
 10.92188};
 
+#if FAST_GAIN
+/* 2^(lgpecb[i]/2): linear gains of lgpecb */
+const Float	gpecb[] = {
+0.181812715,
+0.272580639,
+0.342598324,
+0.406181095,
+0.462241918,
+0.602402641,
+0.737040090,
+0.886636709,
+0.511554551,
+0.646994342,
+0.784266021,
+0.943928835,
+1.073115230,
+1.331303959,
+1.740274638,
+2.599834883,
+0.557759467,
+0.691837442,
+0.833387866,
+1.005431643,
+1.148463495,
+1.442248737,
+1.942628456,
+3.185743250,
+1.234104874,
+1.575713233,
+2.217109462,
+4.161576045,
+6.083830673,
+10.210984030,
+20.700303285,
+44.046027390};
+#endif
+
 /* spec */
-Float	lgp[] =	{	/* Log-Gain Predictor */
+const Float	lgp[] =	{	/* Log-Gain Predictor */
  0.5913086,
  0.5251160,
  0.5724792,
@@ -328,10 +365,10 @@ Float	lgp[] =	{	/* Log-Gain Predictor */
  0.0664673};
 
  /* spec */
-Float	lgmean = 11.82031;
+const Float	lgmean = 11.82031;
 
 /* spec */
-Float	cccb[] = {
+const Float	cccb[] = {
 -0.537476,  0.974976, -0.631104, -0.617920,
  1.145142,  1.222534, -1.252441,  0.616211,
  1.174194,  1.399414,  0.330933,  0.823120,
@@ -365,7 +402,7 @@ Float	cccb[] = {
 -0.040771, -1.141968,  0.364258, -0.283691,
  0.448242, -0.755127,  1.767578, -0.691406};
 
-Float pp9cb[] = {
+const Float pp9cb[] = {
  -2.9005200e-001,  5.9857400e-001,  2.8242800e-001,  8.6808793e-002,
  -8.4527029e-002,  4.0959403e-002, -2.1032541e-002, -8.9572708e-002,
  -1.9941394e-002,
@@ -465,16 +502,16 @@ Float pp9cb[] = {
 };
 
 /* Pre-Emphasis or De-Emphasis Filter */
-Float	a_pre[] = {	1., PEAPFC };
-Float	b_pre[] = { 1., PEAZFC };
+const Float	a_pre[] = {	1., PEAPFC };
+const Float	b_pre[] = { 1., PEAZFC };
 
 /* Combined High-Pass & Pre-Emphasis Filter */
-Float	hpfa[] = {1.00000000000000,  PEAPFC-(127./128), PEAPFC*(-127./128)};
-Float	hpfb[] = {255./256,  255./256*(PEAZFC-1.), -255./256*PEAZFC};
+const Float	hpfa[] = {1.00000000000000,  PEAPFC-(127./128), PEAPFC*(-127./128)};
+const Float	hpfb[] = {255./256,  255./256*(PEAZFC-1.), -255./256*PEAZFC};
 
 /* spec */
 /* coarse pitch search */
-Float   adf[]  = {   
+const Float   adf[]  = {   
    1.00000000000000,
   -3.56023061648011,
    4.85584780946374,
@@ -482,19 +519,19 @@ Float   adf[]  = {
    0.70692772790790};
 
 /* spec */
-Float   bdf[]  = {    
+const Float   bdf[]  = {    
    0.0322952,
   -0.1028824,
    0.1446838,
   -0.1028824,
    0.0322952 };
 
-Float   x[]    = {0.125, 0.25, 0.375, 0.5};
-Float   x2[]   = {0.015625, 0.0625, 0.140625, 0.25}; /* square of x[] */
-Float   MPTH[] = {0.7, 0.55, 0.48, 0.37};
+const Float   x[]    = {0.125, 0.25, 0.375, 0.5};
+const Float   x2[]   = {0.015625, 0.0625, 0.140625, 0.25}; /* square of x[] */
+const Float   MPTH[] = {0.7, 0.55, 0.48, 0.37};
 
 /* spec */
-Float	winl[] = {
+const Float	winl[] = {
    0.0001831,
    0.0006714,
    0.0015259,
@@ -657,7 +694,7 @@ Float	winl[] = {
    0.0392456};
 
 /* spec */
-Float	sstwin[] = {
+const Float	sstwin[] = {
    1.00003162253432,
    0.99950664035278,
    0.99802802494523,
@@ -668,11 +705,11 @@ Float	sstwin[] = {
    0.97610947553847,
    0.96891079029551};
 
-int idxord[]={ 0,  1,  2,  3,  4,  8, 16,  5,  9, 17,  6, 10, 18,  7, 11, 19,
+const int idxord[]={ 0,  1,  2,  3,  4,  8, 16,  5,  9, 17,  6, 10, 18,  7, 11, 19,
 	      12, 20, 24, 13, 21, 25, 14, 22, 26, 15, 23, 27, 28, 29, 30, 31};
 
 /* spec */
-Float	lgpecb_nh[] = {	/* Log-Gain Prediction Error Next-Higher CodeBook */
+const Float	lgpecb_nh[] = {	/* Log-Gain Prediction Error Next-Higher CodeBook */
 -3.75049,
 -3.09082, 
 -2.59961, 
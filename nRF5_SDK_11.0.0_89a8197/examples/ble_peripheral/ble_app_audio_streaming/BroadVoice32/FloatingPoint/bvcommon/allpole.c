@@ -32,7 +32,7 @@
 #define MAXORDER LPCO     /* maximum filter order */
 
 void apfilter(
-              Float   *a,     /* (i) a[m+1] prediction coefficients   (m=10)  */
+              const Float *a, /* (i) a[m+1] prediction coefficients   (m=10)  */
               int     m,      /* (i) LPC order                                */
               Float   *x,     /* (i) input signal                             */
               Float   *y,     /* (o) output signal                            */
@@ -32,7 +32,7 @@
 #define MAXORDER LPCO     /* maximum filter order */
 
 void azfilter(
-              Float   *a,     /* (i) prediction coefficients                  */
+              const Float *a, /* (i) prediction coefficients                  */
               int     m,      /* (i) LPC order                                */
               Float   *x,     /* (i) input signal vector                      */
               Float   *y,     /* (o) output signal vector                     */
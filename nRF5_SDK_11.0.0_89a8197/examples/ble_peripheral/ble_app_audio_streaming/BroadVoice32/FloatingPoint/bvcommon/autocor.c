@@ -33,7 +33,7 @@
 void Autocor(
              Float   *r,      /* (o) : Autocorrelations     */
              Float   *x,      /* (i) : Input signal         */
-             Float   *window, /* (i) : LPC Analysis window  */ 
+             const Float *window, /* (i) : LPC Analysis window  */ 
              int     l_window,/* (i) : window length        */
              int     m)       /* (i) : LPC order            */    
 {
@@ -36,7 +36,7 @@ short	idx,
 Float	*b);
 
 void apfilter(
-    Float   *a,     /* (i) a[m+1] prediction coefficients   (m=10)  */
+    const Float *a, /* (i) a[m+1] prediction coefficients   (m=10)  */
     int     m,      /* (i) LPC order                                */
     Float   *x,     /* (i) input signal                             */
     Float   *y,     /* (o) output signal                            */
@@ -45,7 +45,7 @@ void apfilter(
     short   update);/* (i) flag for memory update                   */
 
 void azfilter(
-    Float   *a,     /* (i) prediction coefficients                  */
+    const Float *a, /* (i) prediction coefficients                  */
     int     m,      /* (i) LPC order                                */
     Float   *x,     /* (i) input signal vector                      */
     Float   *y,     /* (o) output signal vector                     */
@@ -56,7 +56,7 @@ void azfilter(
 void Autocor(
 Float   *r,      /* (o) : Autocorrelations     */
 Float   *x,      /* (i) : Input signal         */
-Float   *window, /* (i) : LPC Analysis window  */ 
+const Float *window, /* (i) : LPC Analysis window  */ 
 int     l_window,/* (i) : window length        */
 int     m);      /* (i) : LPC order            */  
 
@@ -79,23 +79,23 @@ void stblz_lsp(Float *lsp, int order);
 int stblchck(Float *x, int vdim);
 
 /* LPC to LSP Conversion */
-extern	Float grid[];
+extern	const Float grid[];
 
 /* LPC bandwidth expansion */
-extern	Float bwel[];
+extern	const Float bwel[];
 
 /* LPC WEIGHTING FILTER */
-extern	Float	STWAL[];
+extern	const Float	STWAL[];
 
 /* ----- Basic Codec Parameters ----- */
 #define LPCO  8 /* LPC Order  */
 #define Ngrd 60 /* LPC to LSP Conversion */
 
-#define LSPMIN  0.00150 /* minimum lsp frequency,      6/12 Hz for BV16/BV32 */
-#define LSPMAX  0.99775 /* maximum lsp frequency, 3991/7982 Hz for BV16/BV32 */
-#define DLSPMIN 0.01250 /* minimum lsp spacing,      50/100 Hz for BV16/BV32 */
+#define LSPMIN  ((Float)0.00150) /* minimum lsp frequency,      6/12 Hz for BV16/BV32 */
+#define LSPMAX  ((Float)0.99775) /* maximum lsp frequency, 3991/7982 Hz for BV16/BV32 */
+#define DLSPMIN ((Float)0.01250) /* minimum lsp spacing,      50/100 Hz for BV16/BV32 */
 #define STBLDIM 3       /* dimension of stability enforcement                */
 
-extern Float pp9cb[];
+extern const Float pp9cb[];
 
 #endif /* BVCOMMON_H */
@@ -26,14 +26,14 @@
 ******************************************************************************/
 #include "typedef.h"
 
-Float	bwel[] = {
+const Float	bwel[] = {
  1.000000, 0.968526251091, 0.938025365420, 0.908506308303, 0.879914932377,
            0.852235186110, 0.825387345342, 0.799409908158, 0.774255089985};
 
-Float STWAL[]={
+const Float STWAL[]={
  1.000000, 0.750000, 0.562500, 0.421875, 0.316406, 0.237305, 0.177979, 0.133484, 0.100098};
 
-Float grid[]={
+const Float grid[]={
   0.9999390,  0.9935608,  0.9848633,  0.9725342,  0.9577942,  0.9409180,  0.9215393,  0.8995972,
   0.8753662,  0.8487854,  0.8198242,  0.7887573,  0.7558899,  0.7213440,  0.6853943,  0.6481323,
   0.6101379,  0.5709839,  0.5300903,  0.4882507,  0.4447632,  0.3993530,  0.3531189,  0.3058167,
@@ -41,13 +41,13 @@ void lsp2a(
    
    orderd2=LPCO/2;
    for(i = 1; i <= LPCO ; i++)
-      p[i] = q[i]= 0.;
+      p[i] = q[i]= 0.0F;
    /* Get Q & P polyn. less the (1 +- z-1) ( or (1 +- z-2) ) factor */
-   p[0] = q[0] = 1.;
+   p[0] = q[0] = 1.0F;
    for(n = 1; n <= orderd2; n++) {
       nor= 2 * n;
-      c1 = 2. * cos((double)PI*lsp[nor-1]);
-      c2 = 2. * cos((double)PI*lsp[nor-2]);
+      c1 = 2.0F * Fcos((Float)PI*lsp[nor-1]);
+      c2 = 2.0F * Fcos((Float)PI*lsp[nor-2]);
       for(i = nor; i >= 2; i--) {
          q[i] += q[i-2] - c1*q[i-1];
          p[i] += p[i-2] - c2*p[i-1];
@@ -56,8 +56,8 @@ void lsp2a(
       p[1] -= c2;
    }
    /* Get the the predictor coeff. */
-   a[0] = 1.;
-   a[1] = 0.5 * (p[1] + q[1]);
+   a[0] = 1.0F;
+   a[1] = 0.5F * (p[1] + q[1]);
    for(i=1, n=2; i < LPCO ; i++, n++)
-      a[n] = 0.5 * (p[i] + p[n] + q[n] - q[i]);
+      a[n] = 0.5F * (p[i] + p[n] + q[n] - q[i]);
 }
@@ -33,10 +33,10 @@ void pp3dec(
             Float	*b)
 {
    
-   Float	*fp;
+   const Float	*fp;
    int	i;
    
    fp = pp9cb + idx*9;
-   for (i=0;i<3;i++) b[i] = fp[i]*0.5;
+   for (i=0;i<3;i++) b[i] = fp[i]*0.5F;
    
 }
@@ -31,12 +31,12 @@ int stblchck(Float *x, int vdim){
    
    int k, stbl;
    
-  	if (x[0] < 0.0)
+  	if (x[0] < 0.0F)
       stbl = 0;
    else {
       stbl = 1;
       for (k=1; k<vdim; k++) {
-         if (x[k]-x[k-1] < 0.0) stbl = 0;
+         if (x[k]-x[k-1] < 0.0F) stbl = 0;
       }
    }
    return stbl;
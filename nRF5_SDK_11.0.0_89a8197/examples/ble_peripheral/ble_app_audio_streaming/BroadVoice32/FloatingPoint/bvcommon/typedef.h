@@ -27,7 +27,28 @@
 
 #ifndef	__TYPEDEF__
 #define	__TYPEDEF__
+
+/* SINGLE_PRECISION=1 selects a float32 build of the codec, so that cores   */
+/* with a single-precision FPU (Cortex-M4F) do not fall back to soft-float. */
+#if SINGLE_PRECISION
+typedef	float          Float;
+#define Fsqrt          sqrtf
+#define Fpow           powf
+#define Flog           logf
+#define Fcos           cosf
+#define Ffabs          fabsf
+#define Fldexp         ldexpf
+#define Ffrexp         frexpf
+#else
 typedef	double         Float;
+#define Fsqrt          sqrt
+#define Fpow           pow
+#define Flog           log
+#define Fcos           cos
+#define Ffabs          fabs
+#define Fldexp         ldexp
+#define Ffrexp         frexp
+#endif
 typedef unsigned char   UWord8;
 typedef unsigned int    UWord32;
 #endif
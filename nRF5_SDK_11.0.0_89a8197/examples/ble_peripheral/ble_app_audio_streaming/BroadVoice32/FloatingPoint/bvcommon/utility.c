@@ -34,7 +34,7 @@ void Fcopy(Float *y, Float *x, int size)
 
 void Fzero(Float *x, int size)
 {
-   while ((size--)>0) *x++ = 0.;
+   while ((size--)>0) *x++ = 0.0F;
 }
 
 void F2s(short *s, Float *f, int size)
@@ -46,11 +46,11 @@ void F2s(short *s, Float *f, int size)
       t = *f++;
       
       /* rounding */
-      if (t >= 0) t += 0.5;
-      else t -= 0.5;
+      if (t >= 0) t += 0.5F;
+      else t -= 0.5F;
       
-      if (t>32767) v = 32767;
-      else if (t<-32768.) v = -32768;
+      if (t>32767.0F) v = 32767;
+      else if (t<-32768.0F) v = -32768;
       else v = (short) t;
       *s++ = v;
    }
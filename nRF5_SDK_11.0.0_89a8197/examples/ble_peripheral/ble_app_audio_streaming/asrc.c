@@ -0,0 +1,119 @@
+#include "asrc.h"
+
+#include <string.h>
+
+#include "nrf.h"
+
+#define ASRC_ONE         (1UL << 30) /* 1.0 in Q30 */
+#define ASRC_FRAC_MASK   (ASRC_ONE - 1)
+#define ASRC_TAPS        4
+
+static __INLINE int16_t asrc_sat(int32_t value)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    else if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t) value;
+}
+
+/* Catmull-Rom between p_x[1] and p_x[2], t in Q15 */
+static __INLINE int16_t asrc_cubic(int16_t const * p_x, int32_t t)
+{
+    int32_t c1 = p_x[2] - p_x[0];
+    int32_t c2 = 2 * p_x[0] - 5 * p_x[1] + 4 * p_x[2] - p_x[3];
+    int32_t c3 = 3 * (p_x[1] - p_x[2]) + p_x[3] - p_x[0];
+    int32_t v;
+
+    v = (int32_t)(((int64_t) c3 * t) >> 15);
+    v = (int32_t)(((int64_t)(c2 + v) * t) >> 15);
+    v = (int32_t)(((int64_t)(c1 + v) * t) >> 15);
+
+    return asrc_sat(p_x[1] + ((v + 1) >> 1));
+}
+
+void asrc_init(asrc_t * p_asrc)
+{
+    memset(p_asrc, 0, sizeof(asrc_t));
+
+    // Two samples of silent history, so that the first output lies on the first input sample
+    p_asrc->len  = 2;
+    p_asrc->step = ASRC_ONE;
+}
+
+void asrc_ratio_set(asrc_t * p_asrc, int32_t ppm)
+{
+    if (ppm > ASRC_PPM_MAX)
+    {
+        ppm = ASRC_PPM_MAX;
+    }
+    else if (ppm < -ASRC_PPM_MAX)
+    {
+        ppm = -ASRC_PPM_MAX;
+    }
+
+    // 2^30 / 10^6 = 1073.74
+    p_asrc->step = (uint32_t)((int32_t) ASRC_ONE + ((ppm * 68719) >> 6));
+}
+
+uint32_t asrc_input_needed(asrc_t const * p_asrc, uint32_t out_len)
+{
+    uint32_t last_idx;
+
+    if (out_len == 0)
+    {
+        return 0;
+    }
+
+    // Integer position of the last output, and its interpolator taps
+    last_idx = p_asrc->idx + (uint32_t)(((uint64_t) p_asrc->frac + (uint64_t) p_asrc->step * (out_len - 1)) >> 30);
+
+    if (last_idx + ASRC_TAPS <= p_asrc->len)
+    {
+        return 0;
+    }
+
+    return last_idx + ASRC_TAPS - p_asrc->len;
+}
+
+uint32_t asrc_input_buffered(asrc_t const * p_asrc)
+{
+    return p_asrc->len - p_asrc->idx;
+}
+
+int16_t * asrc_input_get(asrc_t * p_asrc)
+{
+    return &p_asrc->buf[p_asrc->len];
+}
+
+void asrc_input_commit(asrc_t * p_asrc, uint32_t in_len)
+{
+    p_asrc->len += in_len;
+}
+
+void asrc_process(asrc_t * p_asrc, int16_t * p_out, uint32_t out_len)
+{
+    uint32_t idx  = p_asrc->idx;
+    uint32_t frac = p_asrc->frac;
+
+    for (uint32_t i = 0; i < out_len; ++i)
+    {
+        *p_out++ = asrc_cubic(&p_asrc->buf[idx], (int32_t)(frac >> 15));
+
+        frac += p_asrc->step;
+        idx  += frac >> 30;
+        frac &= ASRC_FRAC_MASK;
+    }
+
+    // Drop consumed input, keep the taps still needed for the next output
+    memmove(p_asrc->buf, &p_asrc->buf[idx], (p_asrc->len - idx) * sizeof(int16_t));
+
+    p_asrc->len -= idx;
+    p_asrc->idx  = 0;
+    p_asrc->frac = frac;
+}
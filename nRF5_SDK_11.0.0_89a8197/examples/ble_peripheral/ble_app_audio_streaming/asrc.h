@@ -0,0 +1,37 @@
+#ifndef __ASRC_H__
+#define __ASRC_H__
+
+#include <stdint.h>
+
+/* Asynchronous sample-rate converter for small ratio offsets.
+ *
+ * Reads its input at a fractional position that advances by (1 + ppm / 1e6) input samples
+ * per output sample, interpolating with a 4-point cubic (Catmull-Rom). Meant to run on the
+ * interpolated 31.25 kHz signal, where the cubic is accurate because the audio band is far
+ * below Nyquist. At 0 ppm the input passes through unchanged, delayed by one sample.
+ */
+
+#ifndef ASRC_IN_MAX_LEN
+#define ASRC_IN_MAX_LEN 320  /* Largest number of input samples committed at a time */
+#endif
+
+#define ASRC_PPM_MAX    2000 /* Largest ratio offset accepted by asrc_ratio_set() */
+
+typedef struct
+{
+    int16_t  buf[3 + 2 * ASRC_IN_MAX_LEN + 1]; /* Unconsumed input, including interpolator history */
+    uint32_t len;  /* Samples in buf */
+    uint32_t idx;  /* Integer read position */
+    uint32_t frac; /* Fractional read position (Q30) */
+    uint32_t step; /* Read position increment per output sample (Q30) */
+} asrc_t;
+
+void      asrc_init(asrc_t * p_asrc);
+void      asrc_ratio_set(asrc_t * p_asrc, int32_t ppm);
+uint32_t  asrc_input_needed(asrc_t const * p_asrc, uint32_t out_len);
+uint32_t  asrc_input_buffered(asrc_t const * p_asrc);
+int16_t * asrc_input_get(asrc_t * p_asrc);
+void      asrc_input_commit(asrc_t * p_asrc, uint32_t in_len);
+void      asrc_process(asrc_t * p_asrc, int16_t * p_out, uint32_t out_len);
+
+#endif /* __ASRC_H__ */
@@ -0,0 +1,84 @@
+#include "audio_capture.h"
+
+#include "typedef.h"
+#include "bv32cnst.h"
+#include "bvcommon.h"
+#include "bv32strct.h"
+#include "bv32.h"
+#include "bitpack.h"
+
+#if AUDIO_CAPTURE_FRAME_LEN != FRSZ
+#error AUDIO_CAPTURE_FRAME_LEN must match the BV32 frame size
+#endif
+
+#if AUDIO_CAPTURE_PACKED_LEN != BV32_PACKED_BYTES
+#error AUDIO_CAPTURE_PACKED_LEN must match the BV32 packed frame size
+#endif
+
+static struct BV32_Encoder_State m_encoder_state;
+
+void audio_capture_init(audio_capture_t * p_capture, int16_t mode, uint32_t cycle_budget)
+{
+    AUDIO_CAPTURE_CYCLES_ENABLE();
+
+    downsampler_init(&p_capture->downsampler);
+
+    // Clamps an unknown mode to BV32_MODE_FULL
+    Reset_BV32_Encoder(&m_encoder_state);
+    BV32_SetEncoderMode(&m_encoder_state, mode);
+
+    p_capture->cycle_budget = cycle_budget;
+
+    audio_capture_reset(p_capture);
+}
+
+void audio_capture_reset(audio_capture_t * p_capture)
+{
+    Word16 mode = m_encoder_state.mode;
+
+    downsampler_reset(&p_capture->downsampler);
+
+    // Reset_BV32_Encoder() goes back to BV32_MODE_FULL
+    Reset_BV32_Encoder(&m_encoder_state);
+    BV32_SetEncoderMode(&m_encoder_state, mode);
+
+    p_capture->cycles_last = 0;
+    p_capture->cycles_max  = 0;
+    p_capture->frames      = 0;
+    p_capture->frames_over = 0;
+}
+
+/* Encode one I2S frame (AUDIO_CAPTURE_IN_LEN samples) into p_packed (AUDIO_CAPTURE_PACKED_LEN bytes).
+   Returns false if the frame took more than the cycle budget. */
+bool audio_capture_process(audio_capture_t * p_capture, int16_t const * p_in, uint8_t * p_packed)
+{
+    struct BV32_Bit_Stream bs;
+    int16_t                pcm_stream[FRSZ];
+    uint32_t               start;
+    uint32_t               cycles;
+
+    start = AUDIO_CAPTURE_CYCLES();
+
+    downsampler_process(&p_capture->downsampler, p_in, AUDIO_CAPTURE_IN_LEN, pcm_stream);
+
+    BV32_Encode(&bs, &m_encoder_state, pcm_stream);
+    bv32fx_BitPack(p_packed, &bs);
+
+    cycles = (uint32_t)(AUDIO_CAPTURE_CYCLES() - start);
+
+    p_capture->cycles_last = cycles;
+    p_capture->frames++;
+
+    if (cycles > p_capture->cycles_max)
+    {
+        p_capture->cycles_max = cycles;
+    }
+
+    if (cycles > p_capture->cycle_budget)
+    {
+        p_capture->frames_over++;
+        return false;
+    }
+
+    return true;
+}
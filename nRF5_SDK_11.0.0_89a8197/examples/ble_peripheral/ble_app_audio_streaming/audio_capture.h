@@ -0,0 +1,60 @@
+#ifndef __AUDIO_CAPTURE_H__
+#define __AUDIO_CAPTURE_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "downsampler.h"
+#include "nrf.h"
+
+/* Capture chain: one I2S frame of ADC samples in, one packed BV32 frame out.
+ *
+ * The I2S frame (31.25 kHz) is decimated by DOWNSAMPLER_FACTOR to the rate BV32 frames are
+ * played at by the receiving side, encoded with the fixed-point BV32 encoder and packed.
+ * Each frame is timed with AUDIO_CAPTURE_CYCLES() and checked against a cycle budget. On the
+ * device this is the DWT cycle counter, so that the count includes the interrupts that preempt
+ * the encoder, and the budget bounds the share of the frame period the capture path takes.
+ * A host build defines AUDIO_CAPTURE_CYCLES() and AUDIO_CAPTURE_CYCLES_ENABLE() in its nrf.h.
+ *
+ * The encoder state is a static in audio_capture.c, where the fixed-point codec headers size it.
+ * This header cannot include them: audio_manager.c includes the floating-point ones, which use
+ * the same names. There is one capture chain, so every audio_capture_t uses that one state.
+ */
+
+#define AUDIO_CAPTURE_FRAME_LEN  80                                         /* BV32 frame size (in samples) */
+#define AUDIO_CAPTURE_IN_LEN     (AUDIO_CAPTURE_FRAME_LEN * DOWNSAMPLER_FACTOR) /* I2S samples per encoded frame */
+#define AUDIO_CAPTURE_PACKED_LEN 20                                         /* BV32 packed frame size (in bytes) */
+
+#ifndef AUDIO_CAPTURE_CYCLE_BUDGET
+#define AUDIO_CAPTURE_CYCLE_BUDGET 327680 /* Half of a 10.24 ms frame at 64 MHz, the rest is left to decoding and BLE */
+#endif
+
+#ifndef AUDIO_CAPTURE_CYCLES
+#define AUDIO_CAPTURE_CYCLES_ENABLE()                          \
+    do                                                         \
+    {                                                          \
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;        \
+        DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;            \
+    } while (0)
+#define AUDIO_CAPTURE_CYCLES()  (DWT->CYCCNT)
+#endif
+
+#if AUDIO_CAPTURE_IN_LEN > DOWNSAMPLER_MAX_IN_LEN
+#error DOWNSAMPLER_MAX_IN_LEN must hold an I2S frame
+#endif
+
+typedef struct
+{
+    downsampler_t downsampler;
+    uint32_t      cycle_budget;  /* Cycles allowed per frame */
+    uint32_t      cycles_last;   /* Cycles spent on the last frame */
+    uint32_t      cycles_max;    /* Most cycles spent on a frame since reset */
+    uint32_t      frames;        /* Frames encoded since reset */
+    uint32_t      frames_over;   /* Frames over the cycle budget since reset */
+} audio_capture_t;
+
+void audio_capture_init(audio_capture_t * p_capture, int16_t mode, uint32_t cycle_budget);
+void audio_capture_reset(audio_capture_t * p_capture);
+bool audio_capture_process(audio_capture_t * p_capture, int16_t const * p_in, uint8_t * p_packed);
+
+#endif /* __AUDIO_CAPTURE_H__ */
@@ -3,7 +3,10 @@
 #include "config.h"
 #include "drv_sgtl5000.h"
 #include "nrf_log.h"
-#include "fifo.h"
+#include "frame_fifo.h"
+#include "upsampler.h"
+#include "asrc.h"
+#include "audio_capture.h"
 
 #include "typedef.h"
 #include "bv32cnst.h"
@@ -17,16 +20,74 @@
 #include "bitpack.h"
 #endif
 
-#define AUDIO_UPSAMPLING_FACTOR 4 /* Upsample from 8 kHz to 32 kHz: audio hardware seems to like this rate better */
+#define AUDIO_UPSAMPLING_FACTOR UPSAMPLER_FACTOR /* Upsample from 8 kHz to 32 kHz: audio hardware seems to like this rate better */
 #define AUDIO_FRAME_SIZE        FRSZ
 
-static audio_codec_t m_audio_codec = AUDIO_CODEC_INVALID;
+#define AUDIO_PCM_FRAME_LEN     (AUDIO_FRAME_SIZE * AUDIO_UPSAMPLING_FACTOR) /* Samples per upsampled frame */
+
+#define AUDIO_I2S_FS            31250 /* DRV_SGTL5000_FS_31250HZ */
+#define AUDIO_FRAME_RX_TICKS    ((AUDIO_JB_RX_TIME_HZ * AUDIO_PCM_FRAME_LEN) / AUDIO_I2S_FS) /* Playout time of one frame */
+
+#define AUDIO_PLC_FRAMES_MAX    (HoldPLCG + AttnPLCG) /* BV32_PLC output is fully attenuated after this many frames */
+#define AUDIO_DECODE_BATCH_MAX  AUDIO_PCM_BUF_FRAMES  /* Most frames a decode pass needs at once */
+
+#define AUDIO_DECODE_EGU_TASK_DECODE 0
+#define AUDIO_DECODE_EGU_TASK_ENCODE 1
+
+#if AUDIO_FRAME_SIZE > UPSAMPLER_MAX_IN_LEN
+#error UPSAMPLER_MAX_IN_LEN must hold a BV32 frame
+#endif
+
+#if (AUDIO_PCM_BUF_FRAMES & (AUDIO_PCM_BUF_FRAMES - 1)) != 0
+#error AUDIO_PCM_BUF_FRAMES must be a power of two
+#endif
+
+#if AUDIO_CAPTURE_IN_LEN != AUDIO_PCM_FRAME_LEN
+#error Captured and played frames must have the same length at the I2S rate
+#endif
+
+#if ((AUDIO_CAPTURE_BUF_FRAMES & (AUDIO_CAPTURE_BUF_FRAMES - 1)) != 0) || ((AUDIO_CAPTURE_PKT_FRAMES & (AUDIO_CAPTURE_PKT_FRAMES - 1)) != 0)
+#error AUDIO_CAPTURE_BUF_FRAMES and AUDIO_CAPTURE_PKT_FRAMES must be powers of two
+#endif
+
+typedef enum
+{
+    AUDIO_FRAME_SAMPLE,    /* Encoded frame read from the sample buffer */
+    AUDIO_FRAME_STREAM,    /* Encoded frame peeked from the streaming FIFO, commit when decoded */
+    AUDIO_FRAME_LOST,      /* Frame dropped on FIFO overflow at this position, conceal it */
+    AUDIO_FRAME_UNDERRUN,  /* Streaming FIFO is empty after pre-buffering */
+    AUDIO_FRAME_NONE,      /* Nothing to decode right now (pre-buffering) */
+    AUDIO_FRAME_END,       /* End of sample or stream reached */
+} audio_frame_status_t;
+
+typedef enum
+{
+    AUDIO_JB_ACTION_NONE,    /* Decode the next frame as usual */
+    AUDIO_JB_ACTION_STRETCH, /* Play a concealment frame and keep the next frame: FIFO depth grows by one */
+    AUDIO_JB_ACTION_DROP,    /* Cross-fade two frames into one: FIFO depth shrinks by one */
+} audio_jb_action_t;
+
+static audio_codec_t       m_audio_codec = AUDIO_CODEC_INVALID;
+static audio_evt_handler_t m_evt_handler;
+static uint32_t            m_decode_ahead;
 
 static struct
 {
     struct BV32_Decoder_State ds;
 } m_bv32_codec_params;
 
+static upsampler_t m_upsampler;
+static asrc_t      m_asrc;
+
+/* Sender clock drift tracking: steers the ASRC ratio from the smoothed FIFO depth */
+static struct
+{
+    int32_t  setpoint; /* Depth to hold, taken again each time the jitter buffer inserts or removes a frame (frames, Q4) */
+    int32_t  integral; /* Integral term (ppm, Q16) */
+    int32_t  ppm;      /* Current ASRC ratio offset */
+    uint32_t settle;   /* Frames left until the integral term follows the depth again */
+} m_asrc_ctrl;
+
 static struct
 {
     bool      valid;
@@ -41,10 +102,612 @@ static struct
     uint32_t frames_left;
 } m_frame_buffer_state;
 
-static fifo_t   m_fifo_encoded_audio;
-static int16_t  m_i2s_tx_buffer[AUDIO_FRAME_SIZE * AUDIO_UPSAMPLING_FACTOR * 2]; // Double-buffered
-static bool     m_running;
-static bool     m_stop_when_fifo_empty;
+/* Adaptive jitter buffer. Arrival statistics are updated from the BLE context,
+   depth averaging and adjustments from the decode context. */
+static struct
+{
+    bool     adaptive;      /* Set the target depth from the measured jitter */
+    uint32_t floor;         /* Target depth limits (frames) */
+    uint32_t ceiling;
+    uint32_t target;        /* Target FIFO depth (frames) */
+    bool     rx_time_valid;
+    uint32_t rx_time_last;  /* Arrival time of the previous packet */
+    uint32_t jitter;        /* Inter-arrival jitter, peak with slow release (RTC ticks, Q4) */
+    int32_t  depth_avg;     /* Smoothed FIFO depth seen by the decoder (frames, Q4) */
+    uint32_t holdoff;       /* Frames left until the next depth adjustment is allowed */
+} m_jb;
+
+/* Frames dropped on FIFO overflow. The producer counts drops at one FIFO position
+   at a time, the decoder conceals them when it reaches that position. */
+static struct
+{
+    volatile uint32_t frame_idx;     /* FIFO write index at which frames were dropped */
+    volatile uint32_t lost;          /* Frames dropped (written by BLE context only) */
+    volatile uint32_t concealed;     /* Dropped frames concealed (written by decode context only) */
+} m_gap;
+
+static uint32_t m_plc_count; /* Consecutive frames concealed by BV32_PLC */
+
+/* Stream frames decoded in one BV32_DecodeFrames() call. They stay in the FIFO until played,
+   so the decoder state runs ahead of the FIFO read position while some are left. */
+static struct
+{
+    int16_t  pcm[AUDIO_DECODE_BATCH_MAX][AUDIO_FRAME_SIZE];
+    uint32_t count; /* Frames decoded */
+    uint32_t idx;   /* Next frame to play */
+} m_batch;
+
+/* Upsampled PCM frames decoded ahead of the I2S requests.
+   Written only by the decode interrupt, read only by the I2S interrupt. */
+static struct
+{
+    int16_t           buf[AUDIO_PCM_BUF_FRAMES][AUDIO_PCM_FRAME_LEN];
+    volatile uint32_t wr_idx;     /* Frames produced (free-running) */
+    volatile uint32_t rd_idx;     /* Frames consumed (free-running) */
+    volatile bool     draining;   /* Source ended: play out what is decoded, then stop */
+    volatile bool     underrun;   /* Set by I2S, reported from decode context */
+    bool              low_signaled;
+} m_pcm;
+
+/* Capture path. I2S frames are written only by the I2S interrupt and read only by the encode task,
+   encoded frames are written only by the encode task and read only by the sender. */
+static struct
+{
+    int16_t           pcm[AUDIO_CAPTURE_BUF_FRAMES][AUDIO_CAPTURE_IN_LEN];
+    volatile uint32_t pcm_wr_idx;  /* I2S frames received (free-running) */
+    volatile uint32_t pcm_rd_idx;  /* I2S frames encoded (free-running) */
+    uint8_t           pkt[AUDIO_CAPTURE_PKT_FRAMES][AUDIO_CAPTURE_PACKED_LEN];
+    volatile uint32_t pkt_wr_idx;  /* Frames encoded (free-running) */
+    volatile uint32_t pkt_rd_idx;  /* Frames sent (free-running) */
+    volatile bool     overrun;     /* Set by I2S or the encode task, reported from the encode task */
+    volatile bool     running;     /* Keeps I2S running when playback ends */
+} m_capture;
+
+static audio_capture_t m_audio_capture;
+
+static frame_fifo_t  m_fifo_encoded_audio;
+static int16_t       m_i2s_tx_buffer[AUDIO_FRAME_SIZE * AUDIO_UPSAMPLING_FACTOR * 2]; // Double-buffered
+static int16_t       m_i2s_rx_buffer[AUDIO_FRAME_SIZE * AUDIO_UPSAMPLING_FACTOR * 2]; // Double-buffered
+static volatile bool m_running;
+static bool          m_test_tone;
+static bool         m_stop_when_fifo_empty;
+
+static __INLINE uint32_t pcm_frames_ready(void)
+{
+    return m_pcm.wr_idx - m_pcm.rd_idx;
+}
+
+static void pcm_reset(void)
+{
+    m_pcm.wr_idx       = 0;
+    m_pcm.rd_idx       = 0;
+    m_pcm.draining     = false;
+    m_pcm.underrun     = false;
+    m_pcm.low_signaled = false;
+}
+
+static void decode_trigger(void)
+{
+    AUDIO_DECODE_EGU_INSTANCE->TASKS_TRIGGER[AUDIO_DECODE_EGU_TASK_DECODE] = 1;
+}
+
+static void encode_trigger(void)
+{
+    AUDIO_DECODE_EGU_INSTANCE->TASKS_TRIGGER[AUDIO_DECODE_EGU_TASK_ENCODE] = 1;
+}
+
+static __INLINE uint32_t capture_pkt_frames_ready(void)
+{
+    return m_capture.pkt_wr_idx - m_capture.pkt_rd_idx;
+}
+
+static void evt_send(audio_evt_type_t evt_type)
+{
+    audio_evt_t evt;
+    
+    if (m_evt_handler == 0)
+    {
+        return;
+    }
+    
+    evt.evt        = evt_type;
+    evt.pcm_frames = pcm_frames_ready();
+    evt.pkt_frames = capture_pkt_frames_ready();
+    
+    m_evt_handler(&evt);
+}
+
+static void jb_target_update(void)
+{
+    uint32_t target;
+    
+    target = m_jb.floor + ((m_jb.jitter >> 4) + AUDIO_FRAME_RX_TICKS - 1) / AUDIO_FRAME_RX_TICKS;
+    
+    if (target > m_jb.ceiling)
+    {
+        target = m_jb.ceiling;
+    }
+    
+    m_jb.target = target;
+}
+
+static void jb_stream_reset(void)
+{
+    m_jb.rx_time_valid = false;
+    m_jb.depth_avg     = m_jb.target << 4;
+    m_jb.holdoff       = AUDIO_JB_ADJUST_INTERVAL;
+}
+
+static void jb_rx_update(uint32_t rx_time)
+{
+    uint32_t interval;
+    uint32_t deviation;
+    
+    if (m_jb.rx_time_valid)
+    {
+        interval = (rx_time - m_jb.rx_time_last) & AUDIO_JB_RX_TIME_MASK;
+        
+        if (interval > AUDIO_FRAME_RX_TICKS)
+        {
+            deviation = interval - AUDIO_FRAME_RX_TICKS;
+        }
+        else
+        {
+            deviation = AUDIO_FRAME_RX_TICKS - interval;
+        }
+        
+        // Follow jitter peaks immediately, release over roughly 1000 packets (10 s)
+        if ((deviation << 4) > m_jb.jitter)
+        {
+            m_jb.jitter = deviation << 4;
+        }
+        else
+        {
+            m_jb.jitter -= (m_jb.jitter >> 10);
+        }
+        
+        if (m_jb.adaptive)
+        {
+            jb_target_update();
+        }
+    }
+    
+    m_jb.rx_time_last  = rx_time;
+    m_jb.rx_time_valid = true;
+}
+
+/* True if frames were dropped on FIFO overflow at this FIFO position and are not concealed yet */
+static __INLINE bool gap_at(uint32_t frame_idx)
+{
+    return (m_gap.lost != m_gap.concealed) && (m_gap.frame_idx == frame_idx);
+}
+
+static void jb_depth_update(uint32_t depth)
+{
+    m_jb.depth_avg += ((int32_t)(depth << 4) - m_jb.depth_avg) >> 3;
+}
+
+static audio_jb_action_t jb_action_get(void)
+{
+    if (m_jb.holdoff != 0)
+    {
+        --m_jb.holdoff;
+        return AUDIO_JB_ACTION_NONE;
+    }
+    
+    // Dropping merges the next frame into this one. It must be in the FIFO, and not after a gap:
+    // decoding it would move the FIFO past the gap position before the gap is concealed.
+    if ((m_jb.depth_avg > (int32_t)((m_jb.target + 1) << 4)) && (frame_fifo_num_elem_get(&m_fifo_encoded_audio) >= 2) &&
+        !gap_at(m_fifo_encoded_audio.rd_idx + 1))
+    {
+        m_jb.holdoff = AUDIO_JB_ADJUST_INTERVAL;
+        return AUDIO_JB_ACTION_DROP;
+    }
+    
+    // Stretching conceals from the decoder state, which must not be ahead of the FIFO
+    if ((m_jb.depth_avg < (int32_t)((m_jb.target - 1) << 4)) && (m_batch.idx == m_batch.count))
+    {
+        m_jb.holdoff = AUDIO_JB_ADJUST_INTERVAL;
+        return AUDIO_JB_ACTION_STRETCH;
+    }
+    
+    return AUDIO_JB_ACTION_NONE;
+}
+
+static audio_frame_status_t frame_get(uint8_t ** pp_packed_stream, uint32_t len)
+{
+    if (m_sample_info.valid)
+    {
+        // Get frame from sample buffer
+        
+        if ((m_sample_info.sample_idx + len) < m_sample_info.sample_len)
+        {
+            *pp_packed_stream         = &m_sample_info.p_sample[m_sample_info.sample_idx];
+            m_sample_info.sample_idx += len;
+            return AUDIO_FRAME_SAMPLE;
+        }
+        
+        // End of buffer reached. Stop playback
+        m_sample_info.valid = false;
+        return AUDIO_FRAME_END;
+    }
+    
+    if (m_frame_buffer_state.buffering)
+    {
+        if (m_stop_when_fifo_empty)
+        {
+            // Stopped before pre-buffering completed
+            m_stop_when_fifo_empty = false;
+            return AUDIO_FRAME_END;
+        }
+        
+        return AUDIO_FRAME_NONE;
+    }
+    
+    if (gap_at(m_fifo_encoded_audio.rd_idx))
+    {
+        m_gap.concealed++;
+        return AUDIO_FRAME_LOST;
+    }
+    
+    // Get frame from streaming FIFO, decoded in place
+    *pp_packed_stream = frame_fifo_peek(&m_fifo_encoded_audio);
+    
+    if (*pp_packed_stream != 0)
+    {
+        return AUDIO_FRAME_STREAM;
+    }
+    
+    if (m_stop_when_fifo_empty)
+    {
+        m_stop_when_fifo_empty = false;
+        return AUDIO_FRAME_END;
+    }
+    
+    return AUDIO_FRAME_UNDERRUN;
+}
+
+static void frame_decode(uint8_t * p_packed_stream, int16_t * p_pcm_stream)
+{
+    BV32_DecodeFrames(p_packed_stream, NULL, 1, &m_bv32_codec_params.ds, p_pcm_stream);
+}
+
+/* Decode the frame at the FIFO read position. The slots are contiguous up to the ring wrap, so
+   the frames this decode pass still needs are handed to the decoder in one call. */
+static void frame_decode_stream(int16_t * p_pcm_stream)
+{
+    if (m_batch.idx == m_batch.count)
+    {
+        uint32_t rd_idx = m_fifo_encoded_audio.rd_idx;
+        uint32_t count  = frame_fifo_contiguous_get(&m_fifo_encoded_audio);
+        uint32_t needed = m_decode_ahead - pcm_frames_ready();
+        
+        if (count > needed)
+        {
+            count = needed;
+        }
+        
+        // Stop at a gap: the frames after it are played once it is concealed
+        if ((m_gap.lost != m_gap.concealed) && ((m_gap.frame_idx - rd_idx) < count))
+        {
+            count = m_gap.frame_idx - rd_idx;
+        }
+        
+        BV32_DecodeFrames(frame_fifo_peek(&m_fifo_encoded_audio), NULL, count, &m_bv32_codec_params.ds, m_batch.pcm[0]);
+        
+        m_batch.count = count;
+        m_batch.idx   = 0;
+    }
+    
+    memcpy(p_pcm_stream, m_batch.pcm[m_batch.idx++], sizeof(m_batch.pcm[0]));
+}
+
+/* The jitter buffer inserted (frames > 0) or removed frames: hold the depth it leaves.
+   Whatever made it act (lost packets, jitter) is not sender drift, so the integral term holds for a while. */
+static void asrc_setpoint_anchor(int32_t frames)
+{
+    m_asrc_ctrl.setpoint = m_jb.depth_avg + (frames << 4);
+    m_asrc_ctrl.settle   = AUDIO_ASRC_SETTLE_FRAMES;
+}
+
+static void frame_cross_fade(int16_t * p_pcm_stream, int16_t const * p_pcm_stream_next)
+{
+    // Fade from the first frame into the second over the whole frame, so that both frame boundaries stay continuous
+    for (int i = 0; i < AUDIO_FRAME_SIZE; ++i)
+    {
+        p_pcm_stream[i] = (int16_t)(((int32_t)p_pcm_stream[i] * (AUDIO_FRAME_SIZE - i) + (int32_t)p_pcm_stream_next[i] * i) / AUDIO_FRAME_SIZE);
+    }
+}
+
+static void frame_upsample(int16_t const * p_pcm_stream, int16_t * p_pcm)
+{
+    // Upsample the decompressed audio (because audio hardware requirements), interpolating straight into the ASRC input
+    upsampler_process(&m_upsampler, p_pcm_stream, AUDIO_FRAME_SIZE, p_pcm);
+}
+
+/* Decode (or conceal) the next frame and interpolate it to the I2S rate.
+   Returns false when there is nothing to play right now. */
+static bool frame_produce(int16_t * p_pcm)
+{
+    uint8_t * p_packed_stream;
+    int16_t   pcm_stream[AUDIO_FRAME_SIZE];
+    int16_t   pcm_stream_next[AUDIO_FRAME_SIZE];
+    
+    for (;;)
+    {
+        audio_frame_status_t status;
+        audio_jb_action_t    action;
+        
+        status = frame_get(&p_packed_stream, FRAME_FIFO_SLOT_SIZE);
+        
+        if (status == AUDIO_FRAME_END)
+        {
+            m_pcm.draining = true;
+        }
+        
+        if (status == AUDIO_FRAME_LOST || status == AUDIO_FRAME_UNDERRUN)
+        {
+            if (m_plc_count >= AUDIO_PLC_FRAMES_MAX)
+            {
+                // Concealment has faded out (or nothing was decoded yet): skip lost frames, let I2S play silence
+                if (status == AUDIO_FRAME_LOST)
+                {
+                    continue;
+                }
+                return false;
+            }
+            
+            if (status == AUDIO_FRAME_UNDERRUN && pcm_frames_ready() != 0)
+            {
+                // The frame may still arrive in time: conceal only when I2S would otherwise run dry
+                return false;
+            }
+            
+            // Extrapolate from the decoder state with the PLC attenuation schedule.
+            // BV32_Decode() resynchronizes on the next real frame.
+            BV32_PLC(&m_bv32_codec_params.ds, pcm_stream);
+            m_plc_count++;
+            
+            if (status == AUDIO_FRAME_UNDERRUN)
+            {
+                // The late frame is played after this one, as for a stretch
+                asrc_setpoint_anchor(1);
+            }
+            
+            frame_upsample(pcm_stream, p_pcm);
+            
+            evt_send(AUDIO_EVT_FRAME_CONCEALED);
+            return true;
+        }
+        
+        if (status != AUDIO_FRAME_SAMPLE && status != AUDIO_FRAME_STREAM)
+        {
+            return false;
+        }
+        
+        action = AUDIO_JB_ACTION_NONE;
+        
+        if (status == AUDIO_FRAME_STREAM)
+        {
+            jb_depth_update(frame_fifo_num_elem_get(&m_fifo_encoded_audio));
+            
+            // A fixed target is held the same way, so that lost packets do not drain the FIFO
+            action = jb_action_get();
+        }
+        
+        if (action == AUDIO_JB_ACTION_STRETCH)
+        {
+            // Leave the frame in the FIFO and play one frame of concealment in its place
+            BV32_PLC(&m_bv32_codec_params.ds, pcm_stream);
+            asrc_setpoint_anchor(1);
+        }
+        else
+        {
+            if (status == AUDIO_FRAME_STREAM)
+            {
+                frame_decode_stream(pcm_stream);
+                frame_fifo_commit(&m_fifo_encoded_audio);
+            }
+            else
+            {
+                frame_decode(p_packed_stream, pcm_stream);
+            }
+            
+            m_plc_count = 0;
+            
+            if (action == AUDIO_JB_ACTION_DROP)
+            {
+                // Depth >= 2 and no gap before the next frame were checked, so the next frame is available
+                frame_decode_stream(pcm_stream_next);
+                frame_fifo_commit(&m_fifo_encoded_audio);
+                
+                frame_cross_fade(pcm_stream, pcm_stream_next);
+                asrc_setpoint_anchor(-1);
+            }
+        }
+        
+        frame_upsample(pcm_stream, p_pcm);
+        return true;
+    }
+}
+
+static void asrc_ratio_update(void)
+{
+    int32_t error;
+    int32_t ppm;
+    
+    if (m_sample_info.valid)
+    {
+        // Local sample playback follows the I2S clock
+        asrc_ratio_set(&m_asrc, 0);
+        return;
+    }
+    
+    if (m_frame_buffer_state.buffering)
+    {
+        // FIFO depth is not meaningful until pre-buffering completes
+        return;
+    }
+    
+    // PI control on the jitter buffer depth average. Read the input faster when the FIFO fills
+    // above the set-point (sender clock is fast). Drift moves the depth by a fraction of a frame
+    // per second: a larger error comes from jitter or lost packets, which the jitter buffer makes
+    // up for, so the error is limited to one frame.
+    error = m_jb.depth_avg - m_asrc_ctrl.setpoint;
+    
+    if (error > (1 << 4))
+    {
+        error = (1 << 4);
+    }
+    else if (error < -(1 << 4))
+    {
+        error = -(1 << 4);
+    }
+    
+    if (m_asrc_ctrl.settle != 0)
+    {
+        --m_asrc_ctrl.settle;
+    }
+    else
+    {
+        m_asrc_ctrl.integral += error * AUDIO_ASRC_KI;
+    }
+    
+    ppm = ((error * AUDIO_ASRC_KP) >> 4) + (m_asrc_ctrl.integral >> 16);
+    
+    // At the clamp, take back what the integral term holds beyond it, so that it does not wind up
+    if (ppm > AUDIO_ASRC_PPM_MAX)
+    {
+        m_asrc_ctrl.integral -= (ppm - AUDIO_ASRC_PPM_MAX) << 16;
+        ppm                   = AUDIO_ASRC_PPM_MAX;
+    }
+    else if (ppm < -AUDIO_ASRC_PPM_MAX)
+    {
+        m_asrc_ctrl.integral -= (ppm + AUDIO_ASRC_PPM_MAX) << 16;
+        ppm                   = -AUDIO_ASRC_PPM_MAX;
+    }
+    
+    m_asrc_ctrl.ppm = ppm;
+    asrc_ratio_set(&m_asrc, ppm);
+}
+
+/* Encode the I2S frames captured so far and queue them for the sender */
+static void capture_encode(void)
+{
+    uint8_t packed_dropped[AUDIO_CAPTURE_PACKED_LEN];
+    bool    ready = false;
+    
+    while (m_capture.pcm_wr_idx != m_capture.pcm_rd_idx)
+    {
+        uint8_t * p_packed;
+        bool      in_budget;
+        
+        if (capture_pkt_frames_ready() == AUDIO_CAPTURE_PKT_FRAMES)
+        {
+            // Sender fell behind: still encode, so that the encoder state follows the input, but drop the frame
+            p_packed          = packed_dropped;
+            m_capture.overrun = true;
+        }
+        else
+        {
+            p_packed = m_capture.pkt[m_capture.pkt_wr_idx & (AUDIO_CAPTURE_PKT_FRAMES - 1)];
+        }
+        
+        in_budget = audio_capture_process(&m_audio_capture, m_capture.pcm[m_capture.pcm_rd_idx & (AUDIO_CAPTURE_BUF_FRAMES - 1)], p_packed);
+        
+        // Release the I2S frame and publish the encoded one only after they are completely read and written
+        __DMB();
+        m_capture.pcm_rd_idx++;
+        
+        if (p_packed != packed_dropped)
+        {
+            m_capture.pkt_wr_idx++;
+            ready = true;
+        }
+        
+        if (!in_budget)
+        {
+            evt_send(AUDIO_EVT_CAPTURE_OVER_BUDGET);
+        }
+    }
+    
+    if (m_capture.overrun)
+    {
+        m_capture.overrun = false;
+        evt_send(AUDIO_EVT_CAPTURE_OVERRUN);
+    }
+    
+    if (ready)
+    {
+        evt_send(AUDIO_EVT_CAPTURE_FRAME_READY);
+    }
+}
+
+void AUDIO_DECODE_EGU_IRQHandler(void)
+{
+    if (AUDIO_DECODE_EGU_INSTANCE->EVENTS_TRIGGERED[AUDIO_DECODE_EGU_TASK_ENCODE] != 0)
+    {
+        AUDIO_DECODE_EGU_INSTANCE->EVENTS_TRIGGERED[AUDIO_DECODE_EGU_TASK_ENCODE] = 0;
+        
+        capture_encode();
+    }
+    
+    if (AUDIO_DECODE_EGU_INSTANCE->EVENTS_TRIGGERED[AUDIO_DECODE_EGU_TASK_DECODE] == 0)
+    {
+        return;
+    }
+    
+    AUDIO_DECODE_EGU_INSTANCE->EVENTS_TRIGGERED[AUDIO_DECODE_EGU_TASK_DECODE] = 0;
+    
+    if (m_pcm.underrun)
+    {
+        m_pcm.underrun = false;
+        evt_send(AUDIO_EVT_PCM_UNDERRUN);
+    }
+    
+    if (!m_pcm.low_signaled && pcm_frames_ready() <= AUDIO_PCM_LOW_WATERMARK)
+    {
+        m_pcm.low_signaled = true;
+        evt_send(AUDIO_EVT_PCM_LOW_WATERMARK);
+    }
+    
+    // Decode ahead until the configured depth is reached or the source runs dry
+    while (!m_pcm.draining && (pcm_frames_ready() < m_decode_ahead))
+    {
+        bool available = true;
+        
+        asrc_ratio_update();
+        
+        // Decode and interpolate frames into the ASRC input until it can produce a whole I2S frame
+        while (asrc_input_needed(&m_asrc, AUDIO_PCM_FRAME_LEN) != 0)
+        {
+            if (!frame_produce(asrc_input_get(&m_asrc)))
+            {
+                available = false;
+                break;
+            }
+            
+            asrc_input_commit(&m_asrc, AUDIO_PCM_FRAME_LEN);
+        }
+        
+        if (!available)
+        {
+            break;
+        }
+        
+        asrc_process(&m_asrc, m_pcm.buf[m_pcm.wr_idx & (AUDIO_PCM_BUF_FRAMES - 1)], AUDIO_PCM_FRAME_LEN);
+        
+        // Publish the frame only after it is completely written
+        __DMB();
+        m_pcm.wr_idx++;
+    }
+    
+    if (m_pcm.low_signaled && pcm_frames_ready() >= m_decode_ahead)
+    {
+        m_pcm.low_signaled = false;
+        evt_send(AUDIO_EVT_PCM_HIGH_WATERMARK);
+    }
+}
 
 static bool codec_driver_evt_handler(drv_sgtl5000_evt_t * p_evt)
 {
@@ -55,106 +718,113 @@ static bool codec_driver_evt_handler(drv_sgtl5000_evt_t * p_evt)
     switch (p_evt->evt)
     {
         case DRV_SGTL5000_EVT_I2S_TX_BUF_REQ:
-            // I2S TX buffer values requested
+            // I2S TX buffer values requested: hand out a frame decoded ahead, never decode here
+            
+            APP_ERROR_CHECK_BOOL(p_evt->param.tx_buf_req.number_of_words == ((AUDIO_PCM_FRAME_LEN * sizeof(int16_t)) / sizeof(uint32_t)));
+            
+            if (!m_running)
             {
-                struct BV32_Bit_Stream bs;
-                uint32_t               buf_len;
-                uint8_t                packed_stream[20];
-                int16_t                pcm_stream[AUDIO_FRAME_SIZE];
+                // I2S only running for capture: play silence
+                memset(p_evt->param.tx_buf_req.p_data_to_send, 0, p_evt->param.tx_buf_req.number_of_words * sizeof(uint32_t));
+                break;
+            }
+            
+            if (pcm_frames_ready() != 0)
+            {
+                memcpy(p_evt->param.tx_buf_req.p_data_to_send, 
+                       m_pcm.buf[m_pcm.rd_idx & (AUDIO_PCM_BUF_FRAMES - 1)], 
+                       AUDIO_PCM_FRAME_LEN * sizeof(int16_t));
                 
-                if (m_sample_info.valid)
-                {
-                    // Get frame from sample buffer
-                    
-                    if ((m_sample_info.sample_idx + sizeof(packed_stream)) < m_sample_info.sample_len)
-                    {
-                        memcpy(packed_stream, &m_sample_info.p_sample[m_sample_info.sample_idx], sizeof(packed_stream));
-                        m_sample_info.sample_idx += sizeof(packed_stream);
-                        buf_len                   = sizeof(packed_stream);
-                        ret                       = true; // Continue streaming in case of buffer underrun
-                    }
-                    else
-                    {
-                        // End of buffer reached. Stop playback
-                        m_sample_info.valid = false;
-                        m_running           = false;
-                        ret                 = false;
-                        buf_len             = 0;
-                    }
-                }
-                else if (!m_frame_buffer_state.buffering)
-                {
-                    // Get frame from streaming FIFO
-                    
-                    APP_ERROR_CHECK_BOOL(p_evt->param.tx_buf_req.number_of_words == ((AUDIO_FRAME_SIZE * AUDIO_UPSAMPLING_FACTOR * sizeof(int16_t))/ sizeof(uint32_t)));
-                    
-                    buf_len = sizeof(packed_stream);
-                    
-                    CRITICAL_REGION_ENTER();
-                    fifo_get_pkt(&m_fifo_encoded_audio, packed_stream, &buf_len);
-                    CRITICAL_REGION_EXIT();
-                }
-                else
-                {
-                    buf_len = 0;
-                    ret     = true;
-                }
+                // Release the slot only after it has been copied out
+                __DMB();
+                m_pcm.rd_idx++;
+            }
+            else
+            {
+                // No data to process: set to 0
+                memset(p_evt->param.tx_buf_req.p_data_to_send, 0, p_evt->param.tx_buf_req.number_of_words * sizeof(uint32_t)); 
                 
-                if ((buf_len != sizeof(packed_stream)) && m_stop_when_fifo_empty)
+                if (m_pcm.draining)
                 {
-                    // End of buffer reached. Stop playback
-                    m_sample_info.valid    = false;
-                    m_running              = false;
-                    ret                    = false;
-                    m_stop_when_fifo_empty = false;
-                    buf_len                = 0;
-                    memset(p_evt->param.tx_buf_req.p_data_to_send, 0, p_evt->param.tx_buf_req.number_of_words * sizeof(uint32_t)); 
+                    // End of sample or stream reached, and everything decoded has been played.
+                    // Stop playback, and I2S too unless it is capturing.
+                    m_pcm.draining = false;
+                    m_running      = false;
+                    ret            = m_capture.running;
                     memset(&m_frame_buffer_state, 0, sizeof(m_frame_buffer_state));
-                    return false;
-                }
-                else if (buf_len != sizeof(packed_stream))
-                {
-                    // No data to process: set to 0
-                    memset(p_evt->param.tx_buf_req.p_data_to_send, 0, p_evt->param.tx_buf_req.number_of_words * sizeof(uint32_t)); 
                     return ret;
                 }
                 
-                BV32_BitUnPack(packed_stream, &bs);
-                BV32_Decode(&bs, &m_bv32_codec_params.ds, pcm_stream);
-//                BV32_Decode(&bs, &m_bv32_codec_params.ds, (short*)p_evt->param.tx_buf_req.p_data_to_send);
-                
-                // Upsample the decompressed audio (because audio hardware requirements)
-                for (int i = 0, pcm_stream_idx = 0; i < (AUDIO_FRAME_SIZE * AUDIO_UPSAMPLING_FACTOR); i += AUDIO_UPSAMPLING_FACTOR)
+                if (!m_frame_buffer_state.buffering)
                 {
-                    for (int j = i; j < (i + AUDIO_UPSAMPLING_FACTOR); ++j)
-                    {
-                        ((int16_t*)p_evt->param.tx_buf_req.p_data_to_send)[j] = pcm_stream[pcm_stream_idx];
-                    }
-                    ++pcm_stream_idx;
+                    m_pcm.underrun = true;
                 }
             }
+            
+            decode_trigger();
+            break;
+        
+        case DRV_SGTL5000_EVT_I2S_RX_BUF_RECEIVED:
+            // ADC samples received: queue the frame for the encode task, never encode here
+            
+            APP_ERROR_CHECK_BOOL(p_evt->param.rx_buf_received.number_of_words == ((AUDIO_CAPTURE_IN_LEN * sizeof(int16_t)) / sizeof(uint32_t)));
+            
+            if (!m_capture.running)
+            {
+                break;
+            }
+            
+            if ((m_capture.pcm_wr_idx - m_capture.pcm_rd_idx) < AUDIO_CAPTURE_BUF_FRAMES)
+            {
+                memcpy(m_capture.pcm[m_capture.pcm_wr_idx & (AUDIO_CAPTURE_BUF_FRAMES - 1)], 
+                       p_evt->param.rx_buf_received.p_data_received, 
+                       AUDIO_CAPTURE_IN_LEN * sizeof(int16_t));
+                
+                // Publish the frame only after it is completely written
+                __DMB();
+                m_capture.pcm_wr_idx++;
+            }
+            else
+            {
+                // Encoder fell behind
+                m_capture.overrun = true;
+            }
+            
+            encode_trigger();
             break;
     }
     
     return ret;
 }
 
-static uint32_t audio_pkt_process_bv32(void * p_packed_stream, uint32_t len)
+static uint32_t audio_pkt_process_bv32(void * p_packed_stream, uint32_t len, uint32_t rx_time)
 {
     bool success;
     
-    if (len != 20)
+    if (len != FRAME_FIFO_SLOT_SIZE)
     {
         // BV32 frames are always 20 bytes
         return NRF_ERROR_INVALID_PARAM;
     }
     
-    CRITICAL_REGION_ENTER();
-    success = fifo_put_pkt(&m_fifo_encoded_audio, (uint8_t *) p_packed_stream, len);
-    CRITICAL_REGION_EXIT();
+    jb_rx_update(rx_time);
+    
+    success = frame_fifo_put(&m_fifo_encoded_audio, (uint8_t const *) p_packed_stream);
     
     if (!success)
     {
+        // Remember where the stream has a gap, so that the decoder conceals it instead of skipping ahead
+        if (m_gap.lost == m_gap.concealed)
+        {
+            m_gap.frame_idx = m_fifo_encoded_audio.wr_idx;
+            __DMB();
+            m_gap.lost++;
+        }
+        else if (m_gap.frame_idx == m_fifo_encoded_audio.wr_idx)
+        {
+            m_gap.lost++;
+        }
+        
         return NRF_ERROR_NO_MEM;
     }
     
@@ -169,6 +839,12 @@ static uint32_t audio_pkt_process_bv32(void * p_packed_stream, uint32_t len)
         }
     }
     
+    if (!m_frame_buffer_state.buffering)
+    {
+        // Start decoding ahead right away if the PCM buffer is not full
+        decode_trigger();
+    }
+    
     return NRF_SUCCESS;
 }
 
@@ -190,21 +866,84 @@ uint32_t audio_manager_init(audio_init_t * p_params)
         return NRF_ERROR_INVALID_PARAM;
     }
     
+    if (p_params->decode_ahead == 0)
+    {
+        m_decode_ahead = AUDIO_DECODE_AHEAD_DEFAULT;
+    }
+    else if (p_params->decode_ahead >= 2 && p_params->decode_ahead <= AUDIO_PCM_BUF_FRAMES)
+    {
+        m_decode_ahead = p_params->decode_ahead;
+    }
+    else
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    
+    m_jb.floor   = (p_params->jb_floor   == 0) ? AUDIO_JB_FLOOR_DEFAULT   : p_params->jb_floor;
+    m_jb.ceiling = (p_params->jb_ceiling == 0) ? AUDIO_JB_CEILING_DEFAULT : p_params->jb_ceiling;
+    
+    if (m_jb.floor > m_jb.ceiling || m_jb.ceiling >= FRAME_FIFO_SLOTS)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    
+    if (p_params->capture_mode > AUDIO_CAPTURE_MODE_FAST)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    
+    // Start from AUDIO_JB_TARGET_INITIAL until jitter has been measured
+    m_jb.adaptive = false;
+    m_jb.jitter   = 0;
+    
+    if (AUDIO_JB_TARGET_INITIAL > m_jb.floor)
+    {
+        m_jb.jitter = ((AUDIO_JB_TARGET_INITIAL - m_jb.floor) * AUDIO_FRAME_RX_TICKS) << 4;
+    }
+    
+    jb_target_update();
+    
+    m_evt_handler          = p_params->evt_handler;
     m_running              = false;
     m_stop_when_fifo_empty = false;
     
     memset(&m_sample_info, 0, sizeof(m_sample_info));
     memset(&m_frame_buffer_state, 0, sizeof(m_frame_buffer_state));
+    pcm_reset();
+    
+    // Initialize decode interrupt, also used for encoding
+    AUDIO_DECODE_EGU_INSTANCE->EVENTS_TRIGGERED[AUDIO_DECODE_EGU_TASK_DECODE] = 0;
+    AUDIO_DECODE_EGU_INSTANCE->EVENTS_TRIGGERED[AUDIO_DECODE_EGU_TASK_ENCODE] = 0;
+    AUDIO_DECODE_EGU_INSTANCE->INTENCLR = 0xFFFFFFFF;
+    AUDIO_DECODE_EGU_INSTANCE->INTENSET = (1UL << AUDIO_DECODE_EGU_TASK_DECODE) | (1UL << AUDIO_DECODE_EGU_TASK_ENCODE);
+    NVIC_ClearPendingIRQ(AUDIO_DECODE_EGU_IRQn);
+    NVIC_SetPriority(AUDIO_DECODE_EGU_IRQn, AUDIO_DECODE_EGU_IRQPriority);
+    NVIC_EnableIRQ(AUDIO_DECODE_EGU_IRQn);
     
     // Initialize audio decoder
     Reset_BV32_Decoder(&m_bv32_codec_params.ds);
+    upsampler_init(&m_upsampler);
+    asrc_init(&m_asrc);
+    
+    // Initialize audio encoder (BV32 mode numbers follow audio_capture_mode_t)
+    memset(&m_capture, 0, sizeof(m_capture));
+    
+    if (p_params->capture_budget == 0)
+    {
+        audio_capture_init(&m_audio_capture, (int16_t) p_params->capture_mode, AUDIO_CAPTURE_CYCLE_BUDGET);
+    }
+    else
+    {
+        audio_capture_init(&m_audio_capture, (int16_t) p_params->capture_mode, p_params->capture_budget);
+    }
     
     // Initialize FIFO 
-    fifo_init(&m_fifo_encoded_audio);
+    frame_fifo_init(&m_fifo_encoded_audio);
     
     // Initialize codec hardware
     codec_params.i2s_tx_buffer     = (void*)m_i2s_tx_buffer;
     codec_params.i2s_tx_buffer_len = sizeof(m_i2s_tx_buffer);
+    codec_params.i2s_rx_buffer     = (void*)m_i2s_rx_buffer;
     codec_params.evt_handler       = codec_driver_evt_handler;
     codec_params.fs                = DRV_SGTL5000_FS_31250HZ;
     
@@ -220,7 +959,13 @@ uint32_t audio_manager_streaming_begin(void)
         return NRF_ERROR_INVALID_STATE;
     }
     
-    fifo_init(&m_fifo_encoded_audio);
+    frame_fifo_init(&m_fifo_encoded_audio);
+    pcm_reset();
+    jb_stream_reset();
+    
+    m_gap.lost      = 0;
+    m_gap.concealed = 0;
+    m_plc_count     = AUDIO_PLC_FRAMES_MAX; // Nothing to conceal before the first frame
     
     memset(m_i2s_tx_buffer, 0, sizeof(m_i2s_tx_buffer));
     
@@ -228,8 +973,22 @@ uint32_t audio_manager_streaming_begin(void)
     {
         case AUDIO_CODEC_BV32:
             Reset_BV32_Decoder(&m_bv32_codec_params.ds);
+            upsampler_reset(&m_upsampler);
+            asrc_init(&m_asrc);
+            
+            m_batch.count = 0;
+            m_batch.idx   = 0;
+            
+            m_asrc_ctrl.setpoint = m_jb.target << 4;
+            m_asrc_ctrl.integral = 0;
+            m_asrc_ctrl.ppm      = 0;
+            m_asrc_ctrl.settle   = 0;
         
-            err_code = drv_sgtl5000_start();
+            // Decode ahead before the first I2S request
+            decode_trigger();
+            
+            // Capture may have started I2S already
+            err_code = m_capture.running ? NRF_SUCCESS : drv_sgtl5000_start();
             break;
         
         default:
@@ -253,6 +1012,25 @@ uint32_t audio_manager_streaming_begin_buffered(uint32_t frame_count)
     }
     m_frame_buffer_state.frames_left = frame_count;
     m_frame_buffer_state.buffering   = true;
+    m_jb.adaptive                    = false;
+    m_jb.target                      = frame_count; // Drift tracking holds the FIFO at the pre-buffered depth
+    
+    return audio_manager_streaming_begin();
+}
+
+uint32_t audio_manager_streaming_begin_adaptive(void)
+{
+    if (m_running)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    
+    // Pre-buffer to the target depth from the jitter measured so far, then keep adjusting it
+    jb_target_update();
+    
+    m_frame_buffer_state.frames_left = m_jb.target;
+    m_frame_buffer_state.buffering   = true;
+    m_jb.adaptive                    = true;
     
     return audio_manager_streaming_begin();
 }
@@ -261,7 +1039,7 @@ uint32_t audio_manager_play_test_tone(void)
 {
     uint32_t err_code;
     
-    if (m_running)
+    if (m_running || m_capture.running)
     {
         return NRF_ERROR_INVALID_STATE;
     }
@@ -269,7 +1047,8 @@ uint32_t audio_manager_play_test_tone(void)
     err_code = drv_sgtl5000_start_1khz_test_tone();
     if (err_code == NRF_SUCCESS)
     {
-        m_running = true;
+        m_running   = true;
+        m_test_tone = true;
     }
     
     return err_code;
@@ -286,10 +1065,12 @@ uint32_t audio_manager_streaming_end(bool wait_for_fifo)
     
     if (!wait_for_fifo)
     {    
-        err_code = drv_sgtl5000_stop();
+        // Keep I2S running if it is capturing
+        err_code = m_capture.running ? NRF_SUCCESS : drv_sgtl5000_stop();
         if (err_code == NRF_SUCCESS)
         {
-            m_running = false;
+            m_running   = false;
+            m_test_tone = false;
             memset(&m_frame_buffer_state, 0, sizeof(m_frame_buffer_state));
         }
     }
@@ -327,17 +1108,19 @@ uint32_t audio_manager_play_sample(void * p_sample, uint32_t len)
         return audio_manager_streaming_begin();
     }
     
+    decode_trigger();
+    
     return NRF_SUCCESS;
 }
 
-uint32_t audio_manager_pkt_process(void * p_pkt, uint32_t len)
+uint32_t audio_manager_pkt_process(void * p_pkt, uint32_t len, uint32_t rx_time)
 {
     uint32_t err_code;
     
     switch (m_audio_codec)
     {
         case AUDIO_CODEC_BV32:
-            err_code = audio_pkt_process_bv32(p_pkt, len);
+            err_code = audio_pkt_process_bv32(p_pkt, len, rx_time);
             break;
         
         default:
@@ -348,6 +1131,98 @@ uint32_t audio_manager_pkt_process(void * p_pkt, uint32_t len)
     return err_code;
 }
 
+uint32_t audio_manager_jb_target_get(void)
+{
+    return m_jb.target;
+}
+
+uint32_t audio_manager_capture_begin(void)
+{
+    uint32_t err_code;
+    bool     i2s_running;
+    
+    if (m_capture.running || m_test_tone || m_audio_codec != AUDIO_CODEC_BV32)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    
+    m_capture.pcm_wr_idx = 0;
+    m_capture.pcm_rd_idx = 0;
+    m_capture.pkt_wr_idx = 0;
+    m_capture.pkt_rd_idx = 0;
+    m_capture.overrun    = false;
+    
+    audio_capture_reset(&m_audio_capture);
+    
+    // Playback may be running I2S already. Once m_capture.running is set, the end of playback no longer stops it.
+    CRITICAL_REGION_ENTER();
+    m_capture.running = true;
+    i2s_running       = m_running;
+    CRITICAL_REGION_EXIT();
+    
+    err_code = NRF_SUCCESS;
+    
+    if (!i2s_running)
+    {
+        err_code = drv_sgtl5000_start();
+        
+        if (err_code != NRF_SUCCESS)
+        {
+            m_capture.running = false;
+        }
+    }
+    
+    return err_code;
+}
+
+uint32_t audio_manager_capture_end(void)
+{
+    if (!m_capture.running)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    
+    // Playback stops I2S when it ends, if it is still running
+    m_capture.running = false;
+    
+    if (!m_running)
+    {
+        return drv_sgtl5000_stop();
+    }
+    
+    return NRF_SUCCESS;
+}
+
+/* Get the oldest encoded frame in place (AUDIO_CAPTURE_PACKED_LEN bytes), or 0 if there is none.
+   The frame stays valid until audio_manager_capture_frame_commit() is called. Frames must be
+   taken from one context at a time (single consumer). */
+uint8_t * audio_manager_capture_frame_peek(void)
+{
+    uint32_t rd_idx = m_capture.pkt_rd_idx;
+    
+    if (m_capture.pkt_wr_idx == rd_idx)
+    {
+        return 0;
+    }
+    
+    // Read the slot only after the index that published it
+    __DMB();
+    
+    return m_capture.pkt[rd_idx & (AUDIO_CAPTURE_PKT_FRAMES - 1)];
+}
+
+void audio_manager_capture_frame_commit(void)
+{
+    // Finish reading the slot before handing it back to the encoder
+    __DMB();
+    m_capture.pkt_rd_idx++;
+}
+
+uint32_t audio_manager_capture_cycles_max_get(void)
+{
+    return m_audio_capture.cycles_max;
+}
+
 uint32_t audio_manager_volume_get(float * p_volume)
 {
     return drv_sgtl5000_volume_get(p_volume);
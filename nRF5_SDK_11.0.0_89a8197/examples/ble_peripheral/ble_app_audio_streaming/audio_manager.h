@@ -8,26 +8,95 @@
 #include "nrf.h"
 #include "nrf_error.h"
 
+// Decode-ahead PCM pipeline
+#define AUDIO_PCM_BUF_FRAMES           4 /* Decoded frames that can be held ahead of I2S (power of two) */
+#define AUDIO_DECODE_AHEAD_DEFAULT     2
+#define AUDIO_PCM_LOW_WATERMARK        0 /* Decode context found no frame decoded ahead: underrun is imminent */
+
+// Adaptive jitter buffer (depths in frames of 10.24 ms)
+#define AUDIO_JB_FLOOR_DEFAULT         3  /* Smallest target depth of the encoded frame FIFO */
+#define AUDIO_JB_CEILING_DEFAULT       50 /* Largest target depth of the encoded frame FIFO */
+#define AUDIO_JB_TARGET_INITIAL        10 /* Target depth before any jitter has been measured */
+#define AUDIO_JB_ADJUST_INTERVAL       20 /* Minimum number of frames between two depth adjustments */
+#define AUDIO_JB_RX_TIME_HZ            32768      /* Rate of the packet receive timestamps (RTC1 ticks) */
+#define AUDIO_JB_RX_TIME_MASK          0x00FFFFFF /* Timestamp counter width */
+
+// Sender clock drift tracking (ASRC ratio steered by the encoded frame FIFO depth)
+#define AUDIO_ASRC_KP                  100  /* Proportional gain (ppm per frame of depth error) */
+#define AUDIO_ASRC_KI                  10   /* Integral gain (ppm per frame of depth error per frame, Q12) */
+#define AUDIO_ASRC_PPM_MAX             1000 /* Largest correction applied */
+#define AUDIO_ASRC_SETTLE_FRAMES       500  /* Frames the integral term holds after the jitter buffer inserts or drops a frame */
+
+// Capture (ADC samples encoded to BV32 frames for the peer)
+#define AUDIO_CAPTURE_BUF_FRAMES       4 /* Captured I2S frames that can wait for the encoder (power of two) */
+#define AUDIO_CAPTURE_PKT_FRAMES       8 /* Encoded frames that can wait to be sent (power of two) */
+
+// Decode interrupt (BV32 decoding and encoding run here, below the I2S interrupt)
+#define AUDIO_DECODE_EGU_INSTANCE      NRF_EGU1
+#define AUDIO_DECODE_EGU_IRQn          SWI1_EGU1_IRQn
+#define AUDIO_DECODE_EGU_IRQHandler    SWI1_EGU1_IRQHandler
+#define AUDIO_DECODE_EGU_IRQPriority   APP_IRQ_PRIORITY_LOWEST
+
 typedef enum
 {
     AUDIO_CODEC_BV32,
     AUDIO_CODEC_INVALID
 } audio_codec_t;
 
+typedef enum
+{
+    AUDIO_CAPTURE_MODE_FULL,     /* Reference BV32 encoder */
+    AUDIO_CAPTURE_MODE_BALANCED, /* Narrower searches, about 0.1 dB lower SNR */
+    AUDIO_CAPTURE_MODE_FAST,     /* Narrowest searches, about 1.5 dB lower SNR */
+} audio_capture_mode_t;
+
+typedef enum
+{
+    AUDIO_EVT_PCM_LOW_WATERMARK,   /* Decoded PCM frames ready for I2S dropped to AUDIO_PCM_LOW_WATERMARK */
+    AUDIO_EVT_PCM_HIGH_WATERMARK,  /* Decoded PCM frames ready for I2S refilled to the decode-ahead depth */
+    AUDIO_EVT_PCM_UNDERRUN,        /* I2S requested a buffer while no decoded frame was ready */
+    AUDIO_EVT_FRAME_CONCEALED,     /* A late or lost frame was replaced by BV32 packet loss concealment */
+    AUDIO_EVT_CAPTURE_FRAME_READY, /* Encoded frames are ready, see audio_manager_capture_frame_peek() */
+    AUDIO_EVT_CAPTURE_OVERRUN,     /* Captured audio was dropped: the encoder or the sender fell behind */
+    AUDIO_EVT_CAPTURE_OVER_BUDGET, /* Encoding a captured frame took more than the cycle budget */
+} audio_evt_type_t;
+
+typedef struct
+{
+    audio_evt_type_t evt;
+    uint32_t         pcm_frames; /* Number of decoded frames ready for I2S */
+    uint32_t         pkt_frames; /* Number of encoded frames waiting to be sent */
+} audio_evt_t;
+
+typedef void (* audio_evt_handler_t)(audio_evt_t const * p_evt);
+
 typedef struct
 {
-    audio_codec_t codec;
+    audio_codec_t        codec;
+    uint32_t             decode_ahead;   /* Frames to decode ahead of I2S (2 to AUDIO_PCM_BUF_FRAMES, 0 for default) */
+    audio_evt_handler_t  evt_handler;    /* Optional, called from the decode interrupt context */
+    uint32_t             jb_floor;       /* Jitter buffer target depth floor (frames, 0 for default) */
+    uint32_t             jb_ceiling;     /* Jitter buffer target depth ceiling (frames, 0 for default) */
+    audio_capture_mode_t capture_mode;   /* BV32 encoder complexity for captured audio */
+    uint32_t             capture_budget; /* Cycles allowed to encode a captured frame (0 for default) */
 } audio_init_t;
 
-uint32_t audio_manager_init(audio_init_t * p_params);
-bool     audio_manager_is_running(void);
-uint32_t audio_manager_streaming_begin(void);
-uint32_t audio_manager_streaming_begin_buffered(uint32_t frame_count);
-uint32_t audio_manager_streaming_end(bool wait_for_fifo);
-uint32_t audio_manager_play_test_tone(void);
-uint32_t audio_manager_play_sample(void * p_sample, uint32_t len);
-uint32_t audio_manager_pkt_process(void * p_pkt, uint32_t len);
-uint32_t audio_manager_volume_get(float * p_volume);
-uint32_t audio_manager_volume_set(float volume);
+uint32_t  audio_manager_init(audio_init_t * p_params);
+bool      audio_manager_is_running(void);
+uint32_t  audio_manager_streaming_begin(void);
+uint32_t  audio_manager_streaming_begin_buffered(uint32_t frame_count);
+uint32_t  audio_manager_streaming_begin_adaptive(void);
+uint32_t  audio_manager_streaming_end(bool wait_for_fifo);
+uint32_t  audio_manager_play_test_tone(void);
+uint32_t  audio_manager_play_sample(void * p_sample, uint32_t len);
+uint32_t  audio_manager_pkt_process(void * p_pkt, uint32_t len, uint32_t rx_time);
+uint32_t  audio_manager_jb_target_get(void);
+uint32_t  audio_manager_capture_begin(void);
+uint32_t  audio_manager_capture_end(void);
+uint8_t * audio_manager_capture_frame_peek(void);
+void      audio_manager_capture_frame_commit(void);
+uint32_t  audio_manager_capture_cycles_max_get(void);
+uint32_t  audio_manager_volume_get(float * p_volume);
+uint32_t  audio_manager_volume_set(float volume);
 
 #endif /* __AUDIO_MANAGER_H__ */
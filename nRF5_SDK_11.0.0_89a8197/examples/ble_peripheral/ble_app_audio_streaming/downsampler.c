@@ -0,0 +1,123 @@
+#include "downsampler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "nrf.h"
+
+#define DOWNSAMPLER_PI   3.14159265358979f
+
+#if defined(__CORTEX_M) && (__CORTEX_M == 0x04)
+#define DOWNSAMPLER_USE_SIMD 1 /* SMLAD: two 16 x 16 multiply-accumulates per instruction */
+#else
+#define DOWNSAMPLER_USE_SIMD 0
+#endif
+
+#if DOWNSAMPLER_USE_SIMD
+static __INLINE uint32_t q15x2_read(int16_t const * p_data)
+{
+    uint32_t pair;
+
+    // Cortex-M4 handles the unaligned word load
+    memcpy(&pair, p_data, sizeof(pair));
+
+    return pair;
+}
+#endif
+
+static __INLINE int16_t q15_sat(int32_t value)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    else if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t) value;
+}
+
+void downsampler_init(downsampler_t * p_downsampler)
+{
+    float   h[DOWNSAMPLER_TAPS];
+    float   center = (DOWNSAMPLER_TAPS - 1) * 0.5f;
+    float   sum = 0.f;
+    int32_t q15_sum = 0;
+    int     j_max = 0;
+
+    // Low-pass: windowed sinc with cut-off at the output Nyquist frequency
+    for (int i = 0; i < DOWNSAMPLER_TAPS; ++i)
+    {
+        float t = ((float) i - center) / DOWNSAMPLER_FACTOR;
+        float w = 0.42f - 0.5f  * cosf(2.f * DOWNSAMPLER_PI * (i + 0.5f) / DOWNSAMPLER_TAPS)
+                        + 0.08f * cosf(4.f * DOWNSAMPLER_PI * (i + 0.5f) / DOWNSAMPLER_TAPS);
+
+        h[i] = (t == 0.f) ? w : w * sinf(DOWNSAMPLER_PI * t) / (DOWNSAMPLER_PI * t);
+        sum += h[i];
+    }
+
+    // Scale to unity DC gain and store time-reversed (newest sample last)
+    for (int j = 0; j < DOWNSAMPLER_TAPS; ++j)
+    {
+        float c = h[DOWNSAMPLER_TAPS - 1 - j] * (32768.f / sum);
+
+        p_downsampler->coeff[j] = q15_sat((int32_t) floorf(c + 0.5f));
+        q15_sum                += p_downsampler->coeff[j];
+
+        if (p_downsampler->coeff[j] > p_downsampler->coeff[j_max])
+        {
+            j_max = j;
+        }
+    }
+
+    // Put the rounding residue on the largest tap, so that DC passes exactly
+    p_downsampler->coeff[j_max] = q15_sat(p_downsampler->coeff[j_max] + (32768 - q15_sum));
+
+    downsampler_reset(p_downsampler);
+}
+
+void downsampler_reset(downsampler_t * p_downsampler)
+{
+    memset(p_downsampler->buf, 0, sizeof(p_downsampler->buf));
+}
+
+void downsampler_process(downsampler_t * p_downsampler, int16_t const * p_in, uint32_t in_len, int16_t * p_out)
+{
+    int16_t const * p_h = p_downsampler->coeff;
+
+    if (in_len > DOWNSAMPLER_MAX_IN_LEN)
+    {
+        in_len = DOWNSAMPLER_MAX_IN_LEN;
+    }
+
+    // Whole output samples only
+    in_len -= in_len % DOWNSAMPLER_FACTOR;
+
+    memcpy(&p_downsampler->buf[DOWNSAMPLER_TAPS - 1], p_in, in_len * sizeof(int16_t));
+
+    for (uint32_t n = DOWNSAMPLER_FACTOR; n <= in_len; n += DOWNSAMPLER_FACTOR)
+    {
+        // Filter ending at the newest of the DOWNSAMPLER_FACTOR samples this output replaces
+        int16_t const * p_x = &p_downsampler->buf[n - 1];
+        int32_t         acc = 1 << 14; // Rounding
+
+#if DOWNSAMPLER_USE_SIMD
+        for (int j = 0; j < DOWNSAMPLER_TAPS; j += 2)
+        {
+            acc = (int32_t) __SMLAD(q15x2_read(&p_x[j]), q15x2_read(&p_h[j]), (uint32_t) acc);
+        }
+#else
+        for (int j = 0; j < DOWNSAMPLER_TAPS; ++j)
+        {
+            acc += (int32_t) p_x[j] * p_h[j];
+        }
+#endif
+
+        *p_out++ = q15_sat(acc >> 15);
+    }
+
+    // Keep the newest samples as history for the next call
+    memmove(p_downsampler->buf, &p_downsampler->buf[in_len], (DOWNSAMPLER_TAPS - 1) * sizeof(int16_t));
+}
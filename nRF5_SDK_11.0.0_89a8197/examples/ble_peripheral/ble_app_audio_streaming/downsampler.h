@@ -0,0 +1,44 @@
+#ifndef __DOWNSAMPLER_H__
+#define __DOWNSAMPLER_H__
+
+#include <stdint.h>
+
+/* Fixed-point FIR decimator.
+ *
+ * The low-pass filter is DOWNSAMPLER_TAPS taps long (Blackman-windowed sinc, cut-off at the
+ * output Nyquist frequency) and is computed in Q15 coefficients when initialized. Only every
+ * DOWNSAMPLER_FACTOR-th output sample is computed, each from the last DOWNSAMPLER_TAPS input
+ * samples, two taps at a time with packed 16-bit multiply-accumulate on Cortex-M4.
+ */
+
+#ifndef DOWNSAMPLER_FACTOR
+#define DOWNSAMPLER_FACTOR       4
+#endif
+
+#ifndef DOWNSAMPLER_TAPS
+#define DOWNSAMPLER_TAPS         96  /* Must be even */
+#endif
+
+#ifndef DOWNSAMPLER_MAX_IN_LEN
+#define DOWNSAMPLER_MAX_IN_LEN   320 /* Largest number of input samples per call (one I2S frame) */
+#endif
+
+#if (DOWNSAMPLER_TAPS & 1) != 0
+#error DOWNSAMPLER_TAPS must be even
+#endif
+
+#if (DOWNSAMPLER_MAX_IN_LEN % DOWNSAMPLER_FACTOR) != 0
+#error DOWNSAMPLER_MAX_IN_LEN must be a multiple of DOWNSAMPLER_FACTOR
+#endif
+
+typedef struct
+{
+    int16_t coeff[DOWNSAMPLER_TAPS];                                /* Time-reversed filter, Q15 */
+    int16_t buf[DOWNSAMPLER_TAPS - 1 + DOWNSAMPLER_MAX_IN_LEN];     /* Input history followed by new input */
+} downsampler_t;
+
+void downsampler_init(downsampler_t * p_downsampler);
+void downsampler_reset(downsampler_t * p_downsampler);
+void downsampler_process(downsampler_t * p_downsampler, int16_t const * p_in, uint32_t in_len, int16_t * p_out);
+
+#endif /* __DOWNSAMPLER_H__ */
@@ -28,6 +28,7 @@ static struct
 {
     uint32_t * i2s_tx_buffer;     
     uint32_t   i2s_tx_buffer_len; 
+    uint32_t * i2s_rx_buffer;
 } m_i2s_configuration;
 
 static volatile enum
@@ -90,6 +91,23 @@ static void i2s_data_handler(uint32_t const * p_data_received, uint32_t * p_data
         return;
     }
     
+    if (p_data_received != NULL)
+    {
+        bool continue_running;
+        
+        // I2S data received from the ADC
+        evt.evt                                   = DRV_SGTL5000_EVT_I2S_RX_BUF_RECEIVED;
+        evt.param.rx_buf_received.number_of_words = number_of_words;
+        evt.param.rx_buf_received.p_data_received = p_data_received;
+        
+        continue_running = m_evt_handler(&evt);
+        
+        if (!continue_running)
+        {
+            DRV_SGTL5000_EGU_INSTANCE->TASKS_TRIGGER[SGTL5000_EGU_TASK_STREAMING_STOP] = 1;
+        }
+    }
+    
     if (p_data_to_send != NULL)
     {
         bool continue_running;
@@ -314,6 +332,7 @@ uint32_t drv_sgtl5000_init(drv_sgtl5000_init_t * p_params)
     m_evt_handler                         = p_params->evt_handler;
     m_i2s_configuration.i2s_tx_buffer     = p_params->i2s_tx_buffer;
     m_i2s_configuration.i2s_tx_buffer_len = p_params->i2s_tx_buffer_len;
+    m_i2s_configuration.i2s_rx_buffer     = p_params->i2s_rx_buffer;
     
     // Initialize TWI interface 
     nrf_drv_twi_config_t twi_config = {
@@ -484,7 +503,8 @@ uint32_t drv_sgtl5000_start(void)
     {
         m_state = SGTL5000_STATE_RUNNING;
         
-        nrf_drv_i2s_start(0, m_i2s_configuration.i2s_tx_buffer, (m_i2s_configuration.i2s_tx_buffer_len / sizeof(uint32_t)), 0);
+        // Receive ADC samples alongside, if a RX buffer was given
+        nrf_drv_i2s_start(m_i2s_configuration.i2s_rx_buffer, m_i2s_configuration.i2s_tx_buffer, (m_i2s_configuration.i2s_tx_buffer_len / sizeof(uint32_t)), 0);
         
         return NRF_SUCCESS;
     }
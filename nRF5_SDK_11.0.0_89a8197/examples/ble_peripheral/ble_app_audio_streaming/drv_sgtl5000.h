@@ -31,7 +31,7 @@
 #define DRV_SGTL5000_TWI_PIN_SDA   26
 
 // I2S Settings
-#define DRV_SGTL5000_I2S_IRQPriority  DRV_SGTL5000_EGU_IRQPriority
+#define DRV_SGTL5000_I2S_IRQPriority  APP_IRQ_PRIORITY_LOW /* Above the audio_manager decode interrupt */
 
 // I2S pin mapping
 #define DRV_SGTL5000_I2S_PIN_MCLK  23
@@ -61,7 +61,8 @@
 
 typedef enum
 {
-    DRV_SGTL5000_EVT_I2S_TX_BUF_REQ, /* Request for I2S TX buffer */
+    DRV_SGTL5000_EVT_I2S_TX_BUF_REQ,      /* Request for I2S TX buffer */
+    DRV_SGTL5000_EVT_I2S_RX_BUF_RECEIVED, /* I2S RX buffer filled with ADC samples */
 } drv_sgtl5000_evt_type_t;
 
 typedef enum
@@ -79,6 +80,11 @@ typedef struct
             uint32_t * p_data_to_send;  /* Pointer to buffer that should be filled  */
             uint16_t   number_of_words; /* Buffer size in number of Words (32 bits) */
         } tx_buf_req;
+        struct
+        {
+            uint32_t const * p_data_received; /* Pointer to received buffer, valid until the handler returns */
+            uint16_t         number_of_words; /* Buffer size in number of Words (32 bits) */
+        } rx_buf_received;
     } param;
 } drv_sgtl5000_evt_t;
 
@@ -90,6 +96,7 @@ typedef struct
     drv_sgtl5000_sample_freq_t fs;
     void *                     i2s_tx_buffer;     /* Pointer to I2S TX double-buffer (should be 2 x uncompressed frame size) */
     uint32_t                   i2s_tx_buffer_len; /* Size of buffer (in bytes) */ 
+    void *                     i2s_rx_buffer;     /* Optional pointer to I2S RX double-buffer (same size as TX), 0 for playback only */
 } drv_sgtl5000_init_t;
 
 uint32_t drv_sgtl5000_init(drv_sgtl5000_init_t * p_params);
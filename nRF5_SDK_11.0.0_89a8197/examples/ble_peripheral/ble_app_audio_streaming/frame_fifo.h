@@ -0,0 +1,113 @@
+#ifndef __frame_fifo_h__
+#define __frame_fifo_h__
+
+/* Lock-free single-producer/single-consumer queue of fixed size frames.
+ *
+ * The producer (frame_fifo_put) and the consumer (frame_fifo_peek/frame_fifo_commit)
+ * may run in different interrupt priorities without a critical region, as long as
+ * there is only one of each. The indices are free-running and each is written by
+ * one side only; a memory barrier orders the slot contents against the index update
+ * (release) and the index read against the slot access (acquire).
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef FRAME_FIFO_SLOTS
+#define FRAME_FIFO_SLOTS     256 /* Number of frames, must be a power of two */
+#endif
+
+#ifndef FRAME_FIFO_SLOT_SIZE
+#define FRAME_FIFO_SLOT_SIZE 20  /* BV32 packed frame size (in bytes) */
+#endif
+
+#ifndef FRAME_FIFO_MEMORY_BARRIER
+#include "nrf.h"
+#define FRAME_FIFO_MEMORY_BARRIER() __DMB()
+#endif
+
+#if (FRAME_FIFO_SLOTS & (FRAME_FIFO_SLOTS - 1)) != 0
+#error FRAME_FIFO_SLOTS must be a power of two
+#endif
+
+typedef struct
+{
+    uint8_t           buf[FRAME_FIFO_SLOTS][FRAME_FIFO_SLOT_SIZE];
+    volatile uint32_t wr_idx; /* Written by producer only */
+    volatile uint32_t rd_idx; /* Written by consumer only */
+} frame_fifo_t;
+
+static inline void frame_fifo_init(frame_fifo_t * p_fifo)
+{
+    p_fifo->wr_idx = 0;
+    p_fifo->rd_idx = 0;
+}
+
+static inline uint32_t frame_fifo_num_elem_get(frame_fifo_t * p_fifo)
+{
+    return (p_fifo->wr_idx - p_fifo->rd_idx);
+}
+
+/* Producer: copy one frame into the next free slot. Returns false if the queue is full. */
+static inline bool frame_fifo_put(frame_fifo_t * p_fifo, uint8_t const * p_frame)
+{
+    uint32_t wr_idx = p_fifo->wr_idx;
+
+    if ((wr_idx - p_fifo->rd_idx) == FRAME_FIFO_SLOTS)
+    {
+        return false;
+    }
+
+    // Acquire: the consumer must be done with the slot before it is overwritten
+    FRAME_FIFO_MEMORY_BARRIER();
+
+    memcpy(p_fifo->buf[wr_idx & (FRAME_FIFO_SLOTS - 1)], p_frame, FRAME_FIFO_SLOT_SIZE);
+
+    // Release: publish the slot contents before the index
+    FRAME_FIFO_MEMORY_BARRIER();
+    p_fifo->wr_idx = wr_idx + 1;
+
+    return true;
+}
+
+/* Consumer: get the oldest frame in place, or 0 if the queue is empty.
+   The slot stays valid until frame_fifo_commit() is called. */
+static inline uint8_t * frame_fifo_peek(frame_fifo_t * p_fifo)
+{
+    uint32_t rd_idx = p_fifo->rd_idx;
+
+    if (p_fifo->wr_idx == rd_idx)
+    {
+        return 0;
+    }
+
+    // Acquire: read the slot only after the index that published it
+    FRAME_FIFO_MEMORY_BARRIER();
+
+    return p_fifo->buf[rd_idx & (FRAME_FIFO_SLOTS - 1)];
+}
+
+/* Consumer: number of frames, from the oldest one, that lie in consecutive slots before the
+   ring wraps. frame_fifo_peek() returns the first of them; they stay valid until committed. */
+static inline uint32_t frame_fifo_contiguous_get(frame_fifo_t * p_fifo)
+{
+    uint32_t rd_idx = p_fifo->rd_idx;
+    uint32_t count  = p_fifo->wr_idx - rd_idx;
+    uint32_t to_end = FRAME_FIFO_SLOTS - (rd_idx & (FRAME_FIFO_SLOTS - 1));
+
+    // Acquire: read the slots only after the index that published them
+    FRAME_FIFO_MEMORY_BARRIER();
+
+    return (count < to_end) ? count : to_end;
+}
+
+/* Consumer: release the frame returned by frame_fifo_peek() */
+static inline void frame_fifo_commit(frame_fifo_t * p_fifo)
+{
+    // Release: finish reading the slot before handing it back to the producer
+    FRAME_FIFO_MEMORY_BARRIER();
+    p_fifo->rd_idx = p_fifo->rd_idx + 1;
+}
+
+#endif /* __frame_fifo_h__ */
@@ -0,0 +1,17 @@
+#ifndef __APP_UTIL_PLATFORM_H__
+#define __APP_UTIL_PLATFORM_H__
+
+#include <assert.h>
+
+/* Host stand-in: the simulation runs every context to completion, so critical regions are empty */
+
+#define APP_IRQ_PRIORITY_HIGH   2
+#define APP_IRQ_PRIORITY_LOW    6
+#define APP_IRQ_PRIORITY_LOWEST 7
+
+#define CRITICAL_REGION_ENTER()
+#define CRITICAL_REGION_EXIT()
+
+#define APP_ERROR_CHECK_BOOL(cond) assert(cond)
+
+#endif /* __APP_UTIL_PLATFORM_H__ */
@@ -0,0 +1,804 @@
+/* Host simulation of the playback pipeline (audio_manager.c).
+ *
+ * Streams a packed BV32 file (20-byte frames, as bv32_to_c.py takes them) through the audio
+ * manager, with the SGTL5000 driver, the decode interrupt and the BLE link replaced by a
+ * discrete-event model in simulated time:
+ *  - I2S asks for a buffer every AUDIO_PCM_FRAME_LEN / 31250 Hz = 10.24 ms, from the I2S interrupt.
+ *  - The decode interrupt (EGU) runs when it is triggered and enabled, below I2S. Frames are
+ *    decoded for real, but I2S only sees a frame once the modelled decode time (-d, plus a spike
+ *    of -s every -n frames) has passed since the previous one.
+ *  - The sender produces one frame every 10.24 ms. Each packet arrives when it is produced, at
+ *    the time a recorded arrival trace gives (-t), or at the next BLE connection event every -i ms,
+ *    of which -r percent are missed and retried at the next one. -l sets the number of frames
+ *    sent then, the file is sent over again as needed. Then the stream ends. A trace is
+ *    a text file with the arrival time of each packet in ms, one per line ('#' starts a comment,
+ *    'x' marks a packet that never arrives), and the file is sent over again if the trace is longer.
+ *  - Packets are lost at random (-p percent), or in bursts (-g p,r: Gilbert model, a packet is lost
+ *    after a received one with p percent probability and received after a lost one with r percent).
+ *    Packets carry no sequence number, so a loss is not seen as such: the next frame is played in
+ *    its place, the jitter buffer is one frame shorter, and frames are concealed once it runs dry.
+ *    With -S the file is played from memory with audio_manager_play_sample() instead.
+ *  - The sender clock runs -c ppm fast (negative: slow) against the I2S clock. The ASRC control
+ *    loop in audio_manager.c has to track it, at a FIFO depth it keeps near the jitter buffer
+ *    target. Run a few hours of frames (-l 1000000 is 2.8 hours) to see it settle. Add -p or -g
+ *    to check that lost packets, which the jitter buffer makes up for, do not wind up the loop.
+ *  - The jitter buffer adapts between the -j floor and ceiling, or pre-buffers -b frames and
+ *    holds that depth.
+ *
+ * Prints the I2S requests served, the underruns (a request found no decoded frame while the
+ * stream was playing), the concealed frames and the smallest decode-ahead margin seen by I2S.
+ * It also prints the latency from the sender to I2S, beyond the shortest transport delay of the
+ * run, against the frames concealed because they were late or lost: the jitter buffer trade-off.
+ * The glitches are the audible events: each run of concealed frames and each run of I2S buffers
+ * left silent.
+ * Over the second half of the run it prints the ASRC ratio the control loop settled at and the
+ * range of FIFO depths, and how long the ratio sat at the clamp. With -o the I2S output is written
+ * out as 16-bit PCM at 31250 Hz.
+ *
+ * usage: audio_sim [-a depth] [-d us] [-s us] [-n frames] [-t trace | [-i ms] [-r percent] [-l frames]]
+ *                  [-p percent | -g p,r] [-c ppm] [-j floor,ceiling | -b frames] [-S] [-o out.raw] file.bv32
+ *
+ * Exits with status 1 if I2S ran dry while the stream was playing, did not stop after it, or if
+ * frames dropped on a full FIFO were not all concealed. With -c, also if the FIFO ran over, ran
+ * dry without packet loss, or if the ASRC ratio reached the clamp while the drift was within it:
+ * the control loop did not follow the drift.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_manager.c"
+
+#define SIM_NS_PER_S        1000000000ULL
+#define SIM_I2S_PERIOD_NS   ((SIM_NS_PER_S * AUDIO_PCM_FRAME_LEN) / AUDIO_I2S_FS) /* 10.24 ms */
+#define SIM_PKT_PERIOD_NS   SIM_I2S_PERIOD_NS                                     /* Sender frame period */
+#define SIM_DRAIN_NS        (10 * SIM_NS_PER_S)                                  /* I2S must stop this soon after the stream ends */
+#define SIM_TIME_NEVER      UINT64_MAX
+
+NRF_EGU_Type host_egu[6];
+
+static struct
+{
+    drv_sgtl5000_handler_t handler;
+    uint32_t *             p_tx_buffer;
+    uint32_t               half;     /* Half of the double buffer requested next */
+    bool                   running;
+    uint64_t               next_req; /* Time of the next buffer request */
+} m_i2s;
+
+static struct
+{
+    uint64_t  now;             /* Simulated time (ns) */
+    uint64_t  decode_ns;       /* Decode interrupt time per frame */
+    uint64_t  spike_ns;        /* Extra decode time of every spike_interval-th frame */
+    uint32_t  spike_interval;
+    uint32_t  decoded;         /* Frames published by the decode interrupt */
+    uint32_t  pending;         /* Frames decoded but not published yet: the interrupt is still running */
+    uint64_t  next_publish;
+    uint8_t * p_stream;        /* Packed frames sent over the link */
+    uint32_t  stream_len;
+    uint64_t * p_arrival;      /* Arrival time of each packet, SIM_TIME_NEVER if it is lost */
+    uint32_t  pkts;
+    uint32_t  pkt_idx;         /* Next packet to send */
+    uint32_t  pkts_lost;       /* Packets lost so far */
+    uint64_t  next_pkt;
+    int64_t   t_sent;          /* Time the first frame was produced, at the shortest transport delay */
+    int32_t   drift_ppm;       /* Sender clock offset */
+    double    pkt_period_ns;   /* Sender frame period, in I2S clock time */
+    uint32_t  prebuffer;       /* Fixed pre-buffer depth, 0 for the adaptive jitter buffer */
+    uint64_t  end;             /* Time limit once everything has been sent */
+    FILE *    fp_out;
+} m_sim;
+
+static struct
+{
+    uint32_t i2s_reqs;
+    uint32_t played;
+    uint32_t underruns;
+    uint32_t concealed;
+    uint32_t fifo_full;
+    uint32_t low_watermarks;
+    uint32_t margin_min;       /* Smallest number of decoded frames ready at an I2S request */
+    uint32_t late;             /* Frames concealed because they had not arrived */
+    uint32_t gap_concealed;    /* m_gap.concealed at the previous concealed frame */
+    uint32_t concealed_idx;    /* Index of the previous concealed frame in the PCM buffer, plus one */
+    uint32_t glitches;         /* Runs of concealed frames and runs of silent I2S buffers */
+    bool     silent;           /* The previous I2S buffer was left silent */
+    double   latency_sum;      /* Sender to I2S latency at each I2S request (frames) */
+    uint32_t latency_count;
+    int32_t  latency_max;
+    bool     stuck;            /* I2S was still running SIM_DRAIN_NS after the end of the stream */
+    double   ppm_sum;          /* ASRC ratio offset at each I2S request over the second half of the stream */
+    uint32_t ppm_count;
+    int32_t  ppm_min;
+    int32_t  ppm_max;
+    uint32_t ppm_clamped;      /* I2S requests over the second half with the ASRC ratio at +-AUDIO_ASRC_PPM_MAX */
+    uint32_t depth_min;        /* FIFO depth at each I2S request over the second half of the stream */
+    uint32_t depth_max;
+} m_stats;
+
+uint32_t host_cycles(void)
+{
+    return 0;
+}
+
+uint32_t drv_sgtl5000_init(drv_sgtl5000_init_t * p_params)
+{
+    m_i2s.handler     = p_params->evt_handler;
+    m_i2s.p_tx_buffer = p_params->i2s_tx_buffer;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t drv_sgtl5000_start(void)
+{
+    // The driver asks for the first buffer right away
+    m_i2s.running  = true;
+    m_i2s.half     = 0;
+    m_i2s.next_req = m_sim.now;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t drv_sgtl5000_start_1khz_test_tone(void)
+{
+    return NRF_ERROR_INVALID_STATE;
+}
+
+uint32_t drv_sgtl5000_stop(void)
+{
+    m_i2s.running = false;
+
+    return NRF_SUCCESS;
+}
+
+uint32_t drv_sgtl5000_volume_set(float volume_db)
+{
+    return NRF_SUCCESS;
+}
+
+uint32_t drv_sgtl5000_volume_get(float * p_volume_db)
+{
+    *p_volume_db = 0.f;
+
+    return NRF_SUCCESS;
+}
+
+static void sim_evt_handler(audio_evt_t const * p_evt)
+{
+    switch (p_evt->evt)
+    {
+        case AUDIO_EVT_FRAME_CONCEALED:
+            m_stats.concealed++;
+
+            // Frames lost on a full FIFO are counted in m_gap, the others had not arrived
+            if (m_gap.concealed == m_stats.gap_concealed)
+            {
+                m_stats.late++;
+            }
+
+            m_stats.gap_concealed = m_gap.concealed;
+
+            // Consecutive concealed frames are heard as one glitch
+            if (m_stats.concealed_idx != m_pcm.wr_idx)
+            {
+                m_stats.glitches++;
+            }
+
+            m_stats.concealed_idx = m_pcm.wr_idx + 1;
+            break;
+
+        case AUDIO_EVT_PCM_LOW_WATERMARK:
+            m_stats.low_watermarks++;
+            break;
+
+        default:
+            break;
+    }
+}
+
+static uint64_t decode_time_get(void)
+{
+    if (m_sim.spike_interval != 0 && (m_sim.decoded % m_sim.spike_interval) == (m_sim.spike_interval - 1))
+    {
+        return m_sim.decode_ns + m_sim.spike_ns;
+    }
+
+    return m_sim.decode_ns;
+}
+
+/* Run the decode interrupt if it was triggered, is enabled and is not running already */
+static void egu_run(void)
+{
+    NRF_EGU_Type * p_egu = AUDIO_DECODE_EGU_INSTANCE;
+    bool           pending = false;
+    uint32_t       wr_idx;
+
+    for (int i = 0; i < 16; ++i)
+    {
+        if (p_egu->TASKS_TRIGGER[i] != 0)
+        {
+            p_egu->TASKS_TRIGGER[i]    = 0;
+            p_egu->EVENTS_TRIGGERED[i] = 1;
+        }
+
+        if (p_egu->EVENTS_TRIGGERED[i] != 0 && (p_egu->INTENSET & (1UL << i)) != 0)
+        {
+            pending = true;
+        }
+    }
+
+    if (!pending || m_sim.pending != 0)
+    {
+        return;
+    }
+
+    // Decode for real, then hold the frames back until their decode time has passed
+    wr_idx = m_pcm.wr_idx;
+    AUDIO_DECODE_EGU_IRQHandler();
+
+    m_sim.pending = m_pcm.wr_idx - wr_idx;
+    m_pcm.wr_idx  = wr_idx;
+
+    if (m_sim.pending != 0)
+    {
+        m_sim.next_publish = m_sim.now + decode_time_get();
+    }
+}
+
+static void pcm_publish(void)
+{
+    m_pcm.wr_idx++;
+    m_sim.decoded++;
+
+    if (--m_sim.pending != 0)
+    {
+        m_sim.next_publish += decode_time_get();
+    }
+}
+
+static void i2s_request(void)
+{
+    drv_sgtl5000_evt_t evt;
+    uint32_t *         p_buf  = m_i2s.p_tx_buffer + m_i2s.half * (AUDIO_PCM_FRAME_LEN / 2);
+    uint32_t           ready  = pcm_frames_ready();
+    bool               expect = m_running && !m_frame_buffer_state.buffering && !m_pcm.draining && !m_sample_info.valid;
+
+    m_stats.i2s_reqs++;
+
+    if (ready != 0)
+    {
+        m_stats.played++;
+    }
+    else if (expect && m_stats.played != 0)
+    {
+        m_stats.underruns++;
+
+        if (!m_stats.silent)
+        {
+            m_stats.glitches++;
+        }
+    }
+
+    m_stats.silent = (ready == 0);
+
+    if (expect && m_stats.played != 0 && ready < m_stats.margin_min)
+    {
+        m_stats.margin_min = ready;
+    }
+
+    if (expect && m_stats.played != 0)
+    {
+        // Frames produced by the sender that have not been played yet: the ones not decoded
+        // (frames lost on a full FIFO count as decoded once concealed, lost packets once
+        // they are passed) and the ones decoded ahead
+        int64_t  sent    = (int64_t)(((int64_t) m_sim.now - m_sim.t_sent) / m_sim.pkt_period_ns) + 1;
+        int32_t  latency;
+
+        if (sent > m_sim.pkts)
+        {
+            sent = m_sim.pkts;
+        }
+
+        latency = (int32_t)(sent - (m_fifo_encoded_audio.rd_idx + m_gap.concealed + m_sim.pkts_lost)) + (int32_t) ready;
+
+        m_stats.latency_sum += latency;
+        m_stats.latency_count++;
+
+        if (latency > m_stats.latency_max)
+        {
+            m_stats.latency_max = latency;
+        }
+
+        if (sent > m_sim.pkts / 2 && sent < m_sim.pkts)
+        {
+            uint32_t depth = frame_fifo_num_elem_get(&m_fifo_encoded_audio);
+
+            m_stats.ppm_sum += m_asrc_ctrl.ppm;
+            m_stats.ppm_count++;
+            m_stats.ppm_clamped += (m_asrc_ctrl.ppm == AUDIO_ASRC_PPM_MAX || m_asrc_ctrl.ppm == -AUDIO_ASRC_PPM_MAX);
+            m_stats.ppm_min   = (m_stats.ppm_count == 1 || m_asrc_ctrl.ppm < m_stats.ppm_min) ? m_asrc_ctrl.ppm : m_stats.ppm_min;
+            m_stats.ppm_max   = (m_stats.ppm_count == 1 || m_asrc_ctrl.ppm > m_stats.ppm_max) ? m_asrc_ctrl.ppm : m_stats.ppm_max;
+            m_stats.depth_min = (m_stats.ppm_count == 1 || depth < m_stats.depth_min) ? depth : m_stats.depth_min;
+            m_stats.depth_max = (m_stats.ppm_count == 1 || depth > m_stats.depth_max) ? depth : m_stats.depth_max;
+        }
+    }
+
+    evt.evt                             = DRV_SGTL5000_EVT_I2S_TX_BUF_REQ;
+    evt.param.tx_buf_req.p_data_to_send  = p_buf;
+    evt.param.tx_buf_req.number_of_words = AUDIO_PCM_FRAME_LEN / 2;
+
+    if (!m_i2s.handler(&evt))
+    {
+        m_i2s.running = false;
+    }
+
+    if (m_sim.fp_out != NULL)
+    {
+        fwrite(p_buf, sizeof(int16_t), AUDIO_PCM_FRAME_LEN, m_sim.fp_out);
+    }
+
+    m_i2s.half     ^= 1;
+    m_i2s.next_req += SIM_I2S_PERIOD_NS;
+}
+
+/* Time the sender produces packet k */
+static uint64_t pkt_sent_time(uint32_t k)
+{
+    return (uint64_t)(k * m_sim.pkt_period_ns + 0.5);
+}
+
+/* Skips the lost packets. The end of stream follows the last packet one frame period later. */
+static void pkt_next(void)
+{
+    while (m_sim.pkt_idx < m_sim.pkts && m_sim.p_arrival[m_sim.pkt_idx] == SIM_TIME_NEVER)
+    {
+        m_sim.pkt_idx++;
+        m_sim.pkts_lost++;
+    }
+
+    m_sim.next_pkt = (m_sim.pkt_idx < m_sim.pkts) ? m_sim.p_arrival[m_sim.pkt_idx] : m_sim.now + (uint64_t) m_sim.pkt_period_ns;
+}
+
+/* Packet received over NUS, handled as main.c nus_data_handler() does */
+static void pkt_receive(void)
+{
+    uint32_t rx_time = (uint32_t)((m_sim.now * AUDIO_JB_RX_TIME_HZ) / SIM_NS_PER_S) & AUDIO_JB_RX_TIME_MASK;
+    uint32_t offset  = (m_sim.pkt_idx * FRAME_FIFO_SLOT_SIZE) % m_sim.stream_len;
+
+    if (m_sim.pkt_idx++ == m_sim.pkts)
+    {
+        // Anything but a 20-byte packet ends the stream
+        audio_manager_streaming_end(true);
+        m_sim.next_pkt = SIM_TIME_NEVER;
+        m_sim.end      = m_sim.now + SIM_DRAIN_NS;
+        return;
+    }
+
+    pkt_next();
+
+    if (!audio_manager_is_running())
+    {
+        if (m_sim.prebuffer != 0)
+        {
+            audio_manager_streaming_begin_buffered(m_sim.prebuffer);
+        }
+        else
+        {
+            audio_manager_streaming_begin_adaptive();
+        }
+    }
+
+    if (audio_manager_pkt_process(&m_sim.p_stream[offset], FRAME_FIFO_SLOT_SIZE, rx_time) == NRF_ERROR_NO_MEM)
+    {
+        m_stats.fifo_full++;
+    }
+}
+
+static bool arrivals_read(char const * p_name)
+{
+    FILE *   fp = fopen(p_name, "r");
+    char     line[128];
+    uint32_t size = 0;
+    double   t0   = -1.0;
+
+    if (fp == NULL)
+    {
+        return false;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        char * p_end;
+        bool   lost = (line[0] == 'x');
+        double t    = strtod(line, &p_end);
+
+        if (!lost && p_end == line)
+        {
+            // Comment or blank line
+            continue;
+        }
+
+        if (m_sim.pkts == size)
+        {
+            size              = size ? size * 2 : 1024;
+            m_sim.p_arrival   = realloc(m_sim.p_arrival, size * sizeof(uint64_t));
+        }
+
+        if (lost)
+        {
+            m_sim.p_arrival[m_sim.pkts++] = SIM_TIME_NEVER;
+            continue;
+        }
+
+        if (t0 < 0.0)
+        {
+            t0 = t;
+        }
+
+        m_sim.p_arrival[m_sim.pkts++] = (uint64_t)((t - t0) * 1e6);
+    }
+
+    fclose(fp);
+
+    return m_sim.pkts != 0;
+}
+
+/* Packets wait for the next connection event, which is missed with the given probability.
+   With no interval, each packet arrives as it is produced. */
+static void arrivals_ble(uint32_t frames, uint64_t interval_ns, uint32_t miss_percent)
+{
+    uint64_t event = 0;
+
+    m_sim.pkts      = frames;
+    m_sim.p_arrival = malloc(frames * sizeof(uint64_t));
+
+    for (uint32_t k = 0; k < frames; ++k)
+    {
+        uint64_t sent = pkt_sent_time(k);
+
+        if (interval_ns == 0)
+        {
+            m_sim.p_arrival[k] = sent;
+            continue;
+        }
+
+        // Packets produced before a missed event go with the next one that gets through
+        if (event < sent)
+        {
+            event += ((sent - event + interval_ns - 1) / interval_ns) * interval_ns;
+
+            while ((uint32_t)(rand() % 100) < miss_percent)
+            {
+                event += interval_ns;
+            }
+        }
+
+        m_sim.p_arrival[k] = event;
+    }
+}
+
+/* Gilbert model: a packet is lost after a received one with probability p, and received after
+   a lost one with probability r. With r = 100 - p the losses are independent. */
+static void arrivals_lose(uint32_t p_percent, uint32_t r_percent)
+{
+    bool lost = false;
+
+    for (uint32_t k = 0; k < m_sim.pkts; ++k)
+    {
+        lost = (uint32_t)(rand() % 100) < (lost ? 100 - r_percent : p_percent);
+
+        if (lost)
+        {
+            m_sim.p_arrival[k] = SIM_TIME_NEVER;
+        }
+    }
+}
+
+static void arrivals_prepare(void)
+{
+    int64_t  t_sent = INT64_MAX;
+    uint64_t last   = 0;
+
+    for (uint32_t k = 0; k < m_sim.pkts; ++k)
+    {
+        if (m_sim.p_arrival[k] == SIM_TIME_NEVER)
+        {
+            continue;
+        }
+
+        // The link delivers in order
+        if (m_sim.p_arrival[k] < last)
+        {
+            m_sim.p_arrival[k] = last;
+        }
+
+        last = m_sim.p_arrival[k];
+
+        if ((int64_t) m_sim.p_arrival[k] - (int64_t) pkt_sent_time(k) < t_sent)
+        {
+            t_sent = (int64_t) m_sim.p_arrival[k] - (int64_t) pkt_sent_time(k);
+        }
+    }
+
+    m_sim.t_sent = (t_sent != INT64_MAX) ? t_sent : 0;
+    pkt_next();
+}
+
+static void sim_run(void)
+{
+    for (;;)
+    {
+        uint64_t t_i2s = m_i2s.running ? m_i2s.next_req : SIM_TIME_NEVER;
+        uint64_t t_pub = (m_sim.pending != 0) ? m_sim.next_publish : SIM_TIME_NEVER;
+        uint64_t t_pkt = m_sim.next_pkt;
+
+        if (t_i2s == SIM_TIME_NEVER && t_pub == SIM_TIME_NEVER && t_pkt == SIM_TIME_NEVER)
+        {
+            break;
+        }
+
+        if (t_pkt == SIM_TIME_NEVER && m_sim.now >= m_sim.end)
+        {
+            m_stats.stuck = true;
+            break;
+        }
+
+        // A frame finished at the time of a request is in time for it
+        if (t_pub <= t_i2s && t_pub <= t_pkt)
+        {
+            m_sim.now = t_pub;
+            pcm_publish();
+        }
+        else if (t_i2s <= t_pkt)
+        {
+            m_sim.now = t_i2s;
+            i2s_request();
+        }
+        else
+        {
+            m_sim.now = t_pkt;
+            pkt_receive();
+        }
+
+        egu_run();
+    }
+}
+
+int main(int argc, char ** argv)
+{
+    audio_init_t params = {0};
+    bool         sample = false;
+    bool         drift_failed;
+    char const * p_trace = NULL;
+    uint64_t     interval_ns = 0;
+    uint32_t     miss_percent = 0;
+    uint32_t     loss_p = 0;
+    uint32_t     loss_r = 100;
+    uint32_t     frames = 0;
+    FILE *       fp;
+    long         len;
+    int          i;
+
+    params.codec       = AUDIO_CODEC_BV32;
+    params.evt_handler = sim_evt_handler;
+
+    m_sim.decode_ns      = 2000000;
+    m_sim.spike_interval = 50;
+
+    for (i = 1; i < argc - 1 && argv[i][0] == '-'; i += 2)
+    {
+        if (strcmp(argv[i], "-S") == 0)
+        {
+            // No value: step back so that the loop moves on by one
+            sample = true;
+            i--;
+        }
+        else if (strcmp(argv[i], "-a") == 0)
+        {
+            params.decode_ahead = (uint32_t) strtoul(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-d") == 0)
+        {
+            m_sim.decode_ns = strtoull(argv[i + 1], NULL, 0) * 1000;
+        }
+        else if (strcmp(argv[i], "-s") == 0)
+        {
+            m_sim.spike_ns = strtoull(argv[i + 1], NULL, 0) * 1000;
+        }
+        else if (strcmp(argv[i], "-n") == 0)
+        {
+            m_sim.spike_interval = (uint32_t) strtoul(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-t") == 0)
+        {
+            p_trace = argv[i + 1];
+        }
+        else if (strcmp(argv[i], "-i") == 0)
+        {
+            interval_ns = (uint64_t)(strtod(argv[i + 1], NULL) * 1e6);
+        }
+        else if (strcmp(argv[i], "-r") == 0)
+        {
+            miss_percent = (uint32_t) strtoul(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-l") == 0)
+        {
+            frames = (uint32_t) strtoul(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-p") == 0)
+        {
+            loss_p = (uint32_t) strtoul(argv[i + 1], NULL, 0);
+            loss_r = 100 - loss_p;
+        }
+        else if (strcmp(argv[i], "-g") == 0)
+        {
+            char * p_end;
+
+            loss_p = (uint32_t) strtoul(argv[i + 1], &p_end, 0);
+            loss_r = (*p_end == ',') ? (uint32_t) strtoul(p_end + 1, NULL, 0) : 100 - loss_p;
+        }
+        else if (strcmp(argv[i], "-c") == 0)
+        {
+            m_sim.drift_ppm = (int32_t) strtol(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-j") == 0)
+        {
+            char * p_end;
+
+            params.jb_floor   = (uint32_t) strtoul(argv[i + 1], &p_end, 0);
+            params.jb_ceiling = (*p_end == ',') ? (uint32_t) strtoul(p_end + 1, NULL, 0) : 0;
+        }
+        else if (strcmp(argv[i], "-b") == 0)
+        {
+            m_sim.prebuffer = (uint32_t) strtoul(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-o") == 0)
+        {
+            m_sim.fp_out = fopen(argv[i + 1], "wb");
+            if (m_sim.fp_out == NULL)
+            {
+                fprintf(stderr, "%s: cannot create\n", argv[i + 1]);
+                return 2;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (i != argc - 1)
+    {
+        fprintf(stderr, "usage: %s [-a depth] [-d us] [-s us] [-n frames] [-t trace | [-i ms] [-r percent] [-l frames]]\n"
+                        "       [-p percent | -g p,r] [-c ppm] [-j floor,ceiling | -b frames] [-S] [-o out.raw] file.bv32\n", argv[0]);
+        return 2;
+    }
+
+    fp = fopen(argv[i], "rb");
+    if (fp == NULL || fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) <= 0)
+    {
+        fprintf(stderr, "%s: cannot read\n", argv[i]);
+        return 2;
+    }
+
+    m_sim.stream_len = (uint32_t) len - (uint32_t) len % FRAME_FIFO_SLOT_SIZE;
+    m_sim.p_stream   = malloc(len);
+    rewind(fp);
+
+    if (fread(m_sim.p_stream, 1, len, fp) != (size_t) len)
+    {
+        fprintf(stderr, "%s: cannot read\n", argv[i]);
+        return 2;
+    }
+
+    fclose(fp);
+
+    if (m_sim.stream_len == 0)
+    {
+        fprintf(stderr, "%s: no frame\n", argv[i]);
+        return 2;
+    }
+
+    if (loss_p > 100 || loss_r > 100)
+    {
+        fprintf(stderr, "loss probabilities are percentages\n");
+        return 2;
+    }
+
+    // A fast sender produces frames in less I2S clock time
+    m_sim.pkt_period_ns = SIM_PKT_PERIOD_NS / (1.0 + m_sim.drift_ppm * 1e-6);
+
+    srand(1);
+
+    if (p_trace != NULL)
+    {
+        if (!arrivals_read(p_trace))
+        {
+            fprintf(stderr, "%s: cannot read\n", p_trace);
+            return 2;
+        }
+    }
+    else
+    {
+        arrivals_ble(frames ? frames : m_sim.stream_len / FRAME_FIFO_SLOT_SIZE, interval_ns, miss_percent);
+    }
+
+    arrivals_lose(loss_p, loss_r);
+    arrivals_prepare();
+
+    if (audio_manager_init(&params) != NRF_SUCCESS)
+    {
+        fprintf(stderr, "invalid parameters\n");
+        return 2;
+    }
+
+    m_stats.margin_min = m_decode_ahead;
+
+    if (sample)
+    {
+        m_sim.next_pkt = SIM_TIME_NEVER;
+        m_sim.end      = (uint64_t) m_sim.stream_len / FRAME_FIFO_SLOT_SIZE * SIM_PKT_PERIOD_NS + SIM_DRAIN_NS;
+        audio_manager_play_sample(m_sim.p_stream, m_sim.stream_len);
+        egu_run();
+    }
+
+    sim_run();
+
+    if (m_sim.fp_out != NULL)
+    {
+        fclose(m_sim.fp_out);
+    }
+
+    printf("decode ahead %u frames, decode %.2f ms per frame, spike %.2f ms every %u frames\n",
+           (unsigned) m_decode_ahead, m_sim.decode_ns / 1e6, m_sim.spike_ns / 1e6, (unsigned) m_sim.spike_interval);
+    printf("%u frames sent, %u I2S requests, %u played, %u concealed, %u lost on a full FIFO\n",
+           (unsigned) (sample ? m_sim.stream_len / FRAME_FIFO_SLOT_SIZE : m_sim.pkts), (unsigned) m_stats.i2s_reqs,
+           (unsigned) m_stats.played, (unsigned) m_stats.concealed, (unsigned) m_stats.fifo_full);
+    printf("%u packets lost, %u glitches\n", (unsigned) m_sim.pkts_lost, (unsigned) m_stats.glitches);
+    printf("%u I2S underruns, %u low watermarks, smallest decode-ahead margin %u frames\n",
+           (unsigned) m_stats.underruns, (unsigned) m_stats.low_watermarks, (unsigned) m_stats.margin_min);
+
+    if (!sample)
+    {
+        printf("latency %.1f ms average, %.1f ms worst, %u frames late or lost, jitter buffer target %u frames\n",
+               m_stats.latency_count ? m_stats.latency_sum / m_stats.latency_count * SIM_PKT_PERIOD_NS / 1e6 : 0.0,
+               m_stats.latency_max * (SIM_PKT_PERIOD_NS / 1e6), (unsigned) m_stats.late, (unsigned) m_jb.target);
+        printf("sender %+d ppm, second half: ASRC %+.1f ppm average (%+d to %+d), FIFO depth %u to %u frames\n",
+               (int) m_sim.drift_ppm, m_stats.ppm_count ? m_stats.ppm_sum / m_stats.ppm_count : 0.0,
+               (int) m_stats.ppm_min, (int) m_stats.ppm_max, (unsigned) m_stats.depth_min, (unsigned) m_stats.depth_max);
+        printf("ASRC ratio at the +-%d ppm clamp for %.2f%% of the second half\n", AUDIO_ASRC_PPM_MAX,
+               m_stats.ppm_count ? 100.0 * m_stats.ppm_clamped / m_stats.ppm_count : 0.0);
+    }
+
+    if (m_gap.lost != m_gap.concealed)
+    {
+        printf("%u frames lost on a full FIFO were never concealed\n", (unsigned) (m_gap.lost - m_gap.concealed));
+    }
+
+    if (m_stats.stuck)
+    {
+        printf("I2S still running %u s after the end of the stream\n", (unsigned) (SIM_DRAIN_NS / SIM_NS_PER_S));
+    }
+
+    free(m_sim.p_stream);
+    free(m_sim.p_arrival);
+
+    // Lost packets are late by nature: only a FIFO that runs dry without loss is the loop's fault
+    drift_failed = (m_sim.drift_ppm != 0 && (m_stats.fifo_full != 0 || (m_stats.late != 0 && m_sim.pkts_lost == 0)));
+
+    if (drift_failed)
+    {
+        printf("the FIFO ran %s with the sender drifting\n", (m_stats.fifo_full != 0) ? "over" : "dry");
+    }
+
+    if (m_sim.drift_ppm != 0 && abs(m_sim.drift_ppm) < AUDIO_ASRC_PPM_MAX && m_stats.ppm_clamped != 0)
+    {
+        printf("the ASRC control loop saturated with the sender drifting %+d ppm\n", (int) m_sim.drift_ppm);
+        drift_failed = true;
+    }
+
+    return (m_stats.underruns != 0 || m_stats.stuck || m_gap.lost != m_gap.concealed || drift_failed) ? 1 : 0;
+}
@@ -0,0 +1,331 @@
+/* Host harness for the capture chain (audio_capture.c).
+ *
+ * Reads 16-bit PCM WAV files, resamples them to the I2S rate as the SGTL5000 ADC would deliver
+ * them, and feeds them through the chain one I2S frame at a time, as the encode task does on the
+ * device. Prints the cycles per frame. The cycles come from the time-stamp counter on x86: they
+ * are host cycles, not Cortex-M4 cycles, so AUDIO_CAPTURE_CYCLE_BUDGET does not apply here. The
+ * frames over a host budget are counted only when one is given with -b. For the complexity on
+ * the target, a WMOPS=1 build prints the operator counts.
+ *
+ * The packed frames are decoded again with the fixed-point BV32 decoder and compared against the
+ * input resampled straight to the codec rate, to check the chain end to end. With -o the packed
+ * frames are also written out, in the format bv32_to_c.py turns into a firmware sample.
+ *
+ * usage: capture_test [-m full|balanced|fast] [-b cycles] [-o out.bv32] file.wav ...
+ *
+ * Exits with status 1 if a frame went over the budget given with -b.
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "audio_capture.h"
+
+#include "typedef.h"
+#include "bv32cnst.h"
+#include "bvcommon.h"
+#include "bv32strct.h"
+#include "bv32.h"
+#include "bitpack.h"
+#include "wmops.h"
+
+#define I2S_FS     31250.0                            /* DRV_SGTL5000_FS_31250HZ */
+#define CODEC_FS   (I2S_FS / DOWNSAMPLER_FACTOR)      /* Rate the BV32 frames are played at */
+#define MAXLAG     160                                /* Largest chain delay searched when aligning the output (codec samples) */
+#define PI         3.14159265358979
+
+uint32_t host_cycles(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return (uint32_t) __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static int16_t * wav_read(char const * p_name, uint32_t * p_len, uint32_t * p_fs)
+{
+    FILE *    fp;
+    uint8_t   hdr[8];
+    uint8_t   fmt[16];
+    uint32_t  size;
+    uint16_t  channels = 0;
+    uint16_t  bits     = 0;
+    int16_t * p_data;
+
+    fp = fopen(p_name, "rb");
+    if (fp == NULL || fread(hdr, 1, 8, fp) != 8 || memcmp(hdr, "RIFF", 4) != 0 ||
+        fread(hdr, 1, 4, fp) != 4 || memcmp(hdr, "WAVE", 4) != 0)
+    {
+        fprintf(stderr, "%s: not a WAV file\n", p_name);
+        exit(2);
+    }
+
+    // Walk the chunks up to the samples
+    while (fread(hdr, 1, 8, fp) == 8)
+    {
+        size = hdr[4] | (hdr[5] << 8) | (hdr[6] << 16) | ((uint32_t) hdr[7] << 24);
+
+        if (memcmp(hdr, "fmt ", 4) == 0 && size >= 16 && fread(fmt, 1, 16, fp) == 16)
+        {
+            channels = fmt[2] | (fmt[3] << 8);
+            *p_fs    = fmt[4] | (fmt[5] << 8) | (fmt[6] << 16) | ((uint32_t) fmt[7] << 24);
+            bits     = fmt[14] | (fmt[15] << 8);
+            fseek(fp, (size - 16 + 1) & ~1UL, SEEK_CUR);
+        }
+        else if (memcmp(hdr, "data", 4) == 0 && channels != 0)
+        {
+            if (bits != 16)
+            {
+                break;
+            }
+
+            *p_len = size / (2 * channels);
+            p_data = malloc((size_t) size + 2);
+
+            size = fread(p_data, 2, (size_t) *p_len * channels, fp) / channels;
+            fclose(fp);
+
+            // Keep the first channel (the firmware records the left one)
+            *p_len = size;
+            for (uint32_t i = 0; i < size; ++i)
+            {
+                uint8_t const * p = (uint8_t const *) &p_data[i * channels];
+
+                p_data[i] = (int16_t)(p[0] | (p[1] << 8));
+            }
+
+            return p_data;
+        }
+        else
+        {
+            fseek(fp, (size + 1) & ~1UL, SEEK_CUR);
+        }
+    }
+
+    fprintf(stderr, "%s: not 16-bit PCM\n", p_name);
+    exit(2);
+}
+
+/* Windowed-sinc resampling from fs to fo Hz */
+static int16_t * resample(int16_t const * p_in, uint32_t len, double fs, double fo, uint32_t * p_out_len)
+{
+    double    fc   = 0.95 * (fs < fo ? fs : fo) / 2 / fs; // Cut-off, cycles per input sample
+    int       half = (int)(16 * fs / (fs < fo ? fs : fo)) + 1;
+    uint32_t  n    = (uint32_t)(len * fo / fs);
+    int16_t * p_out = malloc((size_t) n * sizeof(int16_t) + 1);
+
+    for (uint32_t m = 0; m < n; ++m)
+    {
+        double t   = m * fs / fo;
+        long   n0  = (long) t;
+        double acc = 0.0;
+
+        for (long k = n0 - half + 1; k <= n0 + half; ++k)
+        {
+            if (k >= 0 && k < (long) len)
+            {
+                double u = t - k;
+                double h = (u == 0.0) ? 2 * fc : sin(2 * PI * fc * u) / (PI * u);
+
+                acc += p_in[k] * h * (0.5 + 0.5 * cos(PI * u / half));
+            }
+        }
+
+        acc      = floor(acc + 0.5);
+        p_out[m] = (int16_t)(acc > 32767.0 ? 32767.0 : (acc < -32768.0 ? -32768.0 : acc));
+    }
+
+    *p_out_len = n;
+    return p_out;
+}
+
+#if !WMOPS
+/* SNR (dB) of y against x, with y delayed by the lag that correlates best */
+static double snr_get(int16_t const * p_x, int16_t const * p_y, uint32_t len, int * p_lag)
+{
+    double best = -1e300;
+    double s    = 0.0;
+    double e    = 0.0;
+
+    if (len <= MAXLAG)
+    {
+        return 0.0;
+    }
+
+    len -= MAXLAG;
+
+    for (int d = 0; d < MAXLAG; ++d)
+    {
+        double c = 0.0;
+
+        for (uint32_t i = 0; i < len; ++i)
+        {
+            c += (double) p_x[i] * p_y[i + d];
+        }
+
+        if (c > best)
+        {
+            best   = c;
+            *p_lag = d;
+        }
+    }
+
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        double d = (double) p_x[i] - p_y[i + *p_lag];
+
+        s += (double) p_x[i] * p_x[i];
+        e += d * d;
+    }
+
+    return 10.0 * log10(s / (e > 1.0 ? e : 1.0));
+}
+#endif
+
+int main(int argc, char ** argv)
+{
+    static audio_capture_t capture;
+    FILE *                 fp_out   = NULL;
+    int16_t                mode     = BV32_MODE_FULL;
+    uint32_t               budget   = UINT32_MAX; /* No host budget unless given */
+    uint32_t               over_all = 0;
+    int                    i;
+
+    for (i = 1; i < argc - 1 && argv[i][0] == '-'; i += 2)
+    {
+        if (strcmp(argv[i], "-m") == 0)
+        {
+            if (strcmp(argv[i + 1], "full") == 0)
+            {
+                mode = BV32_MODE_FULL;
+            }
+            else if (strcmp(argv[i + 1], "balanced") == 0)
+            {
+                mode = BV32_MODE_BALANCED;
+            }
+            else if (strcmp(argv[i + 1], "fast") == 0)
+            {
+                mode = BV32_MODE_FAST;
+            }
+            else
+            {
+                break;
+            }
+        }
+        else if (strcmp(argv[i], "-b") == 0)
+        {
+            budget = (uint32_t) strtoul(argv[i + 1], NULL, 0);
+        }
+        else if (strcmp(argv[i], "-o") == 0)
+        {
+            fp_out = fopen(argv[i + 1], "wb");
+            if (fp_out == NULL)
+            {
+                fprintf(stderr, "%s: cannot create\n", argv[i + 1]);
+                return 2;
+            }
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (i >= argc)
+    {
+        fprintf(stderr, "usage: %s [-m full|balanced|fast] [-b cycles] [-o out.bv32] file.wav ...\n", argv[0]);
+        return 2;
+    }
+
+    audio_capture_init(&capture, mode, budget);
+
+    printf("%-24s %7s %11s %11s %6s %8s\n", "file", "frames", "host cyc/fr", "host worst", "over", "SNR");
+
+    for (; i < argc; ++i)
+    {
+        struct BV32_Decoder_State ds;
+#if !WMOPS
+        struct BV32_Bit_Stream    bs;
+        int                       lag    = 0;
+#endif
+        int16_t *                 p_wav;
+        int16_t *                 p_adc;
+        int16_t *                 p_ref;
+        int16_t *                 p_dec;
+        uint8_t                   packed[AUDIO_CAPTURE_PACKED_LEN];
+        uint32_t                  wav_len, wav_fs, adc_len, ref_len;
+        uint32_t                  frames;
+        double                    cycles = 0.0;
+        double                    snr    = 0.0;
+        char const *              p_base;
+
+        p_wav = wav_read(argv[i], &wav_len, &wav_fs);
+        p_adc = resample(p_wav, wav_len, wav_fs, I2S_FS, &adc_len);
+        p_ref = resample(p_wav, wav_len, wav_fs, CODEC_FS, &ref_len);
+
+        frames = adc_len / AUDIO_CAPTURE_IN_LEN;
+        p_dec  = malloc((size_t) frames * FRSZ * sizeof(int16_t) + 1);
+
+        // One stream per file, as per connection on the device
+        audio_capture_reset(&capture);
+        Reset_BV32_Decoder(&ds);
+
+        for (uint32_t f = 0; f < frames; ++f)
+        {
+            audio_capture_process(&capture, &p_adc[f * AUDIO_CAPTURE_IN_LEN], packed);
+            cycles += capture.cycles_last;
+
+            if (fp_out != NULL)
+            {
+                fwrite(packed, 1, sizeof(packed), fp_out);
+            }
+
+#if !WMOPS
+            // Back through the receiving side's decoder (a WMOPS=1 build counts the encoder only)
+            bv32fx_BitUnPack(packed, &bs);
+            BV32_Decode(&bs, &ds, &p_dec[f * FRSZ]);
+#endif
+        }
+
+#if !WMOPS
+        if (ref_len > frames * FRSZ)
+        {
+            ref_len = frames * FRSZ;
+        }
+        snr = snr_get(p_ref, p_dec, ref_len, &lag);
+#endif
+
+        p_base = strrchr(argv[i], '/');
+        p_base = (p_base != NULL) ? p_base + 1 : argv[i];
+
+        printf("%-24s %7u %11.0f %11u %6u %8.2f\n", p_base, (unsigned) frames,
+               frames ? cycles / frames : 0.0, (unsigned) capture.cycles_max, (unsigned) capture.frames_over, snr);
+
+        over_all += capture.frames_over;
+
+        free(p_wav);
+        free(p_adc);
+        free(p_ref);
+        free(p_dec);
+    }
+
+    if (fp_out != NULL)
+    {
+        fclose(fp_out);
+    }
+
+#if WMOPS
+    wmops_report(stdout, I2S_FS / AUDIO_CAPTURE_IN_LEN);
+#endif
+
+    if (budget != UINT32_MAX)
+    {
+        printf("%u frames over the budget of %u host cycles\n", (unsigned) over_all, (unsigned) budget);
+    }
+
+    return (over_all != 0) ? 1 : 0;
+}
@@ -1,6 +1,9 @@
 #ifndef __fifo_h__
 #define __fifo_h__
 
+/* Byte FIFO the firmware used before frame_fifo.h, kept unchanged for the host benchmark.
+ * The firmware wrapped each put and get in a critical region. */
+
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
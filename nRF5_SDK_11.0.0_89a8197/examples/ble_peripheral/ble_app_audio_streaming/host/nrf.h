@@ -0,0 +1,45 @@
+#ifndef __NRF_H__
+#define __NRF_H__
+
+#include <stdint.h>
+
+/* Host stand-in for the device header, with just what the modules built by the host harness use */
+
+#ifndef __INLINE
+#define __INLINE inline
+#endif
+
+#define __DMB() __sync_synchronize()
+
+// EGU registers are plain memory: the simulation moves TASKS_TRIGGER to EVENTS_TRIGGERED and
+// calls the handler when the matching INTENSET bit was written
+typedef struct
+{
+    volatile uint32_t TASKS_TRIGGER[16];
+    volatile uint32_t EVENTS_TRIGGERED[16];
+    volatile uint32_t INTENSET;
+    volatile uint32_t INTENCLR;
+} NRF_EGU_Type;
+
+extern NRF_EGU_Type host_egu[6];
+
+#define NRF_EGU1 (&host_egu[1])
+#define NRF_EGU3 (&host_egu[3])
+
+typedef enum
+{
+    SWI1_EGU1_IRQn = 21,
+    SWI3_EGU3_IRQn = 23,
+} IRQn_Type;
+
+#define NVIC_ClearPendingIRQ(irqn)
+#define NVIC_SetPriority(irqn, priority)
+#define NVIC_EnableIRQ(irqn)
+
+// The capture chain is timed with the time-stamp counter instead of the DWT cycle counter
+uint32_t host_cycles(void);
+
+#define AUDIO_CAPTURE_CYCLES_ENABLE()
+#define AUDIO_CAPTURE_CYCLES()        host_cycles()
+
+#endif /* __NRF_H__ */
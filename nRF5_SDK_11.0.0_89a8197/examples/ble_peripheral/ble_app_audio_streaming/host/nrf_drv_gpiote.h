@@ -0,0 +1,6 @@
+#ifndef __NRF_DRV_GPIOTE_H__
+#define __NRF_DRV_GPIOTE_H__
+
+/* Host stand-in: drv_sgtl5000.h includes it, the simulation replaces the driver */
+
+#endif /* __NRF_DRV_GPIOTE_H__ */
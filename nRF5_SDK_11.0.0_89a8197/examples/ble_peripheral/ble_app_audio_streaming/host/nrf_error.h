@@ -0,0 +1,11 @@
+#ifndef __NRF_ERROR_H__
+#define __NRF_ERROR_H__
+
+/* Host stand-in, same values as the SDK */
+
+#define NRF_SUCCESS               0
+#define NRF_ERROR_NO_MEM          4
+#define NRF_ERROR_INVALID_PARAM   7
+#define NRF_ERROR_INVALID_STATE   8
+
+#endif /* __NRF_ERROR_H__ */
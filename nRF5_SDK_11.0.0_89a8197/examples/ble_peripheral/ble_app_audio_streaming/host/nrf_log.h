@@ -0,0 +1,8 @@
+#ifndef __NRF_LOG_H__
+#define __NRF_LOG_H__
+
+/* Host stand-in */
+
+#define NRF_LOG_PRINTF(...)
+
+#endif /* __NRF_LOG_H__ */
@@ -0,0 +1,277 @@
+/* Host test and benchmark of the polyphase interpolator (upsampler.c).
+ *
+ * Checks the coefficients upsampler_init() computes:
+ *  - DC gain: each phase sums to exactly 1.0 in Q15, so that DC passes without error.
+ *  - Passband: the response of the prototype filter, at the output rate, stays within -r dB of
+ *    unity up to -p Hz (2250 Hz by default).
+ *  - Stopband: the images of tones up to -p Hz, from the input rate minus -p Hz up to the output
+ *    Nyquist frequency, are at least -s dB down.
+ * Then checks that upsampler_process() applies them: its output, over calls of one BV32 frame,
+ * must match a direct convolution of the input with the prototype, and a constant input must come
+ * out unchanged.
+ *
+ * Prints the cycles per call of one BV32 frame. The cycles come from the time-stamp counter on
+ * x86: they are host cycles, not Cortex-M4 cycles. The multiply-accumulates per frame are printed
+ * with them; the Cortex-M4 build does two per __SMLAD.
+ *
+ * usage: upsampler_test [-p Hz] [-r dB] [-s dB]
+ *
+ * Exits with status 1 if a check failed.
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "upsampler.h"
+
+#define OUT_FS       31250.0                               /* DRV_SGTL5000_FS_31250HZ */
+#define IN_FS        (OUT_FS / UPSAMPLER_FACTOR)           /* Rate the BV32 frames are played at */
+#define TAPS         (UPSAMPLER_FACTOR * UPSAMPLER_TAPS_PER_PHASE)
+#define FREQ_POINTS  4096                                  /* Response evaluated from 0 to the output Nyquist frequency */
+#define FRAME_LEN    UPSAMPLER_MAX_IN_LEN
+#define TEST_FRAMES  50
+#define BENCH_CALLS  100000
+#define PI           3.14159265358979
+
+uint32_t host_cycles(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    return (uint32_t) __builtin_ia32_rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static upsampler_t m_upsampler;
+
+/* Prototype filter taken back from the time-reversed phases, DC gain UPSAMPLER_FACTOR */
+static void prototype_get(double * p_h)
+{
+    for (int p = 0; p < UPSAMPLER_FACTOR; ++p)
+    {
+        for (int k = 0; k < UPSAMPLER_TAPS_PER_PHASE; ++k)
+        {
+            p_h[p + k * UPSAMPLER_FACTOR] = m_upsampler.coeff[p][UPSAMPLER_TAPS_PER_PHASE - 1 - k] / 32768.0;
+        }
+    }
+}
+
+/* Gain in dB at f Hz, at the output rate, relative to the interpolation gain */
+static double response_db(double const * p_h, double f)
+{
+    double re = 0.0;
+    double im = 0.0;
+
+    for (int i = 0; i < TAPS; ++i)
+    {
+        re += p_h[i] * cos(2.0 * PI * f / OUT_FS * i);
+        im -= p_h[i] * sin(2.0 * PI * f / OUT_FS * i);
+    }
+
+    return 20.0 * log10(sqrt(re * re + im * im) / UPSAMPLER_FACTOR + 1e-12);
+}
+
+static bool dc_gain_check(void)
+{
+    bool pass = true;
+
+    for (int p = 0; p < UPSAMPLER_FACTOR; ++p)
+    {
+        int32_t sum = 0;
+
+        for (int j = 0; j < UPSAMPLER_TAPS_PER_PHASE; ++j)
+        {
+            sum += m_upsampler.coeff[p][j];
+        }
+
+        if (sum != 32768)
+        {
+            printf("phase %d: DC gain %d / 32768\n", p, (int) sum);
+            pass = false;
+        }
+    }
+
+    return pass;
+}
+
+/* Frames of a two-tone signal near full scale, through upsampler_process() and through the prototype */
+static bool process_check(double const * p_h)
+{
+    static int16_t in[TEST_FRAMES * FRAME_LEN];
+    static int16_t out[TEST_FRAMES * FRAME_LEN * UPSAMPLER_FACTOR];
+    int32_t        err_max = 0;
+    bool           pass    = true;
+
+    for (int n = 0; n < TEST_FRAMES * FRAME_LEN; ++n)
+    {
+        in[n] = (int16_t)(16000.0 * sin(2.0 * PI * 1000.0 / IN_FS * n) + 12000.0 * sin(2.0 * PI * 3100.0 / IN_FS * n));
+    }
+
+    upsampler_reset(&m_upsampler);
+
+    for (int f = 0; f < TEST_FRAMES; ++f)
+    {
+        upsampler_process(&m_upsampler, &in[f * FRAME_LEN], FRAME_LEN, &out[f * FRAME_LEN * UPSAMPLER_FACTOR]);
+    }
+
+    // Output sample m = n * UPSAMPLER_FACTOR + p takes phase p over the inputs up to n
+    for (int m = 0; m < TEST_FRAMES * FRAME_LEN * UPSAMPLER_FACTOR; ++m)
+    {
+        int    n   = m / UPSAMPLER_FACTOR;
+        int    p   = m % UPSAMPLER_FACTOR;
+        double acc = 0.0;
+        int32_t expected;
+        int32_t err;
+
+        for (int k = 0; k < UPSAMPLER_TAPS_PER_PHASE && k <= n; ++k)
+        {
+            acc += p_h[p + k * UPSAMPLER_FACTOR] * in[n - k];
+        }
+
+        expected = (int32_t) floor(acc + 0.5);
+        expected = (expected > INT16_MAX) ? INT16_MAX : (expected < INT16_MIN) ? INT16_MIN : expected;
+        err      = abs(out[m] - expected);
+
+        if (err > err_max)
+        {
+            err_max = err;
+        }
+    }
+
+    // Only the rounding of the Q15 sum differs
+    if (err_max > 1)
+    {
+        printf("upsampler_process: off by up to %d from the prototype convolution\n", (int) err_max);
+        pass = false;
+    }
+
+    for (int n = 0; n < FRAME_LEN; ++n)
+    {
+        in[n] = -32768;
+    }
+
+    for (int f = 0; f < 2; ++f)
+    {
+        upsampler_process(&m_upsampler, in, FRAME_LEN, out);
+    }
+
+    for (int m = 0; m < FRAME_LEN * UPSAMPLER_FACTOR; ++m)
+    {
+        if (out[m] != -32768)
+        {
+            printf("upsampler_process: full-scale DC comes out as %d\n", (int) out[m]);
+            pass = false;
+            break;
+        }
+    }
+
+    return pass;
+}
+
+int main(int argc, char ** argv)
+{
+    double   h[TAPS];
+    double   passband_hz  = 2250.0;
+    double   ripple_db    = 0.1;
+    double   stopband_db  = 70.0;
+    double   pass_min     = 1000.0;
+    double   pass_max     = -1000.0;
+    double   stop_max     = -1000.0;
+    double   stop_max_hz  = 0.0;
+    bool     pass;
+    int16_t  in[FRAME_LEN];
+    int16_t  out[FRAME_LEN * UPSAMPLER_FACTOR];
+    uint64_t cycles = 0;
+    uint32_t cycles_min = UINT32_MAX;
+    int      i;
+
+    for (i = 1; i < argc - 1 && argv[i][0] == '-'; i += 2)
+    {
+        if (strcmp(argv[i], "-p") == 0)
+        {
+            passband_hz = strtod(argv[i + 1], NULL);
+        }
+        else if (strcmp(argv[i], "-r") == 0)
+        {
+            ripple_db = strtod(argv[i + 1], NULL);
+        }
+        else if (strcmp(argv[i], "-s") == 0)
+        {
+            stopband_db = strtod(argv[i + 1], NULL);
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    if (i != argc || passband_hz <= 0.0 || passband_hz >= IN_FS / 2)
+    {
+        fprintf(stderr, "usage: %s [-p Hz] [-r dB] [-s dB]\n", argv[0]);
+        return 2;
+    }
+
+    upsampler_init(&m_upsampler);
+    prototype_get(h);
+
+    pass = dc_gain_check();
+
+    for (int k = 0; k <= FREQ_POINTS; ++k)
+    {
+        double f  = k * (OUT_FS / 2) / FREQ_POINTS;
+        double db = response_db(h, f);
+
+        if (f <= passband_hz)
+        {
+            pass_min = (db < pass_min) ? db : pass_min;
+            pass_max = (db > pass_max) ? db : pass_max;
+        }
+        else if (f >= IN_FS - passband_hz && db > stop_max)
+        {
+            stop_max    = db;
+            stop_max_hz = f;
+        }
+    }
+
+    printf("%d x %d taps, DC gain %s\n", UPSAMPLER_FACTOR, UPSAMPLER_TAPS_PER_PHASE, pass ? "exact" : "wrong");
+    printf("passband 0-%.0f Hz: %+.3f to %+.3f dB (limit %.2f dB)\n", passband_hz, pass_min, pass_max, ripple_db);
+    printf("stopband %.0f-%.0f Hz: %.1f dB down at worst, at %.0f Hz (limit %.1f dB)\n",
+           IN_FS - passband_hz, OUT_FS / 2, -stop_max, stop_max_hz, stopband_db);
+
+    pass = pass && (pass_min >= -ripple_db) && (pass_max <= ripple_db) && (-stop_max >= stopband_db);
+    pass = process_check(h) && pass;
+
+    // Benchmark
+    for (int n = 0; n < FRAME_LEN; ++n)
+    {
+        in[n] = (int16_t)(rand() - RAND_MAX / 2);
+    }
+
+    for (int c = 0; c < BENCH_CALLS; ++c)
+    {
+        uint32_t start = host_cycles();
+        uint32_t spent;
+
+        upsampler_process(&m_upsampler, in, FRAME_LEN, out);
+        spent   = host_cycles() - start;
+        cycles += spent;
+
+        if (spent < cycles_min)
+        {
+            cycles_min = spent;
+        }
+
+        in[c % FRAME_LEN] ^= out[c % (FRAME_LEN * UPSAMPLER_FACTOR)];
+    }
+
+    printf("upsampler_process, %d samples in: %.0f host cycles average, %u best, %d multiply-accumulates\n",
+           FRAME_LEN, (double) cycles / BENCH_CALLS, (unsigned) cycles_min, FRAME_LEN * UPSAMPLER_FACTOR * UPSAMPLER_TAPS_PER_PHASE);
+
+    printf("%s\n", pass ? "pass" : "FAIL");
+
+    return pass ? 0 : 1;
+}
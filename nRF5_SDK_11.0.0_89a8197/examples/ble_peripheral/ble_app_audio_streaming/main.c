@@ -39,7 +39,6 @@
 #include "bsp.h"
 #include "bsp_btn_ble.h"
 
-#include "fifo.h"
 #include "audio_manager.h"
 
 #define IS_SRVC_CHANGED_CHARACT_PRESENT 0                                           /**< Include the service_changed characteristic. If not enabled, the server's database cannot be changed for the lifetime of the device. */
@@ -73,12 +72,11 @@
 #define PLAY_SAMPLE_ON_RESET 1
 #define PLAY_SAMPLE_ON_CONNECT 1
 #define PLAY_SAMPLE_ON_DISCONNECT 1
+#define CAPTURE_ON_CONNECT 1 /* Encode the SGTL5000 ADC input and notify it to the peer while connected */
 
 #define USE_RECEIPT_TIMER   1
 #define RECEIPT_TIMER_TICKS APP_TIMER_TICKS(100, APP_TIMER_PRESCALER)
 
-#define NUM_FRAMES_TO_BUFFER 50 /* 0.5 seconds */
-
 APP_TIMER_DEF(m_receipt_timer_id_t);
 
 static ble_nus_t                        m_nus;                                      /**< Structure to identify the Nordic UART Service. */
@@ -208,6 +206,11 @@ static void gap_params_init(void)
 static void nus_data_handler(ble_nus_t * p_nus, uint8_t * p_data, uint16_t length)
 {
     uint32_t err_code;
+    uint32_t rx_time;
+    
+    // Arrival time for the jitter buffer
+    err_code = app_timer_cnt_get(&rx_time);
+    APP_ERROR_CHECK(err_code);
     
     if (length != 20)
     {
@@ -215,7 +218,7 @@ static void nus_data_handler(ble_nus_t * p_nus, uint8_t * p_data, uint16_t lengt
 #if USE_RECEIPT_TIMER == 1
         app_timer_stop(m_receipt_timer_id_t);
 #endif
-        NRF_LOG_PRINTF("Stop\r\n");
+        NRF_LOG_PRINTF("Stop (jitter buffer target %d frames)\r\n", audio_manager_jb_target_get());
         
         m_receipt_counter = 0;
         
@@ -229,7 +232,7 @@ static void nus_data_handler(ble_nus_t * p_nus, uint8_t * p_data, uint16_t lengt
     if (!audio_manager_is_running())
     {
         NRF_LOG_PRINTF("Start\r\n");
-        err_code = audio_manager_streaming_begin_buffered(NUM_FRAMES_TO_BUFFER);
+        err_code = audio_manager_streaming_begin_adaptive();
         APP_ERROR_CHECK(err_code);
 #if USE_RECEIPT_TIMER == 1        
         err_code = app_timer_start(m_receipt_timer_id_t, RECEIPT_TIMER_TICKS, 0);
@@ -237,7 +240,7 @@ static void nus_data_handler(ble_nus_t * p_nus, uint8_t * p_data, uint16_t lengt
 #endif
     }
 
-    err_code = audio_manager_pkt_process(p_data, length);
+    err_code = audio_manager_pkt_process(p_data, length, rx_time);
     if (err_code == NRF_ERROR_NO_MEM)
     {
         NRF_LOG_PRINTF("Out of memory\r\n");
@@ -366,6 +369,34 @@ static void on_adv_evt(ble_adv_evt_t ble_adv_evt)
     }
 }
 
+#if CAPTURE_ON_CONNECT == 1
+/**@brief Function for notifying the encoded captured frames to the peer, as long as there are TX buffers.
+ *
+ * @details Called from the audio event handler and the SoftDevice event handler, which both run at
+ *          APP_IRQ_PRIORITY_LOWEST, so that frames are only ever taken from one context at a time.
+ */
+static void capture_frames_send(void)
+{
+    uint8_t * p_frame;
+    uint32_t  err_code;
+    
+    while ((p_frame = audio_manager_capture_frame_peek()) != 0)
+    {
+        // BV32 frames are always 20 bytes, the peer tells them from the receipt counts by length
+        err_code = ble_nus_string_send(&m_nus, p_frame, 20);
+        
+        if (err_code == BLE_ERROR_NO_TX_PACKETS)
+        {
+            // Sent again on BLE_EVT_TX_COMPLETE
+            break;
+        }
+        
+        // Sent, or nobody to send it to (not connected, or notifications disabled): done with the frame
+        audio_manager_capture_frame_commit();
+    }
+}
+#endif
+
 static void print_conn_params(ble_gap_conn_params_t * p_conn_params)
 {
     char str[100];
@@ -392,6 +423,14 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
             
             print_conn_params(&p_ble_evt->evt.gap_evt.params.connected.conn_params);
             
+#if CAPTURE_ON_CONNECT == 1
+            err_code = audio_manager_capture_begin();
+            if (err_code != NRF_SUCCESS)
+            {
+                NRF_LOG_PRINTF("Capture not started (0x%x)\r\n", err_code);
+            }
+#endif
+            
 #if PLAY_SAMPLE_ON_CONNECT == 1
             if (p_ble_evt->evt.gap_evt.params.connected.conn_params.min_conn_interval == 6)
             {
@@ -410,6 +449,9 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
             APP_ERROR_CHECK(err_code);
         
             audio_manager_streaming_end(false);
+#if CAPTURE_ON_CONNECT == 1
+            audio_manager_capture_end();
+#endif
 #if USE_RECEIPT_TIMER == 1
             app_timer_stop(m_receipt_timer_id_t);
 #endif 
@@ -449,6 +491,13 @@ static void on_ble_evt(ble_evt_t * p_ble_evt)
             }
 #endif
             break;
+        
+#if CAPTURE_ON_CONNECT == 1
+        case BLE_EVT_TX_COMPLETE:
+            // TX buffers were freed: send the captured frames that did not fit before
+            capture_frames_send();
+            break;
+#endif
 
         default:
             // No implementation needed.
@@ -646,9 +695,38 @@ static void receipt_timer_handler(void * p_context)
     m_receipt_counter = 0;
 }
 
+static void audio_evt_handler(audio_evt_t const * p_evt)
+{
+    switch (p_evt->evt)
+    {
+        case AUDIO_EVT_PCM_UNDERRUN:
+            NRF_LOG_PRINTF("Underrun\r\n");
+            break;
+        
+#if CAPTURE_ON_CONNECT == 1
+        case AUDIO_EVT_CAPTURE_FRAME_READY:
+            capture_frames_send();
+            break;
+        
+        case AUDIO_EVT_CAPTURE_OVERRUN:
+            NRF_LOG_PRINTF("Capture overrun\r\n");
+            break;
+        
+        case AUDIO_EVT_CAPTURE_OVER_BUDGET:
+            NRF_LOG_PRINTF("Encoder over budget (%d cycles)\r\n", audio_manager_capture_cycles_max_get());
+            break;
+#endif
+        
+        default:
+            break;
+    }
+}
+
 static void audio_init(void)
 {
-    audio_init_t audio_params = {.codec = AUDIO_CODEC_BV32};
+    audio_init_t audio_params = {.codec        = AUDIO_CODEC_BV32,
+                                 .evt_handler  = audio_evt_handler,
+                                 .capture_mode = AUDIO_CAPTURE_MODE_BALANCED};
     uint32_t     err_code;
     
     err_code = audio_manager_init(&audio_params);
@@ -0,0 +1,96 @@
+"""Encoder complexity modes on the sample WAVs.
+
+Resamples each sample to 16 kHz, then runs it through the BV32 encoder in
+each mode and back through the decoder. Prints the encoder cycles per
+frame and the SNR and segmental SNR of the decoded speech.
+
+usage: python3 bv32_modes.py path/to/BroadVoice32 [file.wav ...]
+"""
+
+import math, os, re, struct, subprocess, sys, tempfile, wave
+
+MODES = ("full", "balanced", "fast")
+FS = 16000
+SEG = 320           # 20 ms segments for the segmental SNR
+MAXLAG = 160        # codec delay searched when aligning the output
+REPEAT = 3          # encoder runs per file and mode, the fastest is kept
+
+def read_wav(name):
+    w = wave.open(name, "rb")
+    if w.getsampwidth() != 2:
+        raise ValueError(name + ": not 16-bit PCM")
+    n, ch, fs = w.getnframes(), w.getnchannels(), w.getframerate()
+    x = struct.unpack("<%dh" % (n * ch), w.readframes(n))
+    return list(x[::ch]), fs
+
+def resample(x, fs, fo, zc=16):
+    """Windowed-sinc resampling from fs to fo Hz."""
+    if fs == fo:
+        return x
+    fc = 0.95 * min(fs, fo) / 2 / fs        # cutoff, cycles per input sample
+    half = int(zc * fs / min(fs, fo)) + 1
+    y = []
+    for m in range(int(len(x) * fo / fs)):
+        t = m * fs / fo
+        n0 = int(t)
+        acc = 0.0
+        for n in range(n0 - half + 1, n0 + half + 1):
+            if 0 <= n < len(x):
+                u = t - n
+                h = 2 * fc if u == 0 else math.sin(2 * math.pi * fc * u) / (math.pi * u)
+                acc += x[n] * h * (0.5 + 0.5 * math.cos(math.pi * u / half))
+        y.append(max(-32768, min(32767, int(round(acc)))))
+    return y
+
+def snr(x, y):
+    """SNR and segmental SNR of y against x, y aligned for the codec delay."""
+    n = min(len(x), len(y)) - MAXLAG
+    best = max(range(MAXLAG), key=lambda d: sum(x[i] * y[i + d] for i in range(0, n, 4)))
+    y = y[best:best + n]
+    x = x[:n]
+    s = sum(v * v for v in x)
+    e = sum((a - b) ** 2 for a, b in zip(x, y))
+    seg = []
+    for i in range(0, n - SEG + 1, SEG):
+        ss = sum(v * v for v in x[i:i + SEG])
+        if ss < SEG * 100.0:        # skip silence (below -50 dB re full scale)
+            continue
+        ee = sum((a - b) ** 2 for a, b in zip(x[i:i + SEG], y[i:i + SEG]))
+        seg.append(min(35.0, max(-10.0, 10 * math.log10(ss / max(ee, 1.0)))))
+    return 10 * math.log10(s / max(e, 1.0)), sum(seg) / max(len(seg), 1), best
+
+def run(args):
+    r = subprocess.run(args, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, check=True)
+    m = re.search(rb"([0-9.]+) cycles per frame", r.stderr)
+    return float(m.group(1)) if m else float("nan")
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__)
+        sys.exit(1)
+    codec = os.path.abspath(sys.argv[1])
+    here = os.path.dirname(os.path.abspath(__file__))
+    files = sys.argv[2:] or sorted(os.path.join(here, f) for f in os.listdir(here)
+                                   if f.endswith(".wav") and "downsample" not in f)
+    tmp = tempfile.mkdtemp()
+    raw, bit, out = (os.path.join(tmp, f) for f in ("in.raw", "out.bv32", "out.raw"))
+    total = {m: [0.0, 0.0, 0.0] for m in MODES}
+    print("%-24s %-9s %12s %8s %8s" % ("file", "mode", "cycles/frm", "SNR", "segSNR"))
+    for f in files:
+        x, fs = read_wav(f)
+        x = resample(x, fs, FS)
+        open(raw, "wb").write(struct.pack("<%dh" % len(x), *x))
+        for m in MODES:
+            cyc = min(run([codec, "-m", m, "enc", raw, bit]) for _ in range(REPEAT))
+            run([codec, "dec", bit, out])
+            d = open(out, "rb").read()
+            y = struct.unpack("<%dh" % (len(d) // 2), d)
+            s, ss, _ = snr(x, y)
+            for i, v in enumerate((cyc, s, ss)):
+                total[m][i] += v / len(files)
+            print("%-24s %-9s %12.0f %8.2f %8.2f" % (os.path.basename(f), m, cyc, s, ss))
+    for m in MODES:
+        print("%-24s %-9s %12.0f %8.2f %8.2f" % ("average", m, *total[m]))
+
+if __name__ == "__main__":
+    main()
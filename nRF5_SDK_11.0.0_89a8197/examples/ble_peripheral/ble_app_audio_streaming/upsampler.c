@@ -0,0 +1,132 @@
+#include "upsampler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include "nrf.h"
+
+#define UPSAMPLER_TAPS (UPSAMPLER_FACTOR * UPSAMPLER_TAPS_PER_PHASE)
+#define UPSAMPLER_PI   3.14159265358979f
+
+#if defined(__CORTEX_M) && (__CORTEX_M == 0x04)
+#define UPSAMPLER_USE_SIMD 1 /* SMLAD: two 16 x 16 multiply-accumulates per instruction */
+#else
+#define UPSAMPLER_USE_SIMD 0
+#endif
+
+#if UPSAMPLER_USE_SIMD
+static __INLINE uint32_t q15x2_read(int16_t const * p_data)
+{
+    uint32_t pair;
+
+    // Cortex-M4 handles the unaligned word load
+    memcpy(&pair, p_data, sizeof(pair));
+
+    return pair;
+}
+#endif
+
+static __INLINE int16_t q15_sat(int32_t value)
+{
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    else if (value < INT16_MIN)
+    {
+        return INT16_MIN;
+    }
+
+    return (int16_t) value;
+}
+
+void upsampler_init(upsampler_t * p_upsampler)
+{
+    float h[UPSAMPLER_TAPS];
+    float center = (UPSAMPLER_TAPS - 1) * 0.5f;
+
+    // Low-pass prototype: windowed sinc with cut-off at the input Nyquist frequency
+    for (int i = 0; i < UPSAMPLER_TAPS; ++i)
+    {
+        float t = ((float) i - center) / UPSAMPLER_FACTOR;
+        float w = 0.42f - 0.5f  * cosf(2.f * UPSAMPLER_PI * (i + 0.5f) / UPSAMPLER_TAPS)
+                        + 0.08f * cosf(4.f * UPSAMPLER_PI * (i + 0.5f) / UPSAMPLER_TAPS);
+
+        h[i] = (t == 0.f) ? w : w * sinf(UPSAMPLER_PI * t) / (UPSAMPLER_PI * t);
+    }
+
+    // Split into phases, each scaled to unity DC gain and stored time-reversed (newest sample last)
+    for (int p = 0; p < UPSAMPLER_FACTOR; ++p)
+    {
+        float   sum = 0.f;
+        int32_t q15_sum = 0;
+        int     j_max = 0;
+
+        for (int k = 0; k < UPSAMPLER_TAPS_PER_PHASE; ++k)
+        {
+            sum += h[p + k * UPSAMPLER_FACTOR];
+        }
+
+        for (int j = 0; j < UPSAMPLER_TAPS_PER_PHASE; ++j)
+        {
+            float c = h[p + (UPSAMPLER_TAPS_PER_PHASE - 1 - j) * UPSAMPLER_FACTOR] * (32768.f / sum);
+
+            p_upsampler->coeff[p][j] = q15_sat((int32_t) floorf(c + 0.5f));
+            q15_sum                 += p_upsampler->coeff[p][j];
+
+            if (p_upsampler->coeff[p][j] > p_upsampler->coeff[p][j_max])
+            {
+                j_max = j;
+            }
+        }
+
+        // Put the rounding residue on the largest tap, so that DC passes exactly
+        p_upsampler->coeff[p][j_max] = q15_sat(p_upsampler->coeff[p][j_max] + (32768 - q15_sum));
+    }
+
+    upsampler_reset(p_upsampler);
+}
+
+void upsampler_reset(upsampler_t * p_upsampler)
+{
+    memset(p_upsampler->buf, 0, sizeof(p_upsampler->buf));
+}
+
+void upsampler_process(upsampler_t * p_upsampler, int16_t const * p_in, uint32_t in_len, int16_t * p_out)
+{
+    if (in_len > UPSAMPLER_MAX_IN_LEN)
+    {
+        in_len = UPSAMPLER_MAX_IN_LEN;
+    }
+
+    memcpy(&p_upsampler->buf[UPSAMPLER_TAPS_PER_PHASE - 1], p_in, in_len * sizeof(int16_t));
+
+    for (uint32_t n = 0; n < in_len; ++n)
+    {
+        int16_t const * p_x = &p_upsampler->buf[n];
+
+        for (int p = 0; p < UPSAMPLER_FACTOR; ++p)
+        {
+            int16_t const * p_h = p_upsampler->coeff[p];
+            int32_t         acc = 1 << 14; // Rounding
+
+#if UPSAMPLER_USE_SIMD
+            for (int j = 0; j < UPSAMPLER_TAPS_PER_PHASE; j += 2)
+            {
+                acc = (int32_t) __SMLAD(q15x2_read(&p_x[j]), q15x2_read(&p_h[j]), (uint32_t) acc);
+            }
+#else
+            for (int j = 0; j < UPSAMPLER_TAPS_PER_PHASE; ++j)
+            {
+                acc += (int32_t) p_x[j] * p_h[j];
+            }
+#endif
+
+            // Write straight into the output frame
+            *p_out++ = q15_sat(acc >> 15);
+        }
+    }
+
+    // Keep the newest samples as history for the next call
+    memmove(p_upsampler->buf, &p_upsampler->buf[in_len], (UPSAMPLER_TAPS_PER_PHASE - 1) * sizeof(int16_t));
+}
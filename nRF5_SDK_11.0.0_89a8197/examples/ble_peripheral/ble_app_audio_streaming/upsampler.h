@@ -0,0 +1,41 @@
+#ifndef __UPSAMPLER_H__
+#define __UPSAMPLER_H__
+
+#include <stdint.h>
+
+/* Fixed-point polyphase FIR interpolator.
+ *
+ * The prototype low-pass filter is UPSAMPLER_FACTOR * UPSAMPLER_TAPS_PER_PHASE taps long
+ * (Blackman-windowed sinc, cut-off at the input Nyquist frequency) and is split into
+ * UPSAMPLER_FACTOR phases of Q15 coefficients when initialized. Each output sample is one
+ * phase applied to the last UPSAMPLER_TAPS_PER_PHASE input samples, computed two taps at a
+ * time with packed 16-bit multiply-accumulate on Cortex-M4.
+ */
+
+#ifndef UPSAMPLER_FACTOR
+#define UPSAMPLER_FACTOR         4
+#endif
+
+#ifndef UPSAMPLER_TAPS_PER_PHASE
+#define UPSAMPLER_TAPS_PER_PHASE 16 /* Must be even */
+#endif
+
+#ifndef UPSAMPLER_MAX_IN_LEN
+#define UPSAMPLER_MAX_IN_LEN     80 /* Largest number of input samples per call (BV32 frame) */
+#endif
+
+#if (UPSAMPLER_TAPS_PER_PHASE & 1) != 0
+#error UPSAMPLER_TAPS_PER_PHASE must be even
+#endif
+
+typedef struct
+{
+    int16_t coeff[UPSAMPLER_FACTOR][UPSAMPLER_TAPS_PER_PHASE];               /* Time-reversed phases, Q15 */
+    int16_t buf[UPSAMPLER_TAPS_PER_PHASE - 1 + UPSAMPLER_MAX_IN_LEN + 1];    /* Input history followed by new input */
+} upsampler_t;
+
+void upsampler_init(upsampler_t * p_upsampler);
+void upsampler_reset(upsampler_t * p_upsampler);
+void upsampler_process(upsampler_t * p_upsampler, int16_t const * p_in, uint32_t in_len, int16_t * p_out);
+
+#endif /* __UPSAMPLER_H__ */